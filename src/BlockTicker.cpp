@@ -0,0 +1,152 @@
+#include "BlockTicker.h"
+#include "World.h"
+#include "Chunk.h"
+#include <algorithm> // For std::max, std::count_if
+
+static const int GRASS_DECAY_DELAY = 20;   // Ticks before grass covered by an opaque block turns to dirt
+static const int GRASS_SPREAD_MIN_LIGHT = 9; // Light needed above dirt for grass to spread onto it
+
+BlockTicker::BlockTicker(World& world)
+    : m_world(world), m_currentTick(0), m_nextOrder(0), m_random(12345) {}
+
+void BlockTicker::scheduleTick(const glm::ivec3& worldBlockPos, int delayTicks) {
+    glm::ivec3 chunkCoord = World::worldBlockToChunkCoord(worldBlockPos);
+    ChunkTickState& state = m_chunkStates[chunkCoord];
+    if (!state.scheduledPositions.insert(worldBlockPos).second) return; // Already pending
+
+    state.scheduled.push({m_currentTick + static_cast<uint64_t>(std::max(delayTicks, 1)), m_nextOrder++, worldBlockPos});
+    m_activeChunks.insert(chunkCoord);
+}
+
+size_t BlockTicker::getScheduledTickCount() const {
+    size_t count = 0;
+    for (const auto& pair : m_chunkStates) {
+        count += pair.second.scheduled.size();
+    }
+    return count;
+}
+
+void BlockTicker::onBlockChanged(const glm::ivec3& worldBlockPos, BlockType newType) {
+    glm::ivec3 chunkCoord = World::worldBlockToChunkCoord(worldBlockPos);
+    m_chunkStates[chunkCoord].countStale = true; // Recounted by the next tick of this chunk
+    m_activeChunks.insert(chunkCoord);
+
+    // Grass under a new opaque block dies after a while
+    glm::ivec3 below = worldBlockPos - glm::ivec3(0, 1, 0);
+    if (isOpaque(newType) && m_world.getBlock(below) == BlockType::Grass) {
+        scheduleTick(below, GRASS_DECAY_DELAY);
+    }
+}
+
+void BlockTicker::onChunkLoaded(const glm::ivec3& chunkCoord) {
+    m_chunkStates[chunkCoord].countStale = true;
+    m_activeChunks.insert(chunkCoord);
+}
+
+void BlockTicker::onChunkUnloaded(const glm::ivec3& chunkCoord) {
+    m_chunkStates.erase(chunkCoord);
+    m_activeChunks.erase(chunkCoord);
+}
+
+void BlockTicker::tick() {
+    ++m_currentTick;
+
+    // Block behaviours may activate other chunks while we iterate
+    m_activeScratch.assign(m_activeChunks.begin(), m_activeChunks.end());
+    for (const glm::ivec3& chunkCoord : m_activeScratch) {
+        auto stateIt = m_chunkStates.find(chunkCoord);
+        if (stateIt == m_chunkStates.end()) {
+            m_activeChunks.erase(chunkCoord);
+            continue;
+        }
+        ChunkTickState& state = stateIt->second; // Stays valid if the map rehashes
+        Chunk* chunk = m_world.getChunk(chunkCoord);
+        if (!chunk || !chunk->isGenerated()) continue; // Keep pending ticks until the chunk has blocks
+
+        if (state.countStale) {
+            const BlockType* blocks = chunk->getBlockData();
+            state.randomTickableCount = static_cast<int>(std::count_if(blocks, blocks + Chunk::CHUNK_VOLUME, hasRandomTick));
+            state.countStale = false;
+        }
+
+        runScheduledTicks(state);
+        if (state.randomTickableCount > 0) {
+            runRandomTicks(chunk);
+        }
+        updateActive(chunkCoord, state);
+    }
+}
+
+void BlockTicker::runScheduledTicks(ChunkTickState& state) {
+    while (!state.scheduled.empty() && state.scheduled.top().dueTick <= m_currentTick) {
+        glm::ivec3 worldBlockPos = state.scheduled.top().worldBlockPos;
+        state.scheduled.pop();
+        state.scheduledPositions.erase(worldBlockPos); // Before running, so the block can reschedule itself
+        scheduledTickBlock(worldBlockPos, m_world.getBlock(worldBlockPos));
+    }
+}
+
+void BlockTicker::runRandomTicks(Chunk* chunk) {
+    glm::ivec3 chunkOrigin = chunk->getWorldPosition() * glm::ivec3(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH);
+    for (int i = 0; i < RANDOM_TICKS_PER_CHUNK; ++i) {
+        int index = static_cast<int>(m_random() % Chunk::CHUNK_VOLUME);
+        BlockType type = chunk->getBlockData()[index];
+        if (!hasRandomTick(type)) continue;
+
+        glm::ivec3 local(index % Chunk::CHUNK_WIDTH,
+                         (index / Chunk::CHUNK_WIDTH) % Chunk::CHUNK_HEIGHT,
+                         index / (Chunk::CHUNK_WIDTH * Chunk::CHUNK_HEIGHT));
+        randomTickBlock(chunkOrigin + local, type);
+    }
+}
+
+void BlockTicker::updateActive(const glm::ivec3& chunkCoord, ChunkTickState& state) {
+    if (state.scheduled.empty() && state.randomTickableCount == 0 && !state.countStale) {
+        m_activeChunks.erase(chunkCoord);
+    }
+}
+
+int BlockTicker::getLightLevel(const glm::ivec3& worldBlockPos) const {
+    Chunk* chunk = m_world.getChunk(World::worldBlockToChunkCoord(worldBlockPos));
+    if (!chunk || !chunk->isLit()) return 15;
+    glm::ivec3 local = World::worldBlockToLocalCoord(worldBlockPos);
+    int index = Chunk::localIndex(local.x, local.y, local.z);
+    return std::max(chunk->getSkyLight(index), chunk->getBlockLight(index));
+}
+
+void BlockTicker::scheduledTickBlock(const glm::ivec3& worldBlockPos, BlockType type) {
+    switch (type) {
+        case BlockType::Grass:
+            if (isOpaque(m_world.getBlock(worldBlockPos + glm::ivec3(0, 1, 0)))) {
+                m_world.setBlock(worldBlockPos, BlockType::Dirt);
+            }
+            break;
+        default:
+            break; // Block changed since the tick was scheduled
+    }
+}
+
+void BlockTicker::randomTickBlock(const glm::ivec3& worldBlockPos, BlockType type) {
+    switch (type) {
+        case BlockType::Grass: {
+            if (isOpaque(m_world.getBlock(worldBlockPos + glm::ivec3(0, 1, 0)))) {
+                m_world.setBlock(worldBlockPos, BlockType::Dirt);
+                break;
+            }
+            // Spread to a random dirt block nearby (3x5x3, mostly below) that has light above it.
+            // getBlock reads air for chunks that don't exist, so this never creates chunks.
+            glm::ivec3 target = worldBlockPos + glm::ivec3(static_cast<int>(m_random() % 3) - 1,
+                                                           static_cast<int>(m_random() % 5) - 3,
+                                                           static_cast<int>(m_random() % 3) - 1);
+            glm::ivec3 aboveTarget = target + glm::ivec3(0, 1, 0);
+            if (m_world.getBlock(target) == BlockType::Dirt &&
+                !isOpaque(m_world.getBlock(aboveTarget)) &&
+                getLightLevel(aboveTarget) >= GRASS_SPREAD_MIN_LIGHT) {
+                m_world.setBlock(target, BlockType::Grass);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef BLOCKTICKER_H
+#define BLOCKTICKER_H
+
+#include "BlockType.h"
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp> // For std::hash<glm::ivec3>
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class World;
+class Chunk;
+
+// Drives dynamic blocks, once per simulation tick.
+//
+// Two kinds of updates:
+// - Scheduled ticks: "update this block in N ticks", kept per chunk in a priority queue ordered by due tick.
+// - Random ticks: a few random blocks of each chunk are picked every tick (grass spreading onto dirt).
+//
+// Only chunks in the active set are visited: chunks with pending scheduled ticks or with at least one
+// block that reacts to random ticks. A chunk of plain stone costs nothing per tick.
+class BlockTicker {
+public:
+    static const int RANDOM_TICKS_PER_CHUNK = 1; // Random blocks picked per active chunk per tick
+
+    explicit BlockTicker(World& world);
+
+    // Schedules a tick for the block at worldBlockPos in delayTicks ticks (at least 1).
+    // Ignored if that block already has a pending tick.
+    void scheduleTick(const glm::ivec3& worldBlockPos, int delayTicks);
+
+    // Runs one tick: due scheduled ticks, then random ticks, for active chunks only.
+    void tick();
+
+    // Notifications from World
+    void onBlockChanged(const glm::ivec3& worldBlockPos, BlockType newType);
+    void onChunkLoaded(const glm::ivec3& chunkCoord);   // Blocks were generated or replaced wholesale
+    void onChunkUnloaded(const glm::ivec3& chunkCoord); // Drops the chunk's pending ticks
+
+    uint64_t getCurrentTick() const { return m_currentTick; }
+    size_t getActiveChunkCount() const { return m_activeChunks.size(); }
+    size_t getScheduledTickCount() const;
+
+    // True for block types that react to random ticks
+    static bool hasRandomTick(BlockType type) { return type == BlockType::Grass; }
+
+private:
+    struct ScheduledTick {
+        uint64_t dueTick;
+        uint64_t order; // Scheduling order, keeps ticks due on the same tick FIFO
+        glm::ivec3 worldBlockPos;
+
+        bool operator>(const ScheduledTick& other) const {
+            return dueTick != other.dueTick ? dueTick > other.dueTick : order > other.order;
+        }
+    };
+
+    // Per-chunk tick bookkeeping
+    struct ChunkTickState {
+        std::priority_queue<ScheduledTick, std::vector<ScheduledTick>, std::greater<ScheduledTick>> scheduled;
+        std::unordered_set<glm::ivec3> scheduledPositions; // Dedupes scheduleTick
+        int randomTickableCount = 0; // Blocks with hasRandomTick
+        bool countStale = true;      // Blocks changed since randomTickableCount was computed
+    };
+
+    void runScheduledTicks(ChunkTickState& state);
+    void runRandomTicks(Chunk* chunk);
+    void updateActive(const glm::ivec3& chunkCoord, ChunkTickState& state);
+
+    // Block behaviours
+    void scheduledTickBlock(const glm::ivec3& worldBlockPos, BlockType type);
+    void randomTickBlock(const glm::ivec3& worldBlockPos, BlockType type);
+    int getLightLevel(const glm::ivec3& worldBlockPos) const; // max(sky, block), 15 if not lit yet
+
+    World& m_world;
+    uint64_t m_currentTick;
+    uint64_t m_nextOrder;
+    std::unordered_map<glm::ivec3, ChunkTickState> m_chunkStates;
+    std::unordered_set<glm::ivec3> m_activeChunks;
+    std::vector<glm::ivec3> m_activeScratch; // Copy of m_activeChunks iterated by tick(), which may change the set
+    std::mt19937 m_random; // Fixed seed, so runs are reproducible
+};
+
+#endif // BLOCKTICKER_H
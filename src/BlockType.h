@@ -6,8 +6,34 @@ enum class BlockType : unsigned char { // Using unsigned char for smaller memory
     Air = 0,
     Stone = 1,
     Dirt = 2,
-    Grass = 3
-    // Water, Sand, Wood, etc.
+    Grass = 3,
+    Torch = 4,
+    Water = 5,
+    Lava = 6
+    // Sand, Wood, etc.
 };
 
-#endif // BLOCKTYPE_H 
\ No newline at end of file
+inline bool isFluid(BlockType type) {
+    return type == BlockType::Water || type == BlockType::Lava;
+}
+
+// Solid blocks collide with the player. Fluids and torches can be walked through.
+inline bool isSolid(BlockType type) {
+    return type != BlockType::Air && type != BlockType::Torch && !isFluid(type);
+}
+
+// Opaque blocks stop light. Everything else lets it through.
+inline bool isOpaque(BlockType type) {
+    return type != BlockType::Air && type != BlockType::Torch && !isFluid(type);
+}
+
+// Block light level (0-15) emitted by a block
+inline unsigned char getLightEmission(BlockType type) {
+    switch (type) {
+        case BlockType::Torch: return 14;
+        case BlockType::Lava: return 15;
+        default: return 0;
+    }
+}
+
+#endif // BLOCKTYPE_H
@@ -11,7 +11,7 @@ glm::mat4 Camera::GetViewMatrix() const {
 glm::mat4 Camera::GetProjectionMatrix() const {
     // Use WindowWidth and WindowHeight members as defined in Camera.h
     if (WindowHeight == 0) return glm::mat4(1.0f); // Avoid division by zero
-    return glm::perspective(glm::radians(Zoom), (float)WindowWidth / (float)WindowHeight, 0.1f, 100.0f);
+    return glm::perspective(glm::radians(Zoom), (float)WindowWidth / (float)WindowHeight, 0.1f, FarPlane);
 }
 
 void Camera::ProcessKeyboard(Camera_Movement direction, float deltaTime) {
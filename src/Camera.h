@@ -52,35 +52,14 @@ public:
     float MovementSpeed;
     float MouseSensitivity;
     float Zoom;
+    float FarPlane = 100.0f; // Distance of the far clipping plane, follows the terrain view distance
     // Window dimensions for aspect ratio
     int WindowWidth;
     int WindowHeight;
 
-    // Physics related
-    glm::vec3 Velocity = glm::vec3(0.0f); // Player's current velocity vector
-    bool isOnGround = false;
+    // Physics state (velocity, ground contact, collision box) lives in the player's entity, see EntitySystem
     bool isFlying = false; // Added for flight mode
 
-    // Helper to get player's collision AABB based on current position
-    AABB getPlayerAABB() const {
-        // Position is eye level. Calculate feet position first.
-        glm::vec3 feetPosition = Position;
-        feetPosition.y -= PLAYER_EYE_LEVEL;
-
-        AABB playerBox;
-        playerBox.min = glm::vec3(
-            feetPosition.x - PLAYER_WIDTH / 2.0f,
-            feetPosition.y, // Feet are at the bottom of the AABB
-            feetPosition.z - PLAYER_WIDTH / 2.0f
-        );
-        playerBox.max = glm::vec3(
-            feetPosition.x + PLAYER_WIDTH / 2.0f,
-            feetPosition.y + PLAYER_HEIGHT, // Top of the AABB
-            feetPosition.z + PLAYER_WIDTH / 2.0f
-        );
-        return playerBox;
-    }
-
     // Constructor with vectors
     Camera(glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f),
            glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f),
@@ -1,12 +1,21 @@
 #include "Chunk.h"
-#include <iostream> // For debug output
-#include <glad/glad.h> // For OpenGL functions
+#include "ChunkScheduler.h"
+#include "Logger.h"
 #include <vector> // For std::vector
 #include <glm/glm.hpp> // For glm::vec3
+#include <algorithm> // For std::copy
+#include <cmath> // For std::pow
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h> // SSE2, for building the air masks 16 blocks at a time
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h> // For _BitScanForward
+#endif
 
 // Each vertex: X, Y, Z, R, G, B (0.5f, 0.5f, 0.5f for grey)
 // Vertices for a single cube, face by face.
-// Each face has 6 vertices (2 triangles), each vertex has 6 floats. Total 36 floats per face.
+// Each face is a quad of 4 corners, each vertex has 6 floats. Total 24 floats per face.
+// The renderer draws corners 0-1-2 and 2-3-0 through its shared quad index buffer.
 
 // Define colors for block types
 const glm::vec3 colorStone(0.5f, 0.5f, 0.5f);    // Grey
@@ -14,94 +23,134 @@ const glm::vec3 colorDirt(0.6f, 0.4f, 0.2f);     // Brown
 const glm::vec3 colorGrassTop(0.0f, 0.8f, 0.0f); // Green for top
 const glm::vec3 colorGrassSide(0.5f, 0.35f, 0.15f); // Brownish for sides (used for sides and bottom of grass)
 const glm::vec3 colorGrassBottom(0.6f, 0.4f, 0.2f); // Dirt color for grass bottom
+const glm::vec3 colorTorch(1.0f, 0.85f, 0.3f);   // Yellow
+const glm::vec3 colorWater(0.15f, 0.35f, 0.85f);  // Blue
+const glm::vec3 colorLava(1.0f, 0.4f, 0.05f);     // Orange
+const glm::vec3 torchLightTint(1.0f, 0.85f, 0.6f); // Block light is a little warmer than sky light
+
+const glm::ivec3 Chunk::NEIGHBOR_OFFSETS[6] = {
+    glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0),
+    glm::ivec3(0, 1, 0), glm::ivec3(0, -1, 0),
+    glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1)
+};
+
+// Brightness of each light level. Every level is 80% of the one above, with a small ambient floor.
+static const float* lightLevelBrightness() {
+    struct Table {
+        float values[16];
+        Table() {
+            for (int level = 0; level < 16; ++level) {
+                values[level] = 0.05f + 0.95f * std::pow(0.8f, static_cast<float>(15 - level));
+            }
+        }
+    };
+    static const Table table; // Built once, on first use
+    return table.values;
+}
 
 // +X (Right)
 const float rightFaceVertices[] = {
     0.5f, -0.5f, -0.5f,
     0.5f,  0.5f, -0.5f,
     0.5f,  0.5f,  0.5f,
-    0.5f,  0.5f,  0.5f,
     0.5f, -0.5f,  0.5f,
-    0.5f, -0.5f, -0.5f,
 };
 // -X (Left)
 const float leftFaceVertices[] = {
     -0.5f, -0.5f,  0.5f,
     -0.5f,  0.5f,  0.5f,
     -0.5f,  0.5f, -0.5f,
-    -0.5f,  0.5f, -0.5f,
     -0.5f, -0.5f, -0.5f,
-    -0.5f, -0.5f,  0.5f,
 };
 // +Y (Top)
 const float topFaceVertices[] = {
     -0.5f,  0.5f, -0.5f,
      0.5f,  0.5f, -0.5f,
      0.5f,  0.5f,  0.5f,
-     0.5f,  0.5f,  0.5f,
     -0.5f,  0.5f,  0.5f,
-    -0.5f,  0.5f, -0.5f,
 };
 // -Y (Bottom)
 const float bottomFaceVertices[] = {
     -0.5f, -0.5f,  0.5f,
      0.5f, -0.5f,  0.5f,
      0.5f, -0.5f, -0.5f,
-     0.5f, -0.5f, -0.5f,
     -0.5f, -0.5f, -0.5f,
-    -0.5f, -0.5f,  0.5f,
 };
 // +Z (Front)
 const float frontFaceVertices[] = {
     -0.5f, -0.5f,  0.5f,
      0.5f, -0.5f,  0.5f,
      0.5f,  0.5f,  0.5f,
-     0.5f,  0.5f,  0.5f,
     -0.5f,  0.5f,  0.5f,
-    -0.5f, -0.5f,  0.5f,
 };
 // -Z (Back)
 const float backFaceVertices[] = {
      0.5f, -0.5f, -0.5f,
     -0.5f, -0.5f, -0.5f,
-    -0.5f,  0.5f, -0.5f,
     -0.5f,  0.5f, -0.5f,
      0.5f,  0.5f, -0.5f,
-     0.5f, -0.5f, -0.5f,
 };
 
-const int verticesPerFace = 6; 
+const float* Chunk::getFaceVertices(int direction) {
+    static const float* const faces[6] = { rightFaceVertices, leftFaceVertices, topFaceVertices, bottomFaceVertices, frontFaceVertices, backFaceVertices };
+    return faces[direction];
+}
+
+const int verticesPerFace = ChunkMesh::VERTICES_PER_QUAD;
 const int floatsPerVertexPositionData = 3; // X, Y, Z for the static face data
-const int floatsPerVertexRender = 6;       // X, Y, Z, R, G, B for the VBO and rendering
+const int floatsPerVertexRender = ChunkMesh::FLOATS_PER_VERTEX; // X, Y, Z, R, G, B for the VBO and rendering
 // const int floatsPerFaceData = verticesPerFace * floatsPerVertexPositionData; // 18 floats
-const int floatsPerFaceMesh = verticesPerFace * floatsPerVertexRender; // 36 floats (for reservation)
+const int floatsPerFaceMesh = verticesPerFace * floatsPerVertexRender; // 24 floats (for reservation)
 
 Chunk::Chunk(glm::ivec3 position) 
-    : worldPosition(position), m_vao(0), m_vbo(0), m_vertexCount(0), 
-      m_isGenerated(false), m_needsMeshBuild(false) { // Initialize new flags
-    m_blocks.resize(CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH, BlockType::Air);
+    : worldPosition(position), m_blocks(std::make_shared<BlockSnapshot>()), m_blocksPublished(false), m_version(0),
+      m_isGenerated(false), m_isLit(false), m_needsMeshBuild(false), m_scheduler(nullptr),
+      m_publishQueue(nullptr), m_inPublishQueue(false) { // Initialize new flags
+    std::fill(m_neighbors, m_neighbors + 6, nullptr);
+    std::fill(m_blocks->blocks, m_blocks->blocks + CHUNK_VOLUME, BlockType::Air);
+    m_light.resize(CHUNK_VOLUME, 0);
+    m_fluidLevels.resize(CHUNK_VOLUME / 2, 0);
+    MemoryStats::add(MemoryCategory::ChunkObjects, sizeof(Chunk) + m_light.capacity() + m_fluidLevels.capacity());
     // std::cout << "Chunk created at: " << position.x << ", " << position.y << ", " << position.z << std::endl;
 }
 
 Chunk::~Chunk() {
-    if (m_vbo != 0) {
-        glDeleteBuffers(1, &m_vbo);
-        m_vbo = 0;
-    }
-    if (m_vao != 0) {
-        glDeleteVertexArrays(1, &m_vao);
-        m_vao = 0;
-    }
+    // GPU buffers belong to the Renderer, which drops them once the mesh is no longer drawn.
+    MemoryStats::remove(MemoryCategory::ChunkObjects, sizeof(Chunk) + m_light.capacity() + m_fluidLevels.capacity());
     // std::cout << "Chunk destroyed: " << worldPosition.x << ", " << worldPosition.y << ", " << worldPosition.z << std::endl;
 }
 
 // Helper to convert 3D local coords to 1D array index
 int Chunk::coordsToIndex(int x, int y, int z) const {
     // Assumes x, y, z are already validated by isPositionInBounds if necessary
-    return x + y * CHUNK_WIDTH + z * CHUNK_WIDTH * CHUNK_HEIGHT;
+    return localIndex(x, y, z);
+}
+
+BlockType* Chunk::writableBlocks() {
+    if (m_blocksPublished) {
+        m_blocks = std::make_shared<BlockSnapshot>(*m_blocks); // Readers keep the published copy
+        m_blocksPublished = false;
+    }
+    m_version.fetch_add(1, std::memory_order_release);
+    if (m_publishQueue && !m_inPublishQueue) {
+        m_inPublishQueue = true; // Once per publish, however many edits follow
+        m_publishQueue->push_back(worldPosition);
+    }
+    return m_blocks->blocks;
+}
+
+Chunk::BlockSnapshotPtr Chunk::publishBlocks() {
+    m_inPublishQueue = false;
+    if (!m_blocksPublished) {
+        m_blocks->version = m_version.load(std::memory_order_relaxed);
+        m_blocksPublished = true;
+        std::atomic_store(&m_publishedBlocks, std::shared_ptr<const BlockSnapshot>(m_blocks));
+    }
+    return m_publishedBlocks; // Only the owner stores it, so the owner can read it plainly
 }
 
 void Chunk::generateSimpleTerrain() {
+    BlockType* blocks = writableBlocks();
     for (int x = 0; x < CHUNK_WIDTH; ++x) {
         for (int z = 0; z < CHUNK_DEPTH; ++z) {
             int terrainHeight = CHUNK_HEIGHT / 2; // Example:
@@ -116,13 +165,14 @@ void Chunk::generateSimpleTerrain() {
                 }
                 // Directly set block in m_blocks without triggering a mesh build here
                 if (isPositionInBounds(x,y,z)) {
-                     m_blocks[coordsToIndex(x,y,z)] = currentType;
+                     blocks[coordsToIndex(x,y,z)] = currentType;
                 }
             }
         }
     }
     m_isGenerated = true;
-    m_needsMeshBuild = true; // Mark for mesh build after terrain is set
+    m_isLit = false; // New blocks, LightEngine has to light them
+    setNeedsMeshBuild(true); // Mark for mesh build after terrain is set
     // std::cout << "Chunk generated simple terrain at " << worldPosition.x << ", " << worldPosition.z << std::endl;
     // buildMesh(); // Mesh will be built by World::processWorldUpdates or explicitly
 }
@@ -131,22 +181,61 @@ BlockType Chunk::getBlock(int x, int y, int z) const {
     if (!isPositionInBounds(x, y, z)) {
         return BlockType::Air;
     }
-    return m_blocks[coordsToIndex(x,y,z)];
+    return m_blocks->blocks[coordsToIndex(x,y,z)];
 }
 
-void Chunk::setBlock(int x, int y, int z, BlockType type) {
+bool Chunk::setBlock(int x, int y, int z, BlockType type) {
     if (!isPositionInBounds(x, y, z)) {
-        return;
+        return false;
     }
-    BlockType oldType = m_blocks[coordsToIndex(x,y,z)];
+    BlockType oldType = m_blocks->blocks[coordsToIndex(x,y,z)];
     if (oldType != type) { 
-        std::cout << "Chunk (" << worldPosition.x << "," << worldPosition.y << "," << worldPosition.z << ")"
-                  << " SetBlock at (" << x << "," << y << "," << z << ") from " << static_cast<int>(oldType)
-                  << " to " << static_cast<int>(type) << std::endl;
-        m_blocks[coordsToIndex(x,y,z)] = type;
-        m_needsMeshBuild = true; // Mark for rebuild, don't call buildMesh() directly
-        std::cout << "    m_needsMeshBuild is now: " << m_needsMeshBuild << std::endl;
+        LOG_TRACE(LogCategory::Chunk, "Chunk ({},{},{}) SetBlock at ({},{},{}) from {} to {}",
+                  worldPosition.x, worldPosition.y, worldPosition.z, x, y, z, oldType, type);
+        writableBlocks()[coordsToIndex(x,y,z)] = type;
+        setNeedsMeshBuild(true); // Mark for rebuild, don't call buildMesh() directly
+        return true;
     }
+    return false;
+}
+
+void Chunk::setBlockData(const BlockType* blocks) {
+    std::copy(blocks, blocks + CHUNK_VOLUME, writableBlocks());
+    m_isGenerated = true;
+    m_isLit = false;
+    if (m_scheduler) m_scheduler->requestSetup(worldPosition); // Has to be lit again
+    setNeedsMeshBuild(true);
+}
+
+void Chunk::setNeedsMeshBuild(bool needsBuild) {
+    m_needsMeshBuild = needsBuild;
+    // Requested every time, not only when the flag flips: a job that came up before the chunk was
+    // lit was dropped with the flag still set. The scheduler ignores duplicates.
+    if (needsBuild && m_scheduler) m_scheduler->requestMesh(worldPosition);
+}
+
+const Chunk* Chunk::resolveLocal(int& x, int& y, int& z) const {
+    const Chunk* chunk = this;
+    // One axis at a time, each step through the neighbor on that side (indices as in NEIGHBOR_OFFSETS)
+    if (x < 0) { chunk = chunk->m_neighbors[1]; x += CHUNK_WIDTH; }
+    else if (x >= CHUNK_WIDTH) { chunk = chunk->m_neighbors[0]; x -= CHUNK_WIDTH; }
+    if (!chunk) return nullptr;
+    if (y < 0) { chunk = chunk->m_neighbors[3]; y += CHUNK_HEIGHT; }
+    else if (y >= CHUNK_HEIGHT) { chunk = chunk->m_neighbors[2]; y -= CHUNK_HEIGHT; }
+    if (!chunk) return nullptr;
+    if (z < 0) { chunk = chunk->m_neighbors[5]; z += CHUNK_DEPTH; }
+    else if (z >= CHUNK_DEPTH) { chunk = chunk->m_neighbors[4]; z -= CHUNK_DEPTH; }
+    return chunk;
+}
+
+Chunk* Chunk::resolveLocal(int& x, int& y, int& z) {
+    return const_cast<Chunk*>(static_cast<const Chunk*>(this)->resolveLocal(x, y, z));
+}
+
+BlockType Chunk::getBlockNear(int x, int y, int z) const {
+    const Chunk* chunk = resolveLocal(x, y, z);
+    if (!chunk || !chunk->m_isGenerated) return BlockType::Air;
+    return chunk->m_blocks->blocks[localIndex(x, y, z)];
 }
 
 bool Chunk::isPositionInBounds(int x, int y, int z) const {
@@ -155,95 +244,315 @@ bool Chunk::isPositionInBounds(int x, int y, int z) const {
            z >= 0 && z < CHUNK_DEPTH;
 }
 
-// Helper function to add face vertices to the mesh
-void addFace(std::vector<float>& meshVertices, const float* faceVertexPositions, int blockX, int blockY, int blockZ, const glm::vec3& color) {
+void Chunk::clearLight() {
+    std::fill(m_light.begin(), m_light.end(), static_cast<uint8_t>(0));
+}
+
+uint8_t Chunk::sampleLight(int x, int y, int z, const Chunk* const* neighbors) const {
+    const uint8_t fullSky = 0xF0;
+    if (!m_isLit) return fullSky; // Not lit yet: draw at full brightness rather than black
+    if (isPositionInBounds(x, y, z)) {
+        return m_light[coordsToIndex(x, y, z)];
+    }
+
+    // One step outside: read the neighbor chunk's light, or assume open sky if it isn't there
+    int direction = x >= CHUNK_WIDTH ? 0 : x < 0 ? 1 : y >= CHUNK_HEIGHT ? 2 : y < 0 ? 3 : z >= CHUNK_DEPTH ? 4 : 5;
+    const Chunk* neighbor = neighbors ? neighbors[direction] : nullptr;
+    if (!neighbor || !neighbor->isLit()) return fullSky;
+    int nx = (x + CHUNK_WIDTH) % CHUNK_WIDTH;
+    int ny = (y + CHUNK_HEIGHT) % CHUNK_HEIGHT;
+    int nz = (z + CHUNK_DEPTH) % CHUNK_DEPTH;
+    return neighbor->m_light[localIndex(nx, ny, nz)];
+}
+
+// Height (0-1) of a fluid block's surface for a FluidEngine level
+static float fluidSurfaceHeight(uint8_t level) {
+    if (level >= 8) return 1.0f; // Falling
+    return 0.9f - level * 0.11f;
+}
+
+glm::vec3 Chunk::getFaceColor(BlockType type, int direction) {
+    switch (type) {
+        case BlockType::Stone: return colorStone;
+        case BlockType::Dirt: return colorDirt;
+        case BlockType::Grass: return direction == 2 ? colorGrassTop : direction == 3 ? colorGrassBottom : colorGrassSide;
+        case BlockType::Torch: return colorTorch;
+        case BlockType::Water: return colorWater;
+        case BlockType::Lava: return colorLava;
+        default: return glm::vec3(1.0f, 0.0f, 1.0f); // Magenta for error
+    }
+}
+
+// Tints a face color by the packed light value of the cell in front of it
+static glm::vec3 applyLight(const glm::vec3& color, uint8_t packedLight) {
+    const float* brightness = lightLevelBrightness();
+    glm::vec3 skyLight(brightness[packedLight >> 4]);
+    glm::vec3 blockLight = brightness[packedLight & 0x0F] * torchLightTint;
+    if ((packedLight & 0x0F) == 0) blockLight = glm::vec3(0.0f); // The ambient floor comes from the sky term
+    return color * glm::max(skyLight, blockLight);
+}
+
+// Helper function to add face vertices to the mesh.
+// topY replaces the +0.5 Y of the unit cube, so fluids can be drawn lower than a full block.
+void addFace(std::vector<float>& meshVertices, const float* faceVertexPositions, int blockX, int blockY, int blockZ, const glm::vec3& color, float topY = 0.5f) {
+    size_t first = meshVertices.size();
+    meshVertices.resize(first + floatsPerFaceMesh);
+    float* out = &meshVertices[first];
     for (int i = 0; i < verticesPerFace; ++i) {
         // Position data from faceVertexPositions
-        meshVertices.push_back(faceVertexPositions[i * floatsPerVertexPositionData + 0] + blockX); // Vertex X
-        meshVertices.push_back(faceVertexPositions[i * floatsPerVertexPositionData + 1] + blockY); // Vertex Y
-        meshVertices.push_back(faceVertexPositions[i * floatsPerVertexPositionData + 2] + blockZ); // Vertex Z
+        float vertexY = faceVertexPositions[i * floatsPerVertexPositionData + 1];
+        if (vertexY > 0.0f) vertexY = topY;
+        *out++ = faceVertexPositions[i * floatsPerVertexPositionData + 0] + blockX; // Vertex X
+        *out++ = vertexY + blockY; // Vertex Y
+        *out++ = faceVertexPositions[i * floatsPerVertexPositionData + 2] + blockZ; // Vertex Z
         // Color data
-        meshVertices.push_back(color.r);
-        meshVertices.push_back(color.g);
-        meshVertices.push_back(color.b);
+        *out++ = color.r;
+        *out++ = color.g;
+        *out++ = color.b;
     }
 }
 
-void Chunk::buildMesh() {
-    std::cout << "Chunk (" << worldPosition.x << "," << worldPosition.y << "," << worldPosition.z << ")"
-              << ": buildMesh() called. m_needsMeshBuild was true." << std::endl;
+void Chunk::buildMeshKey(const Chunk* const* neighbors, std::vector<uint8_t>& outKey) const {
+    static_assert(sizeof(BlockType) == 1, "Mesh keys store one byte per block");
+    outKey.clear();
+    outKey.push_back('F'); // Full-resolution chunk mesh (TerrainLod keys start with 'L')
+    const uint8_t* blocks = reinterpret_cast<const uint8_t*>(m_blocks->blocks);
+    outKey.insert(outKey.end(), blocks, blocks + CHUNK_VOLUME);
+    outKey.push_back(m_isLit ? 1 : 0);
 
-    std::vector<float> localMeshVertices;
-    // Estimate a reasonable starting capacity.
-    localMeshVertices.reserve(CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH * floatsPerFaceMesh / 4); 
+    // Only the values the mesher reads, so stale levels/light in other cells don't split equal chunks.
+    // Which cells contribute follows from the blocks above, so the key stays unambiguous.
+    for (int i = 0; i < CHUNK_VOLUME; ++i) {
+        if (isFluid(m_blocks->blocks[i])) outKey.push_back(getFluidLevel(i));
+        if (m_isLit && !isOpaque(m_blocks->blocks[i])) {
+            outKey.push_back(m_light[i]); // Faces are lit by the (see-through) cell in front of them
+        }
+    }
+    if (!m_isLit) return; // Unlit chunks don't sample their neighbors
 
-    // 1. Delete old VAO/VBO if they exist.
-    if (m_vao != 0) {
-        glDeleteBuffers(1, &m_vbo);
-        glDeleteVertexArrays(1, &m_vao);
-        m_vbo = 0;
-        m_vao = 0;
+    for (int direction = 0; direction < 6; ++direction) {
+        const Chunk* neighbor = neighbors ? neighbors[direction] : nullptr;
+        if (!neighbor || !neighbor->isLit()) {
+            outKey.push_back(0);
+            continue;
+        }
+        outKey.push_back(1);
+        // The neighbor's layer touching this chunk
+        const glm::ivec3& offset = NEIGHBOR_OFFSETS[direction];
+        int axis = offset.x != 0 ? 0 : offset.y != 0 ? 1 : 2;
+        for (int a = 0; a < CHUNK_WIDTH; ++a) {
+            for (int b = 0; b < CHUNK_WIDTH; ++b) {
+                glm::ivec3 pos;
+                pos[axis] = offset[axis] > 0 ? 0 : CHUNK_WIDTH - 1;
+                pos[(axis + 1) % 3] = a;
+                pos[(axis + 2) % 3] = b;
+                outKey.push_back(neighbor->m_light[localIndex(pos.x, pos.y, pos.z)]);
+            }
+        }
     }
-    // 2. Always reset vertex count.
-    m_vertexCount = 0;
+}
 
-    // 3. Build localMeshVertices 
-    for (int y = 0; y < CHUNK_HEIGHT; ++y) {
-        for (int z = 0; z < CHUNK_DEPTH; ++z) {
-            for (int x = 0; x < CHUNK_WIDTH; ++x) {
-                BlockType currentBlockType = getBlock(x, y, z);
-                // if (x == 0 && z == 0) { // Debug specific column
-                //     std::cout << "  buildMesh iterating: x=" << x << " y=" << y << " z=" << z << " type=" << static_cast<int>(currentBlockType) << std::endl;
-                // }
-                if (currentBlockType != BlockType::Air) {
-                    glm::vec3 baseColor; 
-                    glm::vec3 faceTopColor = colorGrassTop; 
-                    glm::vec3 faceSideColor = colorGrassSide;
-                    glm::vec3 faceBottomColor = colorGrassBottom;
-
-                    switch (currentBlockType) {
-                        case BlockType::Stone: baseColor = colorStone; break;
-                        case BlockType::Dirt: baseColor = colorDirt; break;
-                        case BlockType::Grass: /* handled per-face */ break;
-                        default: baseColor = glm::vec3(1.0f, 0.0f, 1.0f); break; // Magenta for error
-                    }
+// Bits of the 16 blocks of a row (x = 0..15) that are air, that light and sight pass through
+// (!isOpaque), that are fluids and that are torches (the one see-through block that isn't a fluid)
+struct RowMasks {
+    uint32_t air;
+    uint32_t transparent;
+    uint32_t fluid;
+    uint32_t torch;
+};
 
-                    // Check faces and add to localMeshVertices if exposed
-                    if (getBlock(x + 1, y, z) == BlockType::Air) { addFace(localMeshVertices, rightFaceVertices, x, y, z, (currentBlockType == BlockType::Grass) ? faceSideColor : baseColor); }
-                    if (getBlock(x - 1, y, z) == BlockType::Air) { addFace(localMeshVertices, leftFaceVertices, x, y, z, (currentBlockType == BlockType::Grass) ? faceSideColor : baseColor); }
-                    if (getBlock(x, y + 1, z) == BlockType::Air) { addFace(localMeshVertices, topFaceVertices, x, y, z, (currentBlockType == BlockType::Grass) ? faceTopColor : baseColor); }
-                    if (getBlock(x, y - 1, z) == BlockType::Air) { addFace(localMeshVertices, bottomFaceVertices, x, y, z, (currentBlockType == BlockType::Grass) ? faceBottomColor : baseColor); }
-                    if (getBlock(x, y, z + 1) == BlockType::Air) { addFace(localMeshVertices, frontFaceVertices, x, y, z, (currentBlockType == BlockType::Grass) ? faceSideColor : baseColor); }
-                    if (getBlock(x, y, z - 1) == BlockType::Air) { addFace(localMeshVertices, backFaceVertices, x, y, z, (currentBlockType == BlockType::Grass) ? faceSideColor : baseColor); }
-                }
+static RowMasks classifyRow(const BlockType* row) {
+    static_assert(static_cast<int>(BlockType::Air) == 0, "The SIMD compare looks for zero bytes");
+    RowMasks masks;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    __m128i blocks = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+    __m128i air = _mm_cmpeq_epi8(blocks, _mm_setzero_si128());
+    __m128i torch = _mm_cmpeq_epi8(blocks, _mm_set1_epi8(static_cast<char>(BlockType::Torch)));
+    __m128i fluid = _mm_or_si128(_mm_cmpeq_epi8(blocks, _mm_set1_epi8(static_cast<char>(BlockType::Water))),
+                                 _mm_cmpeq_epi8(blocks, _mm_set1_epi8(static_cast<char>(BlockType::Lava))));
+    masks.air = static_cast<uint32_t>(_mm_movemask_epi8(air));
+    masks.transparent = static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(air, torch), fluid)));
+    masks.fluid = static_cast<uint32_t>(_mm_movemask_epi8(fluid));
+    masks.torch = static_cast<uint32_t>(_mm_movemask_epi8(torch));
+#else
+    masks.air = masks.transparent = masks.fluid = masks.torch = 0;
+    for (int x = 0; x < Chunk::CHUNK_WIDTH; ++x) {
+        if (row[x] == BlockType::Air) masks.air |= 1u << x;
+        if (!isOpaque(row[x])) masks.transparent |= 1u << x;
+        if (isFluid(row[x])) masks.fluid |= 1u << x;
+        if (row[x] == BlockType::Torch) masks.torch |= 1u << x;
+    }
+#endif
+    return masks;
+}
+
+static int countTrailingZeros(uint64_t value) { // value must not be 0
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<uint32_t>(value))) return static_cast<int>(index);
+    _BitScanForward(&index, static_cast<uint32_t>(value >> 32));
+    return static_cast<int>(index) + 32;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+static int countBits(uint64_t value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(value));
+#elif defined(_MSC_VER)
+    return static_cast<int>(__popcnt(static_cast<uint32_t>(value)) + __popcnt(static_cast<uint32_t>(value >> 32)));
+#else
+    return __builtin_popcountll(value);
+#endif
+}
+
+void Chunk::buildBlockMasks(uint64_t (&air)[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER],
+                            uint64_t (&transparent)[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER],
+                            uint64_t (&fluid)[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER],
+                            uint64_t (&torch)[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER]) const {
+    for (int y = 0; y < CHUNK_HEIGHT; ++y) {
+        for (int word = 0; word < MASK_WORDS_PER_LAYER; ++word) {
+            uint64_t airBits = 0, transparentBits = 0, fluidBits = 0, torchBits = 0;
+            for (int row = 0; row < MASK_ROWS_PER_WORD; ++row) {
+                int z = word * MASK_ROWS_PER_WORD + row;
+                RowMasks masks = classifyRow(&m_blocks->blocks[coordsToIndex(0, y, z)]);
+                airBits |= static_cast<uint64_t>(masks.air) << (row * CHUNK_WIDTH);
+                transparentBits |= static_cast<uint64_t>(masks.transparent) << (row * CHUNK_WIDTH);
+                fluidBits |= static_cast<uint64_t>(masks.fluid) << (row * CHUNK_WIDTH);
+                torchBits |= static_cast<uint64_t>(masks.torch) << (row * CHUNK_WIDTH);
             }
+            air[y][word] = airBits;
+            transparent[y][word] = transparentBits;
+            fluid[y][word] = fluidBits;
+            torch[y][word] = torchBits;
         }
     }
+}
+
+float Chunk::getFluidSurface(int x, int y, int z) const {
+    int index = coordsToIndex(x, y, z);
+    if (getBlock(x, y + 1, z) == m_blocks->blocks[index]) return 1.0f; // The same fluid goes on above
+    return fluidSurfaceHeight(getFluidLevel(index));
+}
+
+bool Chunk::isFluidFaceVisible(int x, int y, int z, int direction) const {
+    BlockType type = m_blocks->blocks[coordsToIndex(x, y, z)];
+    glm::ivec3 front = glm::ivec3(x, y, z) + NEIGHBOR_OFFSETS[direction];
+    BlockType neighbor = getBlock(front.x, front.y, front.z); // Air outside the chunk
+    if (neighbor != type) {
+        // A lowered surface shows below an opaque block too, unless it is flush with its bottom
+        if (direction == 2 && isOpaque(neighbor)) return getFluidSurface(x, y, z) < 1.0f;
+        return !isOpaque(neighbor);
+    }
+    // Same fluid: the cells join, except where this surface stands above the neighbor's
+    if (direction == 2 || direction == 3) return false;
+    return getFluidSurface(front.x, front.y, front.z) < getFluidSurface(x, y, z);
+}
 
-    // 4. If new mesh data exists, create and populate VAO/VBO.
-    if (!localMeshVertices.empty()) {
-        glGenVertexArrays(1, &m_vao);
-        glGenBuffers(1, &m_vbo);
+void Chunk::buildMesh(const Chunk* const* neighbors) {
+    LOG_TRACE(LogCategory::Chunk, "Chunk ({},{},{}): buildMesh() called", worldPosition.x, worldPosition.y, worldPosition.z);
 
-        glBindVertexArray(m_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-        glBufferData(GL_ARRAY_BUFFER, localMeshVertices.size() * sizeof(float), localMeshVertices.data(), GL_STATIC_DRAW);
+    std::shared_ptr<ChunkMesh> mesh = std::make_shared<ChunkMesh>();
+    mesh->id = allocateChunkMeshId();
 
-        // Position attribute
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, floatsPerVertexRender * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-        // Color attribute
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, floatsPerVertexRender * sizeof(float), (void*)(floatsPerVertexPositionData * sizeof(float)));
-        glEnableVertexAttribArray(1);
+    // 1. Find exposed faces with bit masks (see buildBlockMasks): 64 blocks per operation
+    uint64_t air[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER];
+    uint64_t transparent[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER];
+    uint64_t fluid[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER];
+    uint64_t torch[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER];
+    buildBlockMasks(air, transparent, fluid, torch);
+    const uint64_t allAir = ~0ull; // Outside the chunk counts as air, as in getBlock
+    uint64_t faceMasks[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER][6];
+    int faceCounts[6] = {};
+    for (int y = 0; y < CHUNK_HEIGHT; ++y) {
+        for (int word = 0; word < MASK_WORDS_PER_LAYER; ++word) {
+            uint64_t open = transparent[y][word];
+            uint64_t filled = ~air[y][word];
+            // Bit i of faces[d] is set when the block at bit i isn't air and its neighbor in direction d
+            // can be seen through (air, torch or fluid: lowered fluid surfaces leave the rest of the face open).
+            // X neighbors are the next/previous bit within a 16-bit row (the row ends count as air),
+            // Z neighbors are 16 bits (one row) away, continuing into the adjacent word.
+            uint64_t* faces = faceMasks[y][word];
+            faces[0] = filled & ((open >> 1) | MASK_ROW_LAST_BITS);
+            faces[1] = filled & ((open << 1) | MASK_ROW_FIRST_BITS);
+            faces[2] = filled & (y + 1 < CHUNK_HEIGHT ? transparent[y + 1][word] : allAir);
+            faces[3] = filled & (y > 0 ? transparent[y - 1][word] : allAir);
+            faces[4] = filled & ((open >> 16) | ((word + 1 < MASK_WORDS_PER_LAYER ? transparent[y][word + 1] : allAir) << 48));
+            faces[5] = filled & ((open << 16) | ((word > 0 ? transparent[y][word - 1] : allAir) >> 48));
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+            // Torch against torch: nothing to see between them, like between cells of one fluid.
+            // Same shifts as above, with the outside of the chunk counting as no torch.
+            uint64_t torches = torch[y][word];
+            if (torches != 0) {
+                faces[0] &= ~(torches & (torches >> 1) & ~MASK_ROW_LAST_BITS);
+                faces[1] &= ~(torches & (torches << 1) & ~MASK_ROW_FIRST_BITS);
+                faces[2] &= ~(torches & (y + 1 < CHUNK_HEIGHT ? torch[y + 1][word] : 0));
+                faces[3] &= ~(torches & (y > 0 ? torch[y - 1][word] : 0));
+                faces[4] &= ~(torches & ((torches >> 16) | ((word + 1 < MASK_WORDS_PER_LAYER ? torch[y][word + 1] : 0) << 48)));
+                faces[5] &= ~(torches & ((torches << 16) | ((word > 0 ? torch[y][word - 1] : 0) >> 48)));
+            }
 
-        m_vertexCount = static_cast<int>(localMeshVertices.size() / floatsPerVertexRender);
+            // Fluid cells (rare) decide each face on their own: see isFluidFaceVisible
+            uint64_t fluidCells = fluid[y][word];
+            while (fluidCells != 0) {
+                int bit = countTrailingZeros(fluidCells);
+                fluidCells &= fluidCells - 1;
+                int x = bit % CHUNK_WIDTH;
+                int z = word * MASK_ROWS_PER_WORD + bit / CHUNK_WIDTH;
+                for (int direction = 0; direction < 6; ++direction) {
+                    if (isFluidFaceVisible(x, y, z, direction)) faces[direction] |= 1ull << bit;
+                    else faces[direction] &= ~(1ull << bit);
+                }
+            }
+            for (int direction = 0; direction < 6; ++direction) faceCounts[direction] += countBits(faces[direction]);
+        }
+    }
+
+    // 2. Emit them grouped by direction (the renderer skips groups facing away from the camera),
+    //    each group in block order (y, z, x), into a vertex array of exactly the right size
+    mesh->directionStart[0] = 0;
+    for (int direction = 0; direction < 6; ++direction) {
+        mesh->directionStart[direction + 1] = mesh->directionStart[direction] + faceCounts[direction];
     }
-    // else: m_vertexCount remains 0, m_vao remains 0. Nothing to render for this chunk.
+    std::vector<float>& localMeshVertices = mesh->vertices;
+    localMeshVertices.reserve(static_cast<size_t>(mesh->directionStart[6]) * floatsPerFaceMesh);
+    for (int direction = 0; direction < 6; ++direction) {
+        const float* faceVertices = getFaceVertices(direction);
+        for (int y = 0; y < CHUNK_HEIGHT; ++y) {
+            for (int word = 0; word < MASK_WORDS_PER_LAYER; ++word) {
+                uint64_t faces = faceMasks[y][word][direction];
+                while (faces != 0) {
+                    int bit = countTrailingZeros(faces);
+                    faces &= faces - 1;
+                    int x = bit % CHUNK_WIDTH;
+                    int z = word * MASK_ROWS_PER_WORD + bit / CHUNK_WIDTH;
+                    int index = coordsToIndex(x, y, z);
+                    BlockType currentBlockType = m_blocks->blocks[index];
+
+                    float topY = 0.5f;
+                    if (isFluid(currentBlockType)) {
+                        // Surface height follows the level: sources almost fill the block, thin flows hug the floor
+                        topY = getFluidSurface(x, y, z) - 0.5f;
+                    }
+                    // Each face is lit by the cell in front of it
+                    glm::ivec3 front = glm::ivec3(x, y, z) + NEIGHBOR_OFFSETS[direction];
+                    addFace(localMeshVertices, faceVertices, x, y, z,
+                            applyLight(getFaceColor(currentBlockType, direction), sampleLight(front.x, front.y, front.z, neighbors)), topY);
+                }
+            }
+        }
+    }
+
+    // 3. Publish the mesh. GPU upload happens on the render thread when it first draws it.
+    mesh->vertexCount = static_cast<int>(localMeshVertices.size() / floatsPerVertexRender);
+    mesh->trackMemory();
+    m_mesh = std::move(mesh);
     
     m_needsMeshBuild = false;
-    std::cout << "    buildMesh() finished. New m_vertexCount: " << m_vertexCount 
-              << ", m_vao: " << m_vao << ", m_vbo: " << m_vbo << std::endl;
+    LOG_TRACE(LogCategory::Chunk, "    buildMesh() finished. New vertex count: {}, mesh id: {}", m_mesh->vertexCount, m_mesh->id);
 } 
\ No newline at end of file
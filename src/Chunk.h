@@ -2,16 +2,27 @@
 #define CHUNK_H
 
 #include "BlockType.h"
+#include "ChunkMesh.h"
+#include "MemoryStats.h"
+#include <algorithm> // For std::copy
 #include <vector>
+#include <cstdint>
+#include <atomic>
+#include <memory>
 #include <glm/glm.hpp> // For chunk position (ivec3)
-#include <glad/glad.h> // For GLuint
 #include <glm/gtc/type_ptr.hpp>
 
+class ChunkScheduler;
+
 class Chunk {
 public:
     static const int CHUNK_WIDTH = 16;  // X dimension
     static const int CHUNK_HEIGHT = 16; // Y dimension (Minecraft is 256, but start smaller)
     static const int CHUNK_DEPTH = 16;  // Z dimension
+    static const int CHUNK_VOLUME = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_DEPTH; // Blocks per chunk
+
+    // Neighbor directions, in the same order as the mesh faces: +X, -X, +Y, -Y, +Z, -Z
+    static const glm::ivec3 NEIGHBOR_OFFSETS[6];
 
     // Chunk coordinates in the world (not block coordinates)
     glm::ivec3 worldPosition;
@@ -22,16 +33,104 @@ public:
     void generateSimpleTerrain(); // Fills the chunk with some basic terrain
 
     BlockType getBlock(int x, int y, int z) const; // Local coordinates within the chunk
-    void setBlock(int x, int y, int z, BlockType type); // Local coordinates
+    bool setBlock(int x, int y, int z, BlockType type); // Local coordinates. Returns true if the block changed.
+
+    // Raw block storage (CHUNK_VOLUME entries, same layout as coordsToIndex).
+    // Used by serializers that want to read the chunk without per-block calls.
+    const BlockType* getBlockData() const { return m_blocks->blocks; }
+    // Writable variant for bulk editors. Callers must setNeedsMeshBuild(true) after changing blocks.
+    BlockType* getBlockDataForWrite() { return writableBlocks(); }
+    static int localIndex(int x, int y, int z) { return x + y * CHUNK_WIDTH + z * CHUNK_WIDTH * CHUNK_HEIGHT; }
+    // Replaces the whole block array (e.g. chunk received from a server) and marks the chunk generated + dirty.
+    void setBlockData(const BlockType* blocks);
 
     bool isPositionInBounds(int x, int y, int z) const;
 
-    void buildMesh(); // Generates the VAO/VBO for this chunk's visible faces
+    // --- Concurrent access ---
+    // Everything else in Chunk belongs to the simulation thread. Other threads (meshers, savers,
+    // network serializers) read blocks through snapshots: immutable copies published by the owner,
+    // which they can keep as long as they like while the owner goes on editing.
+    //
+    // Block arrays are copy-on-write: publishing hands the current array out as the snapshot without
+    // copying, and the owner's next edit copies it once (4 KB) before writing. A chunk edited many
+    // times between two publishes is copied once.
+    struct BlockSnapshot {
+        uint64_t version = 0; // getVersion() when it was published
+        BlockType blocks[CHUNK_VOLUME];
+
+        // Counted in MemoryStats (BlockData) for as long as the owner or any reader holds it
+        BlockSnapshot() { MemoryStats::add(MemoryCategory::BlockData, sizeof(BlockSnapshot)); }
+        BlockSnapshot(const BlockSnapshot& other) : version(other.version) {
+            std::copy(other.blocks, other.blocks + CHUNK_VOLUME, blocks);
+            MemoryStats::add(MemoryCategory::BlockData, sizeof(BlockSnapshot));
+        }
+        BlockSnapshot& operator=(const BlockSnapshot&) = delete;
+        ~BlockSnapshot() { MemoryStats::remove(MemoryCategory::BlockData, sizeof(BlockSnapshot)); }
+    };
+    using BlockSnapshotPtr = std::shared_ptr<const BlockSnapshot>;
+
+    // Any thread. Latest published blocks, null until the chunk's first publish.
+    BlockSnapshotPtr getBlockSnapshot() const { return std::atomic_load(&m_publishedBlocks); }
+    // Any thread. Counts block edits; a snapshot with a lower version is missing some.
+    uint64_t getVersion() const { return m_version.load(std::memory_order_acquire); }
+    // Owner thread. Publishes the blocks if they changed since the last publish (World does this
+    // every tick). Returns the now current snapshot, so the owner can hand it to a worker directly.
+    BlockSnapshotPtr publishBlocks();
+    // Owner thread. The first block write after a publish appends this chunk's coordinates to queue,
+    // so the owner publishes only the chunks that changed (set by World, null for standalone chunks).
+    void setPublishQueue(std::vector<glm::ivec3>* queue) { m_publishQueue = queue; }
+
+    // Loaded neighbors, direction in NEIGHBOR_OFFSETS order, null where none is loaded.
+    // World links them when a chunk is created and unlinks them before it is destroyed.
+    Chunk* getNeighbor(int direction) const { return m_neighbors[direction]; }
+    void setNeighbor(int direction, Chunk* neighbor) { m_neighbors[direction] = neighbor; }
+    const Chunk* const* getNeighbors() const { return m_neighbors; } // For buildMesh()/buildMeshKey()
+    // Resolves local coordinates up to one chunk outside this one (each in [-size, 2 * size)) through the
+    // neighbor links, without a World lookup. Returns the chunk holding the block and rewrites x, y, z to
+    // its local coordinates, or null if it isn't loaded. Diagonal chunks are reached through an edge
+    // neighbor, so they read as not loaded while that one isn't.
+    Chunk* resolveLocal(int& x, int& y, int& z);
+    const Chunk* resolveLocal(int& x, int& y, int& z) const;
+    // Block at local coordinates that may lie in a neighbor (see resolveLocal). Air if not loaded or generated.
+    BlockType getBlockNear(int x, int y, int z) const;
+
+    // Light storage: one byte per block, sky light in the high nibble and block light in the low one.
+    // Filled and kept up to date by LightEngine.
+    uint8_t getSkyLight(int index) const { return m_light[index] >> 4; }
+    uint8_t getBlockLight(int index) const { return m_light[index] & 0x0F; }
+    void setSkyLight(int index, uint8_t level) { m_light[index] = static_cast<uint8_t>((m_light[index] & 0x0F) | (level << 4)); }
+    void setBlockLight(int index, uint8_t level) { m_light[index] = static_cast<uint8_t>((m_light[index] & 0xF0) | level); }
+    void clearLight();
+    bool isLit() const { return m_isLit; }
+    void setLit(bool lit) { m_isLit = lit; }
+
+    // Fluid level of a Water/Lava block, packed two per byte (see FluidEngine for the meaning).
+    // Meaningless for other blocks. 0 (the default) is a source block.
+    uint8_t getFluidLevel(int index) const { return (m_fluidLevels[index >> 1] >> ((index & 1) * 4)) & 0x0F; }
+    void setFluidLevel(int index, uint8_t level) {
+        int shift = (index & 1) * 4;
+        m_fluidLevels[index >> 1] = static_cast<uint8_t>((m_fluidLevels[index >> 1] & ~(0x0F << shift)) | ((level & 0x0F) << shift));
+    }
+
+    // Unlit color of a block face, direction in NEIGHBOR_OFFSETS order (grass has a green top)
+    static glm::vec3 getFaceColor(BlockType type, int direction);
+    // Unit cube face (4 corners of a quad, X Y Z each, centered on the block), direction in NEIGHBOR_OFFSETS order
+    static const float* getFaceVertices(int direction);
+
+    // Generates the CPU mesh of this chunk's visible faces (no GL calls, see ChunkMesh).
+    // neighbors (optional, NEIGHBOR_OFFSETS order, entries may be null) supply light for faces on the chunk border.
+    void buildMesh(const Chunk* const* neighbors = nullptr);
     
-    // Getter for renderer
-    GLuint getVAO() const { return m_vao; }
-    int getVertexCount() const { return m_vertexCount; }
-    bool hasMesh() const { return m_vao != 0 && m_vertexCount > 0; }
+    // Appends every input buildMesh() reads to outKey (cleared first): blocks, fluid levels, the light of
+    // air cells and the neighbors' light layers touching this chunk. Equal keys build equal meshes.
+    void buildMeshKey(const Chunk* const* neighbors, std::vector<uint8_t>& outKey) const;
+    // Uses an already built mesh (e.g. from ChunkMeshCache) instead of calling buildMesh()
+    void setMesh(const ChunkMeshPtr& mesh) { m_mesh = mesh; m_needsMeshBuild = false; }
+
+    // Getter for renderer. The mesh is immutable and shared with the render thread.
+    const ChunkMeshPtr& getMesh() const { return m_mesh; }
+    int getVertexCount() const { return m_mesh ? m_mesh->vertexCount : 0; }
+    bool hasMesh() const { return m_mesh && m_mesh->vertexCount > 0; }
 
     glm::ivec3 getWorldPosition() const { return worldPosition; }
 
@@ -39,7 +138,9 @@ public:
     bool isGenerated() const { return m_isGenerated; }
     void setGenerated(bool generated) { m_isGenerated = generated; }
     bool needsMeshBuild() const { return m_needsMeshBuild; }
-    void setNeedsMeshBuild(bool needsBuild) { m_needsMeshBuild = needsBuild; }
+    void setNeedsMeshBuild(bool needsBuild); // true also queues the rebuild with the scheduler, if any
+    // The chunk asks scheduler for its setup and mesh work from now on (set by World, null for standalone chunks)
+    void setScheduler(ChunkScheduler* scheduler) { m_scheduler = scheduler; }
 
     // For later: methods to build a mesh from the chunk data
     // void buildMesh();
@@ -50,19 +151,53 @@ private:
     // 3D array of blocks. std::vector might be slow for direct access.
     // A flat 1D array is usually more cache-friendly and faster.
     // Access via: blocks[x + y * CHUNK_WIDTH + z * CHUNK_WIDTH * CHUNK_HEIGHT]
-    std::vector<BlockType> m_blocks;
+    // The owner's current blocks. While m_blocksPublished, the same array is the published snapshot
+    // and must not be written: writableBlocks() copies it first.
+    std::shared_ptr<BlockSnapshot> m_blocks;
+    std::shared_ptr<const BlockSnapshot> m_publishedBlocks; // Only accessed with std::atomic_load/store
+    bool m_blocksPublished;
+    std::atomic<uint64_t> m_version;
 
-    GLuint m_vao;
-    GLuint m_vbo;
-    // GLuint m_ebo; // If using indexed drawing later
-    int m_vertexCount;
-    // std::vector<float> m_meshVertices; // Temporary storage during buildMesh, not kept as member
+    // Owner's blocks for writing (copied first if published) and counts the edit
+    BlockType* writableBlocks();
+
+    std::vector<uint8_t> m_light; // Sky/block light nibbles, same layout as m_blocks
+    std::vector<uint8_t> m_fluidLevels; // CHUNK_VOLUME / 2 bytes
+
+    ChunkMeshPtr m_mesh; // Latest built mesh, null until the first buildMesh()
 
     bool m_isGenerated;      // True if generateSimpleTerrain has run
+    bool m_isLit;            // True once LightEngine has lit the current blocks
     bool m_needsMeshBuild;   // True if blocks changed and mesh needs rebuild
+    ChunkScheduler* m_scheduler; // Not owned
+    std::vector<glm::ivec3>* m_publishQueue; // Not owned, see setPublishQueue()
+    bool m_inPublishQueue;       // Written since the last publishBlocks() and queued for it
+    Chunk* m_neighbors[6];       // Not owned, see getNeighbor()
 
     // Helper to convert 3D local coords to 1D array index
     int coordsToIndex(int x, int y, int z) const;
+
+    // Meshing masks: one bit per block, a 64-bit word holds MASK_ROWS_PER_WORD rows along X (16 bits each)
+    // of consecutive z at one y. Bit (z % 4) * 16 + x of air[y][z / 4] is set when that block is air;
+    // transparent, fluid and torch have the same layout for !isOpaque, isFluid and Torch blocks.
+    static const int MASK_ROWS_PER_WORD = 4;
+    static const int MASK_WORDS_PER_LAYER = CHUNK_DEPTH / MASK_ROWS_PER_WORD;
+    static const uint64_t MASK_ROW_FIRST_BITS = 0x0001000100010001ull; // x = 0 of every row
+    static const uint64_t MASK_ROW_LAST_BITS = MASK_ROW_FIRST_BITS << 15; // x = 15 of every row
+    static_assert(CHUNK_WIDTH == 16 && CHUNK_DEPTH % MASK_ROWS_PER_WORD == 0, "Mask layout assumes 16-block rows");
+    void buildBlockMasks(uint64_t (&air)[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER],
+                         uint64_t (&transparent)[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER],
+                         uint64_t (&fluid)[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER],
+                         uint64_t (&torch)[CHUNK_HEIGHT][MASK_WORDS_PER_LAYER]) const;
+    // Surface height (0-1) of the fluid at local x, y, z: full when the same fluid continues above
+    float getFluidSurface(int x, int y, int z) const;
+    // Whether a fluid block's face is drawn. Faces between cells of the same fluid are culled unless
+    // this one's surface is higher (the side shows above the lower neighbor); a lowered surface is
+    // drawn even under an opaque block, since the gap above it can be seen from the side.
+    bool isFluidFaceVisible(int x, int y, int z, int direction) const;
+
+    // Packed light of the cell a face looks into (local coords, may be one step outside the chunk)
+    uint8_t sampleLight(int x, int y, int z, const Chunk* const* neighbors) const;
 };
 
 #endif // CHUNK_H 
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef CHUNKMESH_H
+#define CHUNKMESH_H
+
+#include "MemoryStats.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// CPU-side result of meshing a chunk. Built by the simulation thread and never modified
+// afterwards, so the render thread can read (and upload) it while the chunk is remeshed.
+//
+// Vertices come in quads of 4 corners. The renderer draws every mesh through one shared index
+// buffer that turns quad q into triangles 4q+0, 4q+1, 4q+2 and 4q+2, 4q+3, 4q+0.
+// Quads are grouped by the direction they face, so the renderer can skip whole groups that
+// point away from the camera.
+struct ChunkMesh {
+    static const int FLOATS_PER_VERTEX = 6; // X, Y, Z, R, G, B
+    static const int VERTICES_PER_QUAD = 4;
+    static const int INDICES_PER_QUAD = 6;  // Two triangles
+    // Most quads a mesh can hold: every block showing all six faces. Faces show against any see-through
+    // neighbor of another type, so alternating torch and water cells get there. LOD meshes stay below it.
+    // 4 * MAX_QUADS vertices need 32-bit indices.
+    static const int MAX_QUADS = 16 * 16 * 16 * 6;
+    static const int DIRECTION_COUNT = 6;   // Chunk::NEIGHBOR_OFFSETS order: +X, -X, +Y, -Y, +Z, -Z
+
+    uint64_t id = 0;            // Unique per built mesh; the renderer keys its GPU buffers on it
+    std::vector<float> vertices;
+    int vertexCount = 0;
+    // Quads facing direction d are [directionStart[d], directionStart[d + 1]); the last entry is the quad count
+    int directionStart[DIRECTION_COUNT + 1] = {};
+    size_t trackedBytes = 0;    // Counted in MemoryStats (CpuMeshes), see trackMemory()
+
+    ChunkMesh() = default;
+    ChunkMesh(const ChunkMesh&) = delete;
+    ChunkMesh& operator=(const ChunkMesh&) = delete;
+    ~ChunkMesh() {
+        if (trackedBytes != 0) MemoryStats::remove(MemoryCategory::CpuMeshes, trackedBytes);
+    }
+
+    // Builders call this once the vertices are final; the mesh counts until it is destroyed
+    void trackMemory() {
+        trackedBytes = sizeof(ChunkMesh) + vertices.capacity() * sizeof(float);
+        MemoryStats::add(MemoryCategory::CpuMeshes, trackedBytes);
+    }
+};
+
+using ChunkMeshPtr = std::shared_ptr<const ChunkMesh>;
+
+// Next ChunkMesh::id, shared by every mesh builder (full-resolution and LOD meshes)
+inline uint64_t allocateChunkMeshId() {
+    static std::atomic<uint64_t> s_nextMeshId(1);
+    return s_nextMeshId++;
+}
+
+#endif // CHUNKMESH_H
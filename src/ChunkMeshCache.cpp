@@ -0,0 +1,150 @@
+#include "ChunkMeshCache.h"
+#include "FileUtils.h"
+#include <cstdio>     // For std::snprintf
+#include <filesystem> // For creating the cache directory
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+static const uint32_t DISK_MAGIC = 0x48534D43; // "CMSH"
+static const uint32_t DISK_VERSION = 5;        // Bump when the key or vertex layout changes
+
+ChunkMeshCache::ChunkMeshCache(size_t memoryBudget)
+    : m_memoryBudget(memoryBudget), m_memoryUsed(0), m_hits(0), m_misses(0) {}
+
+uint64_t ChunkMeshCache::hashKey(const Key& key) {
+    // FNV-1a, 8 bytes at a time
+    uint64_t hash = 14695981039346656037ull;
+    size_t i = 0;
+    for (; i + 8 <= key.size(); i += 8) {
+        uint64_t word = 0;
+        for (int b = 0; b < 8; ++b) word |= static_cast<uint64_t>(key[i + b]) << (8 * b);
+        hash = (hash ^ word) * 1099511628211ull;
+    }
+    for (; i < key.size(); ++i) {
+        hash = (hash ^ key[i]) * 1099511628211ull;
+    }
+    return hash ^ (hash >> 29);
+}
+
+size_t ChunkMeshCache::sizeOf(const Entry& entry) {
+    return entry.key.size() + entry.mesh->vertices.size() * sizeof(float);
+}
+
+ChunkMeshPtr ChunkMeshCache::find(const Key& key) {
+    uint64_t hash = hashKey(key);
+    auto it = m_entries.find(hash);
+    if (it != m_entries.end() && it->second.key == key) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition); // Most recently used
+        ++m_hits;
+        return it->second.mesh;
+    }
+    if (!m_diskDirectory.empty()) {
+        ChunkMeshPtr mesh = loadFromDisk(hash, key);
+        if (mesh) {
+            store(hash, key, mesh);
+            ++m_hits;
+            return mesh;
+        }
+    }
+    ++m_misses;
+    return nullptr;
+}
+
+void ChunkMeshCache::insert(const Key& key, const ChunkMeshPtr& mesh) {
+    uint64_t hash = hashKey(key);
+    store(hash, key, mesh);
+    if (!m_diskDirectory.empty()) saveToDisk(hash, key, *mesh);
+}
+
+void ChunkMeshCache::store(uint64_t hash, const Key& key, const ChunkMeshPtr& mesh) {
+    auto it = m_entries.find(hash);
+    if (it != m_entries.end()) { // Same key rebuilt, or a colliding one: the newest wins
+        m_memoryUsed -= sizeOf(it->second);
+        m_lru.erase(it->second.lruPosition);
+        m_entries.erase(it);
+    }
+    m_lru.push_front(hash);
+    Entry& entry = m_entries[hash];
+    entry.key = key;
+    entry.mesh = mesh;
+    entry.lruPosition = m_lru.begin();
+    m_memoryUsed += sizeOf(entry);
+    evict();
+}
+
+void ChunkMeshCache::evict() {
+    // Meshes still used by chunks stay alive through their shared_ptr; only the cache forgets them
+    while (m_memoryUsed > m_memoryBudget && m_lru.size() > 1) {
+        auto it = m_entries.find(m_lru.back());
+        m_memoryUsed -= sizeOf(it->second);
+        m_entries.erase(it);
+        m_lru.pop_back();
+    }
+}
+
+void ChunkMeshCache::setDiskDirectory(const std::string& directory) {
+    m_diskDirectory = directory;
+    if (m_diskDirectory.empty()) return;
+    std::error_code error;
+    std::filesystem::create_directories(m_diskDirectory, error);
+    if (error) {
+        std::cerr << "ChunkMeshCache: cannot create " << m_diskDirectory << ": " << error.message()
+                  << ", disk cache disabled" << std::endl;
+        m_diskDirectory.clear();
+    }
+}
+
+std::string ChunkMeshCache::diskPath(uint64_t hash) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.mesh", static_cast<unsigned long long>(hash));
+    return m_diskDirectory + "/" + name;
+}
+
+// File layout: magic, version, key size, key bytes, direction starts, float count, vertex floats (native endianness)
+ChunkMeshPtr ChunkMeshCache::loadFromDisk(uint64_t hash, const Key& key) const {
+    std::ifstream file(diskPath(hash), std::ios::binary);
+    if (!file) return nullptr;
+    uint32_t magic = 0, version = 0, keySize = 0, floatCount = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&keySize), sizeof(keySize));
+    if (!file || magic != DISK_MAGIC || version != DISK_VERSION || keySize != key.size()) return nullptr;
+    Key storedKey(keySize);
+    file.read(reinterpret_cast<char*>(storedKey.data()), keySize);
+    if (!file || storedKey != key) return nullptr;
+    std::shared_ptr<ChunkMesh> mesh = std::make_shared<ChunkMesh>();
+    file.read(reinterpret_cast<char*>(mesh->directionStart), sizeof(mesh->directionStart));
+    file.read(reinterpret_cast<char*>(&floatCount), sizeof(floatCount));
+    const uint32_t floatsPerQuad = ChunkMesh::FLOATS_PER_VERTEX * ChunkMesh::VERTICES_PER_QUAD;
+    if (!file || floatCount % floatsPerQuad != 0) return nullptr;
+    if (mesh->directionStart[0] != 0 || mesh->directionStart[ChunkMesh::DIRECTION_COUNT] != static_cast<int>(floatCount / floatsPerQuad)) return nullptr;
+    for (int direction = 0; direction < ChunkMesh::DIRECTION_COUNT; ++direction) {
+        if (mesh->directionStart[direction] > mesh->directionStart[direction + 1]) return nullptr;
+    }
+
+    mesh->id = allocateChunkMeshId();
+    mesh->vertices.resize(floatCount);
+    file.read(reinterpret_cast<char*>(mesh->vertices.data()), floatCount * sizeof(float));
+    if (!file) return nullptr;
+    mesh->vertexCount = static_cast<int>(floatCount / ChunkMesh::FLOATS_PER_VERTEX);
+    mesh->trackMemory();
+    return mesh;
+}
+
+void ChunkMeshCache::saveToDisk(uint64_t hash, const Key& key, const ChunkMesh& mesh) const {
+    std::string path = diskPath(hash);
+    if (std::filesystem::exists(path)) return; // Same content already stored (or a collision we keep)
+    // Written beside the real name and renamed into place, so a crash never leaves a truncated entry
+    writeFileAtomically(path, [&key, &mesh](std::ostream& file) {
+        uint32_t keySize = static_cast<uint32_t>(key.size());
+        uint32_t floatCount = static_cast<uint32_t>(mesh.vertices.size());
+        file.write(reinterpret_cast<const char*>(&DISK_MAGIC), sizeof(DISK_MAGIC));
+        file.write(reinterpret_cast<const char*>(&DISK_VERSION), sizeof(DISK_VERSION));
+        file.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+        file.write(reinterpret_cast<const char*>(key.data()), keySize);
+        file.write(reinterpret_cast<const char*>(mesh.directionStart), sizeof(mesh.directionStart));
+        file.write(reinterpret_cast<const char*>(&floatCount), sizeof(floatCount));
+        file.write(reinterpret_cast<const char*>(mesh.vertices.data()), floatCount * sizeof(float));
+    });
+}
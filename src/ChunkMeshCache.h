@@ -0,0 +1,65 @@
+#ifndef CHUNKMESHCACHE_H
+#define CHUNKMESHCACHE_H
+
+#include "ChunkMesh.h"
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Meshes keyed by everything that went into building them, so chunks with identical contents share
+// one mesh (and, since the renderer keys GPU buffers on the mesh id, one VBO).
+//
+// A key is the mesher's complete input as bytes (see Chunk::buildMeshKey); entries are found by
+// its 64-bit hash and confirmed by comparing the whole key, so a hash collision is just a miss.
+// Kept in memory up to a byte budget (least recently used first out) and, if a directory is set,
+// also written to disk so a later run can skip meshing chunks it has seen before.
+//
+// Simulation thread only.
+class ChunkMeshCache {
+public:
+    using Key = std::vector<uint8_t>;
+
+    static const size_t DEFAULT_MEMORY_BUDGET = 128 * 1024 * 1024; // Bytes of cached vertex data
+
+    explicit ChunkMeshCache(size_t memoryBudget = DEFAULT_MEMORY_BUDGET);
+
+    // The mesh built from key, or null. Looks on disk after a memory miss.
+    ChunkMeshPtr find(const Key& key);
+    void insert(const Key& key, const ChunkMeshPtr& mesh);
+
+    // Directory for the on-disk cache; empty (the default) keeps the cache in memory only
+    void setDiskDirectory(const std::string& directory);
+
+    size_t getEntryCount() const { return m_entries.size(); }
+    size_t getMemoryUsed() const { return m_memoryUsed; }
+    uint64_t getHitCount() const { return m_hits; }
+    uint64_t getMissCount() const { return m_misses; }
+
+private:
+    struct Entry {
+        Key key;
+        ChunkMeshPtr mesh;
+        std::list<uint64_t>::iterator lruPosition;
+    };
+
+    static uint64_t hashKey(const Key& key);
+    static size_t sizeOf(const Entry& entry);
+    void store(uint64_t hash, const Key& key, const ChunkMeshPtr& mesh); // Memory only
+    void evict();
+
+    std::string diskPath(uint64_t hash) const;
+    ChunkMeshPtr loadFromDisk(uint64_t hash, const Key& key) const;
+    void saveToDisk(uint64_t hash, const Key& key, const ChunkMesh& mesh) const;
+
+    size_t m_memoryBudget;
+    size_t m_memoryUsed;
+    std::unordered_map<uint64_t, Entry> m_entries;
+    std::list<uint64_t> m_lru; // Most recently used first
+    std::string m_diskDirectory;
+    uint64_t m_hits;
+    uint64_t m_misses;
+};
+
+#endif // CHUNKMESHCACHE_H
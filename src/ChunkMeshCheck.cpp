@@ -0,0 +1,78 @@
+// ChunkMeshCheck: meshes standalone chunks built to show as many faces as possible and checks the
+// quad counts, without a window. Every mesh must fit ChunkMesh::MAX_QUADS (the renderer's shared
+// quad index buffer); the counts pin down which faces the mesher culls between see-through blocks.
+// Exits with 1 and lists the failed checks if anything is off.
+#include "Chunk.h"
+#include "ChunkMesh.h"
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static int g_failures = 0;
+
+static void check(bool condition, const std::string& what) {
+    if (condition) return;
+    std::cerr << "FAILED: " << what << std::endl;
+    ++g_failures;
+}
+
+static const int FACES_ON_CHUNK_SIDES = 6 * Chunk::CHUNK_WIDTH * Chunk::CHUNK_WIDTH;
+
+// Quads of a chunk filled by pick(x, y, z). Fluids are sources, the chunk is unlit and alone.
+static int meshQuads(const std::string& name, const std::function<BlockType(int, int, int)>& pick) {
+    std::vector<BlockType> blocks(Chunk::CHUNK_VOLUME);
+    for (int z = 0; z < Chunk::CHUNK_DEPTH; ++z) {
+        for (int y = 0; y < Chunk::CHUNK_HEIGHT; ++y) {
+            for (int x = 0; x < Chunk::CHUNK_WIDTH; ++x) blocks[Chunk::localIndex(x, y, z)] = pick(x, y, z);
+        }
+    }
+    Chunk chunk(glm::ivec3(0));
+    chunk.setBlockData(blocks.data());
+    chunk.buildMesh();
+    const ChunkMesh& mesh = *chunk.getMesh();
+    int quads = mesh.directionStart[ChunkMesh::DIRECTION_COUNT];
+    check(quads <= ChunkMesh::MAX_QUADS, name + ": " + std::to_string(quads) + " quads, over ChunkMesh::MAX_QUADS");
+    check(mesh.vertexCount == quads * ChunkMesh::VERTICES_PER_QUAD, name + ": 4 vertices per quad");
+    std::cout << "  " << name << ": " << quads << " quads" << std::endl;
+    return quads;
+}
+
+static bool odd(int x, int y, int z) { return ((x + y + z) & 1) != 0; }
+
+int main() {
+    std::cout << "ChunkMeshCheck (limit " << ChunkMesh::MAX_QUADS << " quads):" << std::endl;
+
+    // Filled with one type: only the chunk's outside shows
+    check(meshQuads("stone", [](int, int, int) { return BlockType::Stone; }) == FACES_ON_CHUNK_SIDES,
+          "stone shows only its outside");
+    check(meshQuads("torches", [](int, int, int) { return BlockType::Torch; }) == FACES_ON_CHUNK_SIDES,
+          "torches hide the faces between them");
+    check(meshQuads("water", [](int, int, int) { return BlockType::Water; }) == FACES_ON_CHUNK_SIDES,
+          "water cells join");
+
+    // 3D checkerboards: every filled block surrounded by blocks it shows faces against
+    meshQuads("stone/air", [](int x, int y, int z) { return odd(x, y, z) ? BlockType::Stone : BlockType::Air; });
+    meshQuads("torch/air", [](int x, int y, int z) { return odd(x, y, z) ? BlockType::Torch : BlockType::Air; });
+    meshQuads("stone/water", [](int x, int y, int z) { return odd(x, y, z) ? BlockType::Stone : BlockType::Water; });
+    meshQuads("stone/torch", [](int x, int y, int z) { return odd(x, y, z) ? BlockType::Stone : BlockType::Torch; });
+    // The worst case MAX_QUADS is sized for: every block shows all six faces
+    check(meshQuads("torch/water", [](int x, int y, int z) { return odd(x, y, z) ? BlockType::Torch : BlockType::Water; }) ==
+              ChunkMesh::MAX_QUADS,
+          "torch/water shows every face");
+    meshQuads("water/lava", [](int x, int y, int z) { return odd(x, y, z) ? BlockType::Water : BlockType::Lava; });
+
+    // Every type mixed, from a fixed seed
+    unsigned seed = 12345;
+    meshQuads("random", [&seed](int, int, int) {
+        seed = seed * 1103515245u + 12345u;
+        return static_cast<BlockType>((seed >> 16) % 7);
+    });
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "ChunkMeshCheck: all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "ChunkPrefetcher.h"
+#include "World.h"
+#include <algorithm> // For std::min, std::max
+#include <cmath>
+
+ChunkPrefetcher::ChunkPrefetcher(World& world)
+    : m_world(world), m_lastPosition(0.0f), m_hasLastPosition(false), m_velocity(0.0f),
+      m_setupRate(MIN_SETUP_RATE), m_lastCompletedSetups(0), m_wasBusy(false),
+      m_lookaheadChunks(0.0f), m_heading(0.0f), m_prefetched(0) {}
+
+void ChunkPrefetcher::measureSetupRate(float deltaSeconds) {
+    const ChunkScheduler& scheduler = m_world.getScheduler();
+    uint64_t completed = scheduler.getCompletedSetupCount();
+    // An idle scheduler only shows how little work there was, not how much it can do
+    if (m_wasBusy && deltaSeconds > 0.0f) {
+        float rate = static_cast<float>(completed - m_lastCompletedSetups) / deltaSeconds;
+        m_setupRate += (rate - m_setupRate) * RATE_SMOOTHING;
+        m_setupRate = std::max(m_setupRate, MIN_SETUP_RATE * 0.1f); // Never assume it stopped altogether
+    }
+    m_lastCompletedSetups = completed;
+    m_wasBusy = scheduler.getPendingSetupCount() > 0;
+}
+
+void ChunkPrefetcher::update(const glm::vec3& cameraPosition, float deltaSeconds) {
+    measureSetupRate(deltaSeconds);
+
+    if (m_hasLastPosition && deltaSeconds > 0.0f) {
+        glm::vec3 sample = (cameraPosition - m_lastPosition) / deltaSeconds;
+        if (glm::length(sample) > MAX_TRACKED_SPEED) {
+            m_velocity = glm::vec3(0.0f); // Teleported; start over from here
+        } else {
+            m_velocity += (sample - m_velocity) * VELOCITY_SMOOTHING;
+        }
+    }
+    m_lastPosition = cameraPosition;
+    m_hasLastPosition = true;
+
+    // Chunks only exist in one layer, so the path is followed in XZ
+    glm::vec2 horizontal(m_velocity.x, m_velocity.z);
+    float speed = glm::length(horizontal);
+    ChunkScheduler& scheduler = m_world.getScheduler();
+    if (speed < MIN_SPEED) {
+        m_lookaheadChunks = 0.0f;
+        scheduler.setPredictedTravel(glm::vec3(0.0f));
+        return;
+    }
+
+    // Chunks queued now are ready once the scheduler has worked through everything before them
+    float queueSeconds = static_cast<float>(scheduler.getPendingSetupCount()) / m_setupRate;
+    float distance = speed * (queueSeconds + MARGIN_SECONDS);
+    distance = std::min(distance, static_cast<float>(MAX_LOOKAHEAD_CHUNKS * Chunk::CHUNK_WIDTH));
+    m_lookaheadChunks = distance / Chunk::CHUNK_WIDTH;
+    glm::vec2 heading = horizontal / speed;
+    m_heading = heading;
+    prefetchAlong(cameraPosition, heading, distance);
+    scheduler.setPredictedTravel(glm::vec3(heading.x, 0.0f, heading.y) * distance); // Path chunks before the sides
+}
+
+void ChunkPrefetcher::prefetchAlong(const glm::vec3& cameraPosition, const glm::vec2& heading, float distance) {
+    // Samples half a chunk apart, so no chunk the path crosses is skipped
+    const float step = Chunk::CHUNK_WIDTH * 0.5f;
+    glm::ivec3 lastCenter(0, -1, 0); // Not a chunk on the loaded layer
+    for (float travelled = 0.0f; travelled <= distance; travelled += step) {
+        glm::vec2 point = glm::vec2(cameraPosition.x, cameraPosition.z) + heading * travelled;
+        glm::ivec3 center(static_cast<int>(std::floor(point.x / Chunk::CHUNK_WIDTH)), 0,
+                          static_cast<int>(std::floor(point.y / Chunk::CHUNK_DEPTH)));
+        if (center == lastCenter) continue;
+        lastCenter = center;
+        for (int dx = -PATH_RADIUS; dx <= PATH_RADIUS; ++dx) {
+            for (int dz = -PATH_RADIUS; dz <= PATH_RADIUS; ++dz) {
+                if (m_world.ensureChunkExists(center + glm::ivec3(dx, 0, dz))) ++m_prefetched;
+            }
+        }
+    }
+}
+
+bool ChunkPrefetcher::isOnPath(const glm::ivec3& chunkCoord) const {
+    if (m_lookaheadChunks <= 0.0f) return false;
+    // The chunk's center relative to the camera, along the heading and across it
+    glm::vec2 chunkCenter((chunkCoord.x + 0.5f) * Chunk::CHUNK_WIDTH, (chunkCoord.z + 0.5f) * Chunk::CHUNK_DEPTH);
+    glm::vec2 offset = chunkCenter - glm::vec2(m_lastPosition.x, m_lastPosition.z);
+    float along = glm::dot(offset, m_heading);
+    float across = std::abs(offset.x * m_heading.y - offset.y * m_heading.x);
+    // prefetchAlong() covers PATH_RADIUS chunks to each side of the chunk each sample falls in
+    float halfWidth = (PATH_RADIUS + 1) * static_cast<float>(Chunk::CHUNK_WIDTH);
+    return along >= -halfWidth && along <= m_lookaheadChunks * Chunk::CHUNK_WIDTH + halfWidth && across <= halfWidth;
+}
@@ -0,0 +1,58 @@
+#ifndef CHUNKPREFETCHER_H
+#define CHUNKPREFETCHER_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+class World;
+
+// Loads chunks along the camera's predicted path, ahead of TerrainLod's radius loader.
+//
+// When flying fast the camera crosses a chunk every few ticks, and chunks that only get queued
+// once they enter the near ring aren't generated and meshed by the time they're on screen.
+// The prefetcher smooths the camera's velocity over the last ticks and adds the chunks in a
+// corridor along that heading to the World, so the ChunkScheduler works on them early.
+//
+// How far ahead is adaptive: as far as the camera travels while the scheduler works through its
+// setup queue (pending jobs / measured setup jobs per second), plus a margin. A slow machine or
+// a long queue looks further ahead; the distance is capped so a burst of speed can't flood the queue.
+class ChunkPrefetcher {
+public:
+    static constexpr float MIN_SPEED = 6.0f;              // Blocks/s (horizontal) before prefetching starts
+    static constexpr float MAX_TRACKED_SPEED = 500.0f;    // Faster camera jumps are teleports, not travel
+    static constexpr float VELOCITY_SMOOTHING = 0.15f;    // Weight of the newest tick in the velocity average
+    static constexpr float RATE_SMOOTHING = 0.05f;        // Same for the measured setup rate
+    static constexpr float MARGIN_SECONDS = 1.0f;         // Extra lookahead on top of the queue time
+    static constexpr float MIN_SETUP_RATE = 10.0f;        // Setups/s assumed before anything was measured
+    static const int MAX_LOOKAHEAD_CHUNKS = 16;
+    static const int PATH_RADIUS = 1;                     // Corridor half width in chunks (3 chunks wide)
+
+    explicit ChunkPrefetcher(World& world);
+
+    // Once per tick, after TerrainLod::update(): tracks the camera and loads the chunks ahead of it
+    void update(const glm::vec3& cameraPosition, float deltaSeconds);
+
+    const glm::vec3& getVelocity() const { return m_velocity; }
+    float getSetupRate() const { return m_setupRate; }             // Setup jobs per second, while busy
+    float getLookaheadChunks() const { return m_lookaheadChunks; } // 0 when not prefetching
+    uint64_t getPrefetchedCount() const { return m_prefetched; }   // Chunks created by the prefetcher
+    // Whether the chunk lies in the corridor the last update() prefetched, so it shouldn't be unloaded yet
+    bool isOnPath(const glm::ivec3& chunkCoord) const;
+
+private:
+    void measureSetupRate(float deltaSeconds);
+    void prefetchAlong(const glm::vec3& cameraPosition, const glm::vec2& heading, float distance);
+
+    World& m_world;
+    glm::vec3 m_lastPosition;
+    bool m_hasLastPosition;
+    glm::vec3 m_velocity;
+    float m_setupRate;
+    uint64_t m_lastCompletedSetups;
+    bool m_wasBusy; // Setup jobs were waiting at the last update, so the rate measures capacity
+    float m_lookaheadChunks;
+    glm::vec2 m_heading; // Unit XZ direction of the last prefetch
+    uint64_t m_prefetched;
+};
+
+#endif // CHUNKPREFETCHER_H
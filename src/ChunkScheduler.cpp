@@ -0,0 +1,139 @@
+#include "ChunkScheduler.h"
+#include "World.h"
+#include <algorithm> // For std::push_heap, std::pop_heap, std::make_heap
+#include <chrono>
+#include <functional> // For std::greater
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+ChunkScheduler::ChunkScheduler(World& world)
+    : m_world(world), m_focusPosition(0.0f), m_focusDirection(0.0f, 0.0f, -1.0f),
+      m_prioritizedPosition(0.0f), m_prioritizedDirection(0.0f, 0.0f, -1.0f),
+      m_predictedTravel(0.0f), m_prioritizedTravel(0.0f),
+      m_budgetMs(DEFAULT_BUDGET_MS), m_jobLimit(0), m_lastRunMs(0.0), m_completedSetups(0),
+      m_completedMeshes(0) {}
+
+void ChunkScheduler::setFocus(const glm::vec3& position, const glm::vec3& viewDirection) {
+    m_focusPosition = position;
+    float length = glm::length(viewDirection);
+    if (length > 0.0f) m_focusDirection = viewDirection / length;
+    refocusIfMoved();
+}
+
+void ChunkScheduler::setPredictedTravel(const glm::vec3& travel) {
+    m_predictedTravel = travel;
+    refocusIfMoved();
+}
+
+void ChunkScheduler::refocusIfMoved() {
+    // Queued priorities only need to follow the camera roughly
+    if (glm::distance(m_focusPosition, m_prioritizedPosition) > REFOCUS_DISTANCE ||
+        glm::dot(m_focusDirection, m_prioritizedDirection) < REFOCUS_ANGLE_COS ||
+        glm::distance(m_predictedTravel, m_prioritizedTravel) > REFOCUS_DISTANCE) {
+        m_prioritizedPosition = m_focusPosition;
+        m_prioritizedDirection = m_focusDirection;
+        m_prioritizedTravel = m_predictedTravel;
+        reprioritize(m_setupHeap);
+        reprioritize(m_meshHeap);
+    }
+}
+
+float ChunkScheduler::priorityOf(const glm::ivec3& chunkCoord) const {
+    glm::vec3 size(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH);
+    glm::vec3 center = glm::vec3(chunkCoord) * size + size * 0.5f - 0.5f; // Blocks are centered on their coordinates
+    glm::vec3 toChunk = center - m_prioritizedPosition;
+    float distance = glm::length(toChunk);
+    if (distance < 1e-3f) return 0.0f;
+    // 1 straight ahead, 1 + BEHIND_PENALTY straight behind
+    float facing = glm::dot(toChunk / distance, m_prioritizedDirection);
+    float travelLengthSquared = glm::dot(m_prioritizedTravel, m_prioritizedTravel);
+    if (travelLengthSquared > 0.0f) {
+        // Distance to the predicted path, plus a fraction of the way along it
+        float along = glm::clamp(glm::dot(toChunk, m_prioritizedTravel) / travelLengthSquared, 0.0f, 1.0f);
+        glm::vec3 closest = m_prioritizedTravel * along;
+        distance = glm::distance(toChunk, closest) + glm::length(closest) * PATH_DISTANCE_WEIGHT;
+    }
+    return distance * (1.0f + BEHIND_PENALTY * (1.0f - facing) * 0.5f);
+}
+
+void ChunkScheduler::push(std::vector<Job>& heap, const glm::ivec3& chunkCoord) {
+    heap.push_back({priorityOf(chunkCoord), chunkCoord});
+    std::push_heap(heap.begin(), heap.end(), std::greater<Job>());
+}
+
+void ChunkScheduler::reprioritize(std::vector<Job>& heap) {
+    for (Job& job : heap) job.priority = priorityOf(job.chunkCoord);
+    std::make_heap(heap.begin(), heap.end(), std::greater<Job>());
+}
+
+void ChunkScheduler::requestSetup(const glm::ivec3& chunkCoord) {
+    if (m_setupQueued.insert(chunkCoord).second) push(m_setupHeap, chunkCoord);
+}
+
+void ChunkScheduler::requestMesh(const glm::ivec3& chunkCoord) {
+    if (m_meshQueued.insert(chunkCoord).second) push(m_meshHeap, chunkCoord);
+}
+
+bool ChunkScheduler::runSetupJob() {
+    if (m_setupHeap.empty()) return false;
+    std::pop_heap(m_setupHeap.begin(), m_setupHeap.end(), std::greater<Job>());
+    glm::ivec3 chunkCoord = m_setupHeap.back().chunkCoord;
+    m_setupHeap.pop_back();
+    m_setupQueued.erase(chunkCoord);
+    if (Chunk* chunk = m_world.getChunk(chunkCoord)) {
+        m_world.setUpChunk(*chunk);
+        ++m_completedSetups;
+    }
+    return true;
+}
+
+bool ChunkScheduler::runMeshJob() {
+    if (m_meshHeap.empty()) return false;
+    std::pop_heap(m_meshHeap.begin(), m_meshHeap.end(), std::greater<Job>());
+    glm::ivec3 chunkCoord = m_meshHeap.back().chunkCoord;
+    m_meshHeap.pop_back();
+    m_meshQueued.erase(chunkCoord);
+    // Chunks that aren't set up yet are asked for again once lighting marks them dirty
+    Chunk* chunk = m_world.getChunk(chunkCoord);
+    if (chunk && chunk->isGenerated() && chunk->isLit() && chunk->needsMeshBuild()) {
+        m_world.buildChunkMesh(*chunk);
+        ++m_completedMeshes;
+    }
+    return true;
+}
+
+int ChunkScheduler::run() {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int jobs = 0;
+
+    // Setup first: new chunks have to be generated and lit before their meshes are worth building.
+    // While meshes wait as well, setup gets half the budget so visible changes keep coming.
+    // With a job limit the same split is counted in jobs and the clock isn't consulted at all.
+    bool counted = m_jobLimit > 0;
+    double setupBudget = m_meshHeap.empty() ? m_budgetMs : m_budgetMs * 0.5;
+    int setupLimit = m_meshHeap.empty() ? m_jobLimit : std::max(1, m_jobLimit / 2);
+    auto setupHasRoom = [&]() { return counted ? jobs < setupLimit : millisecondsSince(start) < setupBudget; };
+    auto meshHasRoom = [&]() { return counted ? jobs < m_jobLimit : millisecondsSince(start) < m_budgetMs; };
+    while ((jobs == 0 || setupHasRoom()) && runSetupJob()) ++jobs;
+
+    m_world.updateLighting(); // Relights around changed blocks; marks the affected meshes dirty
+
+    bool ranMesh = false;
+    while ((!ranMesh || meshHasRoom()) && runMeshJob()) {
+        ranMesh = true;
+        ++jobs;
+    }
+
+    m_lastRunMs = millisecondsSince(start);
+    return jobs;
+}
+
+void ChunkScheduler::runAll() {
+    while (!m_setupHeap.empty() || !m_meshHeap.empty()) {
+        while (runSetupJob()) {}
+        m_world.updateLighting();
+        while (runMeshJob()) {}
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef CHUNKSCHEDULER_H
+#define CHUNKSCHEDULER_H
+
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp> // For std::hash<glm::ivec3>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+class World;
+class Chunk;
+
+// Orders and rations the World's per-chunk work: setting chunks up (terrain generation, first
+// lighting) and building their meshes.
+//
+// Chunks ask for work themselves when they become dirty (see Chunk::setScheduler), so nothing scans
+// the loaded chunks. Both kinds of work wait in priority queues, nearest to the camera first, with
+// chunks behind the view direction pushed back. run() takes jobs off the queues until the tick's
+// time budget is spent, so a burst of new chunks is spread over several ticks instead of one long one.
+class ChunkScheduler {
+public:
+    static constexpr double DEFAULT_BUDGET_MS = 4.0;
+    static constexpr float BEHIND_PENALTY = 2.0f;  // A chunk right behind the camera counts as (1 + this) times as far
+    static constexpr float REFOCUS_DISTANCE = 4.0f; // Camera movement (blocks) before queued work is reprioritized
+    static constexpr float REFOCUS_ANGLE_COS = 0.94f; // ... or view direction change (about 20 degrees)
+    static constexpr float PATH_DISTANCE_WEIGHT = 0.25f; // How much distance along the predicted path counts
+
+    explicit ChunkScheduler(World& world);
+
+    // Camera position and view direction that the priorities are computed from
+    void setFocus(const glm::vec3& position, const glm::vec3& viewDirection);
+    // Where the camera is expected to be soon, relative to the focus (zero when not travelling, see
+    // ChunkPrefetcher). Chunks near the segment up to there count as near, the ones further along
+    // the path only a little further, so the way ahead is ready before the sides of the view.
+    void setPredictedTravel(const glm::vec3& travel);
+    // Milliseconds of chunk work per run(). At least one job always runs, so work never stalls.
+    void setBudget(double milliseconds) { m_budgetMs = milliseconds; }
+    double getBudget() const { return m_budgetMs; }
+    // A fixed number of jobs per run() instead of the time budget; 0 (the default) uses the budget.
+    // Replays use it, so which chunks exist at a given tick doesn't depend on the machine's speed.
+    void setJobLimit(int jobsPerRun) { m_jobLimit = jobsPerRun; }
+    int getJobLimit() const { return m_jobLimit; }
+
+    // Requests, from World and Chunk. Duplicates are ignored; stale jobs (chunk unloaded, work done
+    // meanwhile) are dropped when they come up.
+    void requestSetup(const glm::ivec3& chunkCoord); // Generate if needed, then light
+    void requestMesh(const glm::ivec3& chunkCoord);
+
+    // Runs queued work in priority order within the budget or job limit (setup first, up to half
+    // of it while meshes are also waiting). Returns the number of jobs done.
+    int run();
+    // Runs everything queued, regardless of the budget (tools, tests)
+    void runAll();
+
+    size_t getPendingSetupCount() const { return m_setupQueued.size(); }
+    size_t getPendingMeshCount() const { return m_meshQueued.size(); }
+    double getLastRunMs() const { return m_lastRunMs; }
+    // Setup jobs run so far (for measuring generation throughput)
+    uint64_t getCompletedSetupCount() const { return m_completedSetups; }
+    // Meshes built so far (cache hits included)
+    uint64_t getCompletedMeshCount() const { return m_completedMeshes; }
+
+private:
+    struct Job {
+        float priority; // Lower runs first
+        glm::ivec3 chunkCoord;
+        bool operator>(const Job& other) const { return priority > other.priority; }
+    };
+
+    float priorityOf(const glm::ivec3& chunkCoord) const;
+    void refocusIfMoved(); // Reprioritizes the queues once the focus or path changed noticeably
+    void push(std::vector<Job>& heap, const glm::ivec3& chunkCoord);
+    void reprioritize(std::vector<Job>& heap);
+    // Pops and runs the best job of heap; false if the heap is empty
+    bool runSetupJob();
+    bool runMeshJob();
+
+    World& m_world;
+    glm::vec3 m_focusPosition;
+    glm::vec3 m_focusDirection;
+    glm::vec3 m_prioritizedPosition;  // Focus the queued priorities were computed for
+    glm::vec3 m_prioritizedDirection;
+    glm::vec3 m_predictedTravel;
+    glm::vec3 m_prioritizedTravel;
+    double m_budgetMs;
+    int m_jobLimit;
+    double m_lastRunMs;
+    uint64_t m_completedSetups;
+    uint64_t m_completedMeshes;
+
+    std::vector<Job> m_setupHeap; // Min-heaps on priority (std::greater)
+    std::vector<Job> m_meshHeap;
+    std::unordered_set<glm::ivec3> m_setupQueued;
+    std::unordered_set<glm::ivec3> m_meshQueued;
+};
+
+#endif // CHUNKSCHEDULER_H
@@ -0,0 +1,259 @@
+#include "EntitySystem.h"
+#include "World.h"
+#include "Chunk.h"
+#include "ThreadPool.h"
+#include <algorithm> // For std::max, std::min
+#include <cmath>     // For std::ceil, std::floor, std::fabs
+
+static const float TERMINAL_VELOCITY = -50.0f;
+static const float GROUND_FRICTION = 10.0f;  // Horizontal speed lost per second on the ground (fraction, clamped)
+static const float COLLISION_EPSILON = 0.001f; // Gap left between a box and the block it was pushed out of
+static const float MAX_STEP = 0.45f;          // Longest move per collision sub-step, so nothing tunnels through a block
+
+EntitySystem::EntitySystem(ThreadPool* pool) : m_pool(pool), m_broadphase(4.0f) {}
+
+EntityId EntitySystem::spawn(EntityType type, const glm::vec3& feetPosition, float width, float height) {
+    uint32_t slotIndex;
+    if (!m_freeSlots.empty()) {
+        slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        if (m_slots.size() >= static_cast<size_t>(MAX_ENTITIES)) return INVALID_ENTITY;
+        slotIndex = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    Slot& slot = m_slots[slotIndex];
+    slot.alive = true;
+    slot.denseIndex = static_cast<uint32_t>(m_ids.size());
+    EntityId id = (static_cast<uint32_t>(slot.generation) << SLOT_BITS) | slotIndex;
+
+    m_posX.push_back(feetPosition.x);
+    m_posY.push_back(feetPosition.y);
+    m_posZ.push_back(feetPosition.z);
+    m_velX.push_back(0.0f);
+    m_velY.push_back(0.0f);
+    m_velZ.push_back(0.0f);
+    m_halfWidths.push_back(width * 0.5f);
+    m_heights.push_back(height);
+    m_ages.push_back(0.0f);
+    m_flags.push_back(0);
+    m_types.push_back(type);
+    m_ids.push_back(id);
+    return id;
+}
+
+void EntitySystem::despawn(EntityId id) {
+    if (!isAlive(id)) return;
+    Slot& slot = m_slots[id & SLOT_MASK];
+    size_t index = slot.denseIndex;
+    size_t last = m_ids.size() - 1;
+
+    // Move the last entity into the hole
+    if (index != last) {
+        m_posX[index] = m_posX[last];
+        m_posY[index] = m_posY[last];
+        m_posZ[index] = m_posZ[last];
+        m_velX[index] = m_velX[last];
+        m_velY[index] = m_velY[last];
+        m_velZ[index] = m_velZ[last];
+        m_halfWidths[index] = m_halfWidths[last];
+        m_heights[index] = m_heights[last];
+        m_ages[index] = m_ages[last];
+        m_flags[index] = m_flags[last];
+        m_types[index] = m_types[last];
+        m_ids[index] = m_ids[last];
+        m_slots[m_ids[index] & SLOT_MASK].denseIndex = static_cast<uint32_t>(index);
+    }
+    m_posX.pop_back(); m_posY.pop_back(); m_posZ.pop_back();
+    m_velX.pop_back(); m_velY.pop_back(); m_velZ.pop_back();
+    m_halfWidths.pop_back(); m_heights.pop_back(); m_ages.pop_back();
+    m_flags.pop_back(); m_types.pop_back(); m_ids.pop_back();
+
+    slot.alive = false;
+    slot.generation = static_cast<uint16_t>(((slot.generation + 1) & 0x0FFF) == 0 ? 1 : slot.generation + 1);
+    m_freeSlots.push_back(id & SLOT_MASK);
+}
+
+bool EntitySystem::isAlive(EntityId id) const {
+    uint32_t slotIndex = id & SLOT_MASK;
+    if (id == INVALID_ENTITY || slotIndex >= m_slots.size()) return false;
+    const Slot& slot = m_slots[slotIndex];
+    return slot.alive && slot.generation == (id >> SLOT_BITS);
+}
+
+glm::vec3 EntitySystem::getPosition(EntityId id) const {
+    size_t i = indexOf(id);
+    return glm::vec3(m_posX[i], m_posY[i], m_posZ[i]);
+}
+
+void EntitySystem::setPosition(EntityId id, const glm::vec3& feetPosition) {
+    size_t i = indexOf(id);
+    m_posX[i] = feetPosition.x;
+    m_posY[i] = feetPosition.y;
+    m_posZ[i] = feetPosition.z;
+}
+
+glm::vec3 EntitySystem::getVelocity(EntityId id) const {
+    size_t i = indexOf(id);
+    return glm::vec3(m_velX[i], m_velY[i], m_velZ[i]);
+}
+
+void EntitySystem::setVelocity(EntityId id, const glm::vec3& velocity) {
+    size_t i = indexOf(id);
+    m_velX[i] = velocity.x;
+    m_velY[i] = velocity.y;
+    m_velZ[i] = velocity.z;
+}
+
+void EntitySystem::setFlag(EntityId id, uint8_t flag, bool enabled) {
+    uint8_t& flags = m_flags[indexOf(id)];
+    flags = enabled ? (flags | flag) : (flags & ~flag);
+}
+
+AABB EntitySystem::boxAt(size_t i) const {
+    AABB box;
+    box.min = glm::vec3(m_posX[i] - m_halfWidths[i], m_posY[i], m_posZ[i] - m_halfWidths[i]);
+    box.max = glm::vec3(m_posX[i] + m_halfWidths[i], m_posY[i] + m_heights[i], m_posZ[i] + m_halfWidths[i]);
+    return box;
+}
+
+void EntitySystem::update(float dt, const World& world) {
+    size_t count = m_ids.size();
+    auto runBatches = [this, count, dt, &world](size_t begin, size_t end) {
+        integrate(begin, end, dt);
+        collide(begin, end, dt, world);
+    };
+    if (m_pool) {
+        m_pool->parallelFor(count, BATCH_SIZE, runBatches);
+    } else {
+        runBatches(0, count);
+    }
+    rebuildBroadphase();
+}
+
+void EntitySystem::integrate(size_t begin, size_t end, float dt) {
+    // Branch-free loops over contiguous floats so they vectorize
+    float* velX = m_velX.data();
+    float* velY = m_velY.data();
+    float* velZ = m_velZ.data();
+    const uint8_t* flags = m_flags.data();
+    float* ages = m_ages.data();
+    float friction = std::max(0.0f, 1.0f - GROUND_FRICTION * dt);
+
+    for (size_t i = begin; i < end; ++i) {
+        float gravityScale = (flags[i] & NO_GRAVITY) ? 0.0f : 1.0f;
+        velY[i] = std::max(velY[i] + GRAVITY * gravityScale * dt, TERMINAL_VELOCITY);
+    }
+    for (size_t i = begin; i < end; ++i) {
+        float slowdown = (flags[i] & ON_GROUND) ? friction : 1.0f;
+        velX[i] *= slowdown;
+        velZ[i] *= slowdown;
+    }
+    for (size_t i = begin; i < end; ++i) {
+        ages[i] += dt;
+    }
+}
+
+void EntitySystem::collide(size_t begin, size_t end, float dt, const World& world) {
+    for (size_t i = begin; i < end; ++i) {
+        glm::vec3 displacement(m_velX[i] * dt, m_velY[i] * dt, m_velZ[i] * dt);
+        if (m_flags[i] & NO_CLIP) {
+            m_posX[i] += displacement.x;
+            m_posY[i] += displacement.y;
+            m_posZ[i] += displacement.z;
+            m_flags[i] &= ~ON_GROUND;
+            continue;
+        }
+
+        float longest = std::max(std::fabs(displacement.x), std::max(std::fabs(displacement.y), std::fabs(displacement.z)));
+        int steps = std::max(1, static_cast<int>(std::ceil(longest / MAX_STEP)));
+        glm::vec3 stepDelta = displacement / static_cast<float>(steps);
+
+        bool onGround = false;
+        for (int step = 0; step < steps; ++step) {
+            // Vertical first, so walking off a ledge and landing behave like the old player physics
+            if (stepDelta.y != 0.0f && moveAxis(i, 1, stepDelta.y, world)) {
+                if (stepDelta.y < 0.0f) onGround = true;
+                stepDelta.y = 0.0f;
+                m_velY[i] = 0.0f;
+            }
+            if (stepDelta.x != 0.0f && moveAxis(i, 0, stepDelta.x, world)) {
+                stepDelta.x = 0.0f;
+                m_velX[i] = 0.0f;
+            }
+            if (stepDelta.z != 0.0f && moveAxis(i, 2, stepDelta.z, world)) {
+                stepDelta.z = 0.0f;
+                m_velZ[i] = 0.0f;
+            }
+        }
+        m_flags[i] = onGround ? (m_flags[i] | ON_GROUND) : (m_flags[i] & ~ON_GROUND);
+    }
+}
+
+bool EntitySystem::moveAxis(size_t i, int axis, float delta, const World& world) {
+    float* positions[3] = { m_posX.data(), m_posY.data(), m_posZ.data() };
+    positions[axis][i] += delta;
+
+    AABB box = boxAt(i);
+    glm::ivec3 minBlock(std::floor(box.min.x), std::floor(box.min.y), std::floor(box.min.z));
+    glm::ivec3 maxBlock(std::ceil(box.max.x) - 1, std::ceil(box.max.y) - 1, std::ceil(box.max.z) - 1);
+
+    // Blocks are read through the chunk holding the box's min corner and its neighbor links, one
+    // map lookup per move instead of one per block. A box wider than a chunk (or a corner in no
+    // chunk) falls back to World lookups.
+    const Chunk* chunk = world.getChunk(World::worldBlockToChunkCoord(minBlock));
+    glm::ivec3 origin = minBlock - World::worldBlockToLocalCoord(minBlock);
+    glm::ivec3 span = maxBlock - minBlock;
+    if (span.x >= Chunk::CHUNK_WIDTH || span.y >= Chunk::CHUNK_HEIGHT || span.z >= Chunk::CHUNK_DEPTH) chunk = nullptr;
+
+    // Nearest solid block face in the direction of movement
+    bool hit = false;
+    int nearest = delta > 0.0f ? maxBlock[axis] : minBlock[axis];
+    for (int y = minBlock.y; y <= maxBlock.y; ++y) {
+        for (int z = minBlock.z; z <= maxBlock.z; ++z) {
+            for (int x = minBlock.x; x <= maxBlock.x; ++x) {
+                BlockType block = chunk ? chunk->getBlockNear(x - origin.x, y - origin.y, z - origin.z)
+                                        : world.getBlock(glm::ivec3(x, y, z));
+                if (!isSolid(block)) continue;
+                int coord = axis == 0 ? x : axis == 1 ? y : z;
+                if (!hit || (delta > 0.0f ? coord < nearest : coord > nearest)) nearest = coord;
+                hit = true;
+            }
+        }
+    }
+    if (!hit) return false;
+
+    // Push back out so the box touches the block face
+    float boxMin = box.min[axis];
+    float boxMax = box.max[axis];
+    if (delta > 0.0f) {
+        positions[axis][i] -= boxMax - (static_cast<float>(nearest) - COLLISION_EPSILON);
+    } else {
+        positions[axis][i] += (static_cast<float>(nearest) + 1.0f + COLLISION_EPSILON) - boxMin;
+    }
+    return true;
+}
+
+void EntitySystem::rebuildBroadphase() {
+    m_broadphase.clear();
+    for (size_t i = 0; i < m_ids.size(); ++i) {
+        AABB box = boxAt(i);
+        m_broadphase.insert(m_ids[i], box.min, box.max);
+    }
+    m_broadphase.finalize();
+}
+
+void EntitySystem::queryAABB(const AABB& box, std::vector<EntityId>& outIds) const {
+    std::vector<uint32_t> candidates;
+    m_broadphase.query(box.min, box.max, candidates);
+    for (uint32_t id : candidates) {
+        if (!isAlive(id)) continue; // Despawned since the last update
+        AABB other = boxAt(indexOf(id));
+        if (other.min.x < box.max.x && other.max.x > box.min.x &&
+            other.min.y < box.max.y && other.max.y > box.min.y &&
+            other.min.z < box.max.z && other.max.z > box.min.z) {
+            outIds.push_back(id);
+        }
+    }
+}
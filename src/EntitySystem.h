@@ -0,0 +1,108 @@
+#ifndef ENTITYSYSTEM_H
+#define ENTITYSYSTEM_H
+
+#include "Camera.h" // For AABB
+#include "SpatialHash.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class World;
+class ThreadPool;
+
+enum class EntityType : uint8_t {
+    Player,
+    Mob,
+    Item // Dropped block
+};
+
+// Stable handle. Low 20 bits: slot, high 12 bits: generation (so stale handles of despawned
+// entities are detected). Never 0.
+using EntityId = uint32_t;
+const EntityId INVALID_ENTITY = 0;
+
+// All moving things in the world (the player, mobs, dropped items), stored as structure of arrays:
+// one tightly packed array per field, indexed by a dense index. Physics walks the arrays in
+// batches of BATCH_SIZE on the thread pool; the integration loops are plain float loops the
+// compiler can vectorize, and voxel collision only reads the World.
+// Despawning swaps the last entity into the hole, so dense indices change; keep EntityIds.
+class EntitySystem {
+public:
+    enum Flags : uint8_t {
+        ON_GROUND  = 1 << 0, // Set by update()
+        NO_GRAVITY = 1 << 1,
+        NO_CLIP    = 1 << 2  // Moves without colliding (flying player)
+    };
+
+    static const size_t BATCH_SIZE = 256;      // Entities per parallel batch
+    static const int MAX_ENTITIES = 1 << 20;   // Limited by the slot bits of EntityId
+
+    // Without a pool everything runs on the calling thread
+    explicit EntitySystem(ThreadPool* pool = nullptr);
+
+    // feetPosition is the bottom center of the entity's box. Returns INVALID_ENTITY when full.
+    EntityId spawn(EntityType type, const glm::vec3& feetPosition, float width, float height);
+    void despawn(EntityId id);
+    bool isAlive(EntityId id) const;
+    size_t getCount() const { return m_ids.size(); }
+
+    EntityType getType(EntityId id) const { return m_types[indexOf(id)]; }
+    glm::vec3 getPosition(EntityId id) const;
+    void setPosition(EntityId id, const glm::vec3& feetPosition);
+    glm::vec3 getVelocity(EntityId id) const;
+    void setVelocity(EntityId id, const glm::vec3& velocity);
+    bool hasFlag(EntityId id, uint8_t flag) const { return (m_flags[indexOf(id)] & flag) != 0; }
+    void setFlag(EntityId id, uint8_t flag, bool enabled);
+    float getAge(EntityId id) const { return m_ages[indexOf(id)]; } // Seconds since spawn
+    AABB getAABB(EntityId id) const { return boxAt(indexOf(id)); }
+
+    // Dense iteration, i in [0, getCount())
+    EntityId getIdAt(size_t i) const { return m_ids[i]; }
+    AABB getAABBAt(size_t i) const { return boxAt(i); }
+    EntityType getTypeAt(size_t i) const { return m_types[i]; }
+
+    // Gravity, movement and voxel collision for every entity, then rebuilds the broadphase.
+    // The World must not be modified while this runs.
+    void update(float dt, const World& world);
+
+    // Entities whose boxes overlap box. Uses the broadphase built by the last update(), so
+    // entities spawned since then aren't found yet.
+    void queryAABB(const AABB& box, std::vector<EntityId>& outIds) const;
+
+private:
+    struct Slot {
+        uint32_t denseIndex = 0;
+        uint16_t generation = 1;
+        bool alive = false;
+    };
+
+    size_t indexOf(EntityId id) const { return m_slots[id & SLOT_MASK].denseIndex; }
+    AABB boxAt(size_t i) const;
+
+    void integrate(size_t begin, size_t end, float dt);
+    void collide(size_t begin, size_t end, float dt, const World& world);
+    // Moves entity i along one axis and pushes it out of solid blocks. Returns true on contact.
+    bool moveAxis(size_t i, int axis, float delta, const World& world);
+    void rebuildBroadphase();
+
+    static const uint32_t SLOT_BITS = 20;
+    static const uint32_t SLOT_MASK = (1u << SLOT_BITS) - 1;
+
+    ThreadPool* m_pool;
+
+    // --- SoA entity data, all indexed by dense index ---
+    std::vector<float> m_posX, m_posY, m_posZ; // Feet (bottom center)
+    std::vector<float> m_velX, m_velY, m_velZ;
+    std::vector<float> m_halfWidths, m_heights; // Box: [pos - halfWidth, pos + halfWidth] x [posY, posY + height]
+    std::vector<float> m_ages;
+    std::vector<uint8_t> m_flags;
+    std::vector<EntityType> m_types;
+    std::vector<EntityId> m_ids;
+
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+
+    SpatialHash m_broadphase; // Items are EntityIds
+};
+
+#endif // ENTITYSYSTEM_H
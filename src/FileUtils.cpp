@@ -0,0 +1,25 @@
+#include "FileUtils.h"
+#include <filesystem>
+#include <fstream>
+
+bool writeFileAtomically(const std::string& path, const std::function<void(std::ostream& file)>& write) {
+    std::string temporaryPath = path + ".tmp";
+    std::error_code error;
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        write(file);
+        file.flush();
+        if (!file) {
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,13 @@
+#ifndef FILEUTILS_H
+#define FILEUTILS_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+// Writes path through a temporary file ("<path>.tmp") that is renamed into place once complete, so
+// a crash never leaves a truncated file under the real name. write fills the stream. Returns false
+// (and removes the temporary file) if it can't be created, a write fails or the rename fails.
+bool writeFileAtomically(const std::string& path, const std::function<void(std::ostream& file)>& write);
+
+#endif // FILEUTILS_H
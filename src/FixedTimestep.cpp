@@ -0,0 +1,27 @@
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(double ticksPerSecond, int maxTicksPerFrame)
+    : m_tickDuration(1.0 / ticksPerSecond), m_maxTicksPerFrame(maxTicksPerFrame),
+      m_accumulator(0.0), m_tickCount(0), m_droppedTicks(0) {}
+
+int FixedTimestep::advance(double frameSeconds) {
+    if (frameSeconds > 0.0) {
+        m_accumulator += frameSeconds;
+    }
+
+    int ticks = 0;
+    while (m_accumulator >= m_tickDuration) {
+        if (ticks == m_maxTicksPerFrame) {
+            // Too far behind: drop whole ticks but keep the fractional part so alpha stays smooth
+            while (m_accumulator >= m_tickDuration) {
+                m_accumulator -= m_tickDuration;
+                ++m_droppedTicks;
+            }
+            break;
+        }
+        m_accumulator -= m_tickDuration;
+        ++ticks;
+    }
+    m_tickCount += ticks;
+    return ticks;
+}
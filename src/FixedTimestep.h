@@ -0,0 +1,35 @@
+#ifndef FIXEDTIMESTEP_H
+#define FIXEDTIMESTEP_H
+
+#include <cstdint>
+
+// Accumulator for running the simulation at a fixed tick rate, independent of frame rate.
+// Each frame, feed the measured frame time to advance() and run the returned number of ticks
+// with getTickDuration() as the time step. getAlpha() then says how far the current frame lies
+// between the last two ticks, for interpolating what gets rendered.
+class FixedTimestep {
+public:
+    // maxTicksPerFrame bounds catch-up work after a long stall (window drag, breakpoint...).
+    // Time beyond that is dropped instead of making the next frames even slower.
+    explicit FixedTimestep(double ticksPerSecond = 60.0, int maxTicksPerFrame = 5);
+
+    // Adds frameSeconds of real time and returns how many ticks are due.
+    int advance(double frameSeconds);
+
+    double getTickDuration() const { return m_tickDuration; }
+    double getTicksPerSecond() const { return 1.0 / m_tickDuration; }
+    // Fraction of a tick accumulated but not simulated yet, in [0, 1)
+    float getAlpha() const { return static_cast<float>(m_accumulator / m_tickDuration); }
+    uint64_t getTickCount() const { return m_tickCount; }
+    // Ticks dropped so far because a frame wanted more than maxTicksPerFrame
+    uint64_t getDroppedTickCount() const { return m_droppedTicks; }
+
+private:
+    double m_tickDuration;
+    int m_maxTicksPerFrame;
+    double m_accumulator;
+    uint64_t m_tickCount;
+    uint64_t m_droppedTicks;
+};
+
+#endif // FIXEDTIMESTEP_H
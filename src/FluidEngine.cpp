@@ -0,0 +1,181 @@
+#include "FluidEngine.h"
+#include "World.h"
+#include "Chunk.h"
+#include <algorithm> // For std::min
+
+static const glm::ivec3 HORIZONTAL_OFFSETS[4] = {
+    glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1)
+};
+static const glm::ivec3 UP(0, 1, 0);
+
+FluidEngine::FluidEngine(World& world)
+    : m_world(world), m_edit(world), m_tickCount(0), m_applying(false) {}
+
+// Cells next to a fluid cell are read through the chunk's neighbor links (Chunk::resolveLocal)
+// rather than a World lookup each: a step evaluates every frontier cell and reads up to a dozen
+// cells around it, almost all in the same chunk.
+bool FluidEngine::isLoaded(const Chunk& chunk, glm::ivec3 local) {
+    const Chunk* owner = chunk.resolveLocal(local.x, local.y, local.z);
+    return owner && owner->isGenerated();
+}
+
+uint8_t FluidEngine::getLevel(const Chunk& chunk, glm::ivec3 local) {
+    const Chunk* owner = chunk.resolveLocal(local.x, local.y, local.z);
+    if (!owner) return SOURCE_LEVEL;
+    return owner->getFluidLevel(Chunk::localIndex(local.x, local.y, local.z));
+}
+
+void FluidEngine::wake(const glm::ivec3& worldBlockPos) {
+    for (std::unordered_set<glm::ivec3>& frontier : m_frontier) {
+        frontier.insert(worldBlockPos);
+        for (const glm::ivec3& offset : Chunk::NEIGHBOR_OFFSETS) {
+            frontier.insert(worldBlockPos + offset);
+        }
+    }
+}
+
+void FluidEngine::onBlockChanged(const glm::ivec3& worldBlockPos, BlockType newType) {
+    if (!m_applying) {
+        // Placed by someone else: a new fluid block is a source, whatever level the cell held before
+        Chunk* chunk = m_world.getChunk(World::worldBlockToChunkCoord(worldBlockPos));
+        if (chunk) {
+            glm::ivec3 local = World::worldBlockToLocalCoord(worldBlockPos);
+            chunk->setFluidLevel(Chunk::localIndex(local.x, local.y, local.z), SOURCE_LEVEL);
+        }
+    }
+
+    // Only changes in or next to fluid matter
+    bool nearFluid = isFluid(newType);
+    const Chunk* chunk = nearFluid ? nullptr : m_world.getChunk(World::worldBlockToChunkCoord(worldBlockPos));
+    glm::ivec3 local = World::worldBlockToLocalCoord(worldBlockPos);
+    for (int i = 0; i < 6 && chunk && !nearFluid; ++i) {
+        glm::ivec3 neighbor = local + Chunk::NEIGHBOR_OFFSETS[i];
+        nearFluid = isFluid(chunk->getBlockNear(neighbor.x, neighbor.y, neighbor.z));
+    }
+    if (nearFluid) {
+        wake(worldBlockPos);
+    }
+}
+
+void FluidEngine::tick() {
+    ++m_tickCount;
+    if (m_tickCount % WATER_TICK_INTERVAL == 0) step(BlockType::Water);
+    if (m_tickCount % LAVA_TICK_INTERVAL == 0) step(BlockType::Lava);
+}
+
+int FluidEngine::computeFlowLevel(const Chunk& chunk, const glm::ivec3& local, BlockType fluid) const {
+    glm::ivec3 above = local + UP;
+    if (chunk.getBlockNear(above.x, above.y, above.z) == fluid) {
+        return FALLING_LEVEL;
+    }
+
+    const int decay = fluid == BlockType::Lava ? 2 : 1;
+    int best = -1;
+    for (const glm::ivec3& offset : HORIZONTAL_OFFSETS) {
+        glm::ivec3 neighbor = local + offset;
+        if (chunk.getBlockNear(neighbor.x, neighbor.y, neighbor.z) != fluid) continue;
+
+        // A neighbor that can still fall doesn't spread sideways
+        glm::ivec3 belowNeighbor = neighbor - UP;
+        if (isLoaded(chunk, belowNeighbor)) {
+            BlockType below = chunk.getBlockNear(belowNeighbor.x, belowNeighbor.y, belowNeighbor.z);
+            if (below == BlockType::Air || (below == fluid && getLevel(chunk, belowNeighbor) != SOURCE_LEVEL)) continue;
+        }
+
+        uint8_t neighborLevel = getLevel(chunk, neighbor);
+        int feedLevel = (neighborLevel == SOURCE_LEVEL || neighborLevel >= FALLING_LEVEL) ? 0 : neighborLevel;
+        int level = feedLevel + decay;
+        if (level <= MAX_FLOW_LEVEL && (best < 0 || level < best)) {
+            best = level;
+        }
+    }
+    return best;
+}
+
+bool FluidEngine::evaluate(const glm::ivec3& pos, BlockType fluid, FluidChange& outChange) const {
+    const Chunk* chunk = m_world.getChunk(World::worldBlockToChunkCoord(pos));
+    if (!chunk || !chunk->isGenerated()) return false;
+    glm::ivec3 local = World::worldBlockToLocalCoord(pos);
+    BlockType type = chunk->getBlock(local.x, local.y, local.z);
+    BlockType otherFluid = fluid == BlockType::Water ? BlockType::Lava : BlockType::Water;
+
+    if (type == fluid) {
+        // Lava touched by water hardens (checked in the lava step only, water doesn't care)
+        if (fluid == BlockType::Lava) {
+            for (int i = 0; i < 6; ++i) {
+                glm::ivec3 neighbor = local + Chunk::NEIGHBOR_OFFSETS[i];
+                if (i != 3 && chunk->getBlockNear(neighbor.x, neighbor.y, neighbor.z) == BlockType::Water) { // Not from below
+                    outChange = {BlockType::Stone, 0};
+                    return true;
+                }
+            }
+        }
+
+        uint8_t level = chunk->getFluidLevel(Chunk::localIndex(local.x, local.y, local.z));
+        if (level == SOURCE_LEVEL) return false; // Sources never change by themselves
+        int flowLevel = computeFlowLevel(*chunk, local, fluid);
+        if (flowLevel < 0) {
+            outChange = {BlockType::Air, 0}; // Lost its feed: dries up
+            return true;
+        }
+        if (flowLevel != level) {
+            outChange = {fluid, static_cast<uint8_t>(flowLevel)};
+            return true;
+        }
+        return false;
+    }
+
+    if (type == BlockType::Air || type == otherFluid) {
+        int flowLevel = computeFlowLevel(*chunk, local, fluid);
+        if (flowLevel < 0) return false;
+        if (type == otherFluid || computeFlowLevel(*chunk, local, otherFluid) >= 0) {
+            outChange = {BlockType::Stone, 0}; // Water and lava meet
+        } else {
+            outChange = {fluid, static_cast<uint8_t>(flowLevel)};
+        }
+        return true;
+    }
+    return false; // Fluids only replace air
+}
+
+void FluidEngine::step(BlockType fluid) {
+    std::unordered_set<glm::ivec3>& frontier = m_frontier[frontierIndex(fluid)];
+    if (frontier.empty()) return;
+
+    // 1. Evaluate every frontier cell against the world as it is now
+    m_stepCells.assign(frontier.begin(), frontier.end());
+    frontier.clear();
+    m_changes.clear();
+    for (const glm::ivec3& pos : m_stepCells) {
+        FluidChange change;
+        if (evaluate(pos, fluid, change)) {
+            m_changes[pos] = change;
+        }
+    }
+    if (m_changes.empty()) return; // Settled
+
+    // 2. Write all type changes as one batch: one remesh per touched chunk. Listeners (lighting,
+    //    network, this engine's onBlockChanged) see each changed block as usual.
+    m_typeEdits.clear();
+    for (const auto& pair : m_changes) {
+        if (m_world.getBlock(pair.first) != pair.second.type) {
+            m_typeEdits.push_back({pair.first, pair.second.type});
+        }
+    }
+    m_applying = true;
+    m_edit.applyEdits(m_typeEdits);
+    m_applying = false;
+
+    // 3. Levels. A level-only change keeps the block type, so flag its chunk and wake it by hand.
+    for (const auto& pair : m_changes) {
+        Chunk* chunk = m_world.getChunk(World::worldBlockToChunkCoord(pair.first));
+        if (!chunk) continue;
+        glm::ivec3 local = World::worldBlockToLocalCoord(pair.first);
+        int index = Chunk::localIndex(local.x, local.y, local.z);
+        if (chunk->getFluidLevel(index) != pair.second.level) {
+            chunk->setFluidLevel(index, pair.second.level);
+            chunk->setNeedsMeshBuild(true);
+            wake(pair.first);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef FLUIDENGINE_H
+#define FLUIDENGINE_H
+
+#include "BlockType.h"
+#include "WorldEdit.h"
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp> // For std::hash<glm::ivec3>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Chunk;
+class World;
+
+// Cellular water and lava.
+//
+// Levels are stored per block in a nibble (Chunk::getFluidLevel):
+//   0      source block (what the player places)
+//   1..7   flowing, the distance from the feeding source (lava flows in steps of 2)
+//   8      falling (fed from above)
+// Fluid falls first and only spreads sideways on top of something solid or a source.
+//
+// Each fluid steps at its own rate and only looks at its frontier: the cells that changed in
+// its previous step, plus their neighbors. Everything else is assumed settled, so a lake at
+// rest costs nothing. A step reads the world as it was at the start of the step, then writes
+// all resulting changes in one batch (WorldEdit), so each touched chunk remeshes once per step.
+class FluidEngine {
+public:
+    static const uint8_t SOURCE_LEVEL = 0;
+    static const uint8_t MAX_FLOW_LEVEL = 7;
+    static const uint8_t FALLING_LEVEL = 8;
+
+    static const int WATER_TICK_INTERVAL = 5;  // Simulation ticks between water steps (12 per second at 60 TPS)
+    static const int LAVA_TICK_INTERVAL = 30;  // Lava is slow
+
+    explicit FluidEngine(World& world);
+
+    // Called once per simulation tick
+    void tick();
+
+    // Wakes up fluid around a block changed by anything (player, other systems, this engine)
+    void onBlockChanged(const glm::ivec3& worldBlockPos, BlockType newType);
+
+    size_t getFrontierSize() const { return m_frontier[0].size() + m_frontier[1].size(); }
+
+private:
+    struct FluidChange {
+        BlockType type;
+        uint8_t level;
+    };
+
+    // One step of one fluid over its frontier
+    void step(BlockType fluid);
+    // New state for a cell, or false if it stays as it is
+    bool evaluate(const glm::ivec3& pos, BlockType fluid, FluidChange& outChange) const;
+    // Level that fluid would have at local (in chunk) when fed by its neighbors, or -1 if none reaches it
+    int computeFlowLevel(const Chunk& chunk, const glm::ivec3& local, BlockType fluid) const;
+
+    // Cells at local coordinates of chunk that may lie in a neighbor chunk (see Chunk::resolveLocal)
+    static bool isLoaded(const Chunk& chunk, glm::ivec3 local);
+    static uint8_t getLevel(const Chunk& chunk, glm::ivec3 local);
+    void wake(const glm::ivec3& worldBlockPos); // Adds a cell and its neighbors to both frontiers
+
+    static int frontierIndex(BlockType fluid) { return fluid == BlockType::Water ? 0 : 1; }
+
+    World& m_world;
+    WorldEdit m_edit;
+    uint64_t m_tickCount;
+    std::unordered_set<glm::ivec3> m_frontier[2]; // Water, lava
+    std::vector<glm::ivec3> m_stepCells;          // Frontier being processed (scratch)
+    std::unordered_map<glm::ivec3, FluidChange> m_changes; // Changes of the current step (scratch)
+    std::vector<BlockEdit> m_typeEdits;           // Scratch
+    bool m_applying;                              // True while our own edits are being written
+};
+
+#endif // FLUIDENGINE_H
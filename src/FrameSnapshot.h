@@ -0,0 +1,52 @@
+#ifndef FRAMESNAPSHOT_H
+#define FRAMESNAPSHOT_H
+
+#include "ChunkMesh.h"
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+// Everything the render thread needs to draw a frame, published by the simulation thread.
+// Snapshots are immutable once published; meshes are shared read-only.
+struct FrameSnapshot {
+    struct ChunkDrawItem {
+        glm::ivec3 chunkCoord;
+        ChunkMeshPtr mesh;
+    };
+
+    struct OverlayLine {
+        std::string text;
+        glm::vec3 color;
+    };
+
+    uint64_t sequence = 0; // Increases with every published snapshot; 0 = nothing published yet
+
+    // Camera. The render thread interpolates between the previous and current tick positions
+    // using its own clock, so it keeps moving smoothly between snapshots.
+    glm::vec3 previousTickPosition = glm::vec3(0.0f);
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+    double tickTime = 0.0;     // glfwGetTime() at which cameraPosition became current
+    double tickDuration = 1.0; // Seconds per simulation tick
+    glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
+    glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+
+    int windowWidth = 0;
+    int windowHeight = 0;
+
+    std::vector<ChunkDrawItem> chunks; // Chunks with a non-empty mesh
+
+    struct EntityBox {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+    std::vector<EntityBox> entities; // Everything except the local player
+
+    bool showOutline = false;
+    glm::ivec3 outlinePos = glm::ivec3(0);
+
+    bool showOverlay = false;                // F3 screen
+    std::vector<OverlayLine> overlayLines;   // Drawn top to bottom below the render thread's own stats
+};
+
+#endif // FRAMESNAPSHOT_H
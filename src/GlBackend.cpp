@@ -0,0 +1,95 @@
+#include "GlBackend.h"
+
+// --- OpenGlBackend ---
+
+void OpenGlBackend::clear(float red, float green, float blue, float alpha, GLbitfield mask) {
+    glClearColor(red, green, blue, alpha);
+    glClear(mask);
+}
+
+void OpenGlBackend::useProgram(GLuint program) { glUseProgram(program); }
+void OpenGlBackend::bindVertexArray(GLuint vao) { glBindVertexArray(vao); }
+void OpenGlBackend::bindTexture2D(GLuint texture) { glBindTexture(GL_TEXTURE_2D, texture); }
+
+void OpenGlBackend::setCapability(GLenum capability, bool enabled) {
+    if (enabled) glEnable(capability);
+    else glDisable(capability);
+}
+
+void OpenGlBackend::polygonMode(GLenum mode) { glPolygonMode(GL_FRONT_AND_BACK, mode); }
+void OpenGlBackend::lineWidth(float width) { glLineWidth(width); }
+
+GLint OpenGlBackend::getUniformLocation(GLuint program, const char* name) {
+    return glGetUniformLocation(program, name);
+}
+
+void OpenGlBackend::uniformMatrix4(GLint location, const float* value) {
+    glUniformMatrix4fv(location, 1, GL_FALSE, value);
+}
+
+void OpenGlBackend::uniform3(GLint location, const float* value) { glUniform3fv(location, 1, value); }
+void OpenGlBackend::uniform1i(GLint location, GLint value) { glUniform1i(location, value); }
+
+void OpenGlBackend::uploadUniformBuffer(GLuint buffer, const void* data, size_t size) {
+    // Uses the generic binding point, which leaves the indexed bindings the shaders read alone
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(size), data, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void OpenGlBackend::bindUniformBufferRange(GLuint bindingPoint, GLuint buffer, size_t offset, size_t size) {
+    glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+}
+
+void OpenGlBackend::drawArrays(GLenum mode, GLint first, GLsizei count) { glDrawArrays(mode, first, count); }
+
+void OpenGlBackend::drawElements(GLenum mode, GLsizei count, size_t offset) {
+    glDrawElements(mode, count, GL_UNSIGNED_INT, reinterpret_cast<const void*>(offset));
+}
+
+// --- RecordingGlBackend ---
+
+void RecordingGlBackend::record(CallType type, int64_t a, int64_t b, int64_t c) {
+    m_calls.push_back({type, {a, b, c}});
+}
+
+size_t RecordingGlBackend::getCallCount(CallType type) const {
+    size_t count = 0;
+    for (const Call& call : m_calls) {
+        if (call.type == type) ++count;
+    }
+    return count;
+}
+
+void RecordingGlBackend::clear(float, float, float, float, GLbitfield mask) { record(CallType::Clear, mask); }
+void RecordingGlBackend::useProgram(GLuint program) { record(CallType::UseProgram, program); }
+void RecordingGlBackend::bindVertexArray(GLuint vao) { record(CallType::BindVertexArray, vao); }
+void RecordingGlBackend::bindTexture2D(GLuint texture) { record(CallType::BindTexture2D, texture); }
+void RecordingGlBackend::setCapability(GLenum capability, bool enabled) { record(CallType::SetCapability, capability, enabled ? 1 : 0); }
+void RecordingGlBackend::polygonMode(GLenum mode) { record(CallType::PolygonMode, mode); }
+void RecordingGlBackend::lineWidth(float width) { record(CallType::LineWidth, static_cast<int64_t>(width * 1000.0f)); }
+
+GLint RecordingGlBackend::getUniformLocation(GLuint program, const char* name) {
+    record(CallType::GetUniformLocation, program);
+    auto inserted = m_uniformLocations.emplace(std::make_pair(program, std::string(name)),
+                                               static_cast<GLint>(m_uniformLocations.size()));
+    return inserted.first->second;
+}
+
+void RecordingGlBackend::uniformMatrix4(GLint location, const float*) { record(CallType::UniformMatrix4, location); }
+void RecordingGlBackend::uniform3(GLint location, const float*) { record(CallType::Uniform3, location); }
+void RecordingGlBackend::uniform1i(GLint location, GLint value) { record(CallType::Uniform1i, location, value); }
+
+void RecordingGlBackend::uploadUniformBuffer(GLuint buffer, const void*, size_t size) {
+    record(CallType::UploadUniformBuffer, buffer, static_cast<int64_t>(size));
+}
+
+void RecordingGlBackend::bindUniformBufferRange(GLuint bindingPoint, GLuint buffer, size_t offset, size_t) {
+    record(CallType::BindUniformBufferRange, bindingPoint, buffer, static_cast<int64_t>(offset));
+}
+
+void RecordingGlBackend::drawArrays(GLenum mode, GLint first, GLsizei count) { record(CallType::DrawArrays, mode, first, count); }
+
+void RecordingGlBackend::drawElements(GLenum mode, GLsizei count, size_t offset) {
+    record(CallType::DrawElements, mode, count, static_cast<int64_t>(offset));
+}
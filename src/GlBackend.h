@@ -0,0 +1,102 @@
+#ifndef GLBACKEND_H
+#define GLBACKEND_H
+
+#include <glad/glad.h> // For GL types and enums only; RecordingGlBackend never calls into GL
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// The GL calls issued while drawing a frame (state changes, uniforms, draws), behind an interface
+// so the render command layer can run without a GPU. OpenGlBackend forwards to OpenGL;
+// RecordingGlBackend only logs the calls, which lets tools count them (see RenderQueueCheck).
+//
+// Resource creation and upload (buffers, textures, shaders) still call GL directly.
+class GlBackend {
+public:
+    virtual ~GlBackend() {}
+
+    virtual void clear(float red, float green, float blue, float alpha, GLbitfield mask) = 0;
+    virtual void useProgram(GLuint program) = 0;
+    virtual void bindVertexArray(GLuint vao) = 0;
+    virtual void bindTexture2D(GLuint texture) = 0;
+    virtual void setCapability(GLenum capability, bool enabled) = 0; // glEnable / glDisable
+    virtual void polygonMode(GLenum mode) = 0;                       // For GL_FRONT_AND_BACK
+    virtual void lineWidth(float width) = 0;
+    virtual GLint getUniformLocation(GLuint program, const char* name) = 0;
+    virtual void uniformMatrix4(GLint location, const float* value) = 0;
+    virtual void uniform3(GLint location, const float* value) = 0;
+    virtual void uniform1i(GLint location, GLint value) = 0;
+    // Replaces the whole contents of a uniform buffer (orphaning the old storage)
+    virtual void uploadUniformBuffer(GLuint buffer, const void* data, size_t size) = 0;
+    virtual void bindUniformBufferRange(GLuint bindingPoint, GLuint buffer, size_t offset, size_t size) = 0;
+    virtual void drawArrays(GLenum mode, GLint first, GLsizei count) = 0;
+    // Indices are GL_UNSIGNED_INT; offset is in bytes into the bound element buffer
+    virtual void drawElements(GLenum mode, GLsizei count, size_t offset) = 0;
+};
+
+class OpenGlBackend : public GlBackend {
+public:
+    void clear(float red, float green, float blue, float alpha, GLbitfield mask) override;
+    void useProgram(GLuint program) override;
+    void bindVertexArray(GLuint vao) override;
+    void bindTexture2D(GLuint texture) override;
+    void setCapability(GLenum capability, bool enabled) override;
+    void polygonMode(GLenum mode) override;
+    void lineWidth(float width) override;
+    GLint getUniformLocation(GLuint program, const char* name) override;
+    void uniformMatrix4(GLint location, const float* value) override;
+    void uniform3(GLint location, const float* value) override;
+    void uniform1i(GLint location, GLint value) override;
+    void uploadUniformBuffer(GLuint buffer, const void* data, size_t size) override;
+    void bindUniformBufferRange(GLuint bindingPoint, GLuint buffer, size_t offset, size_t size) override;
+    void drawArrays(GLenum mode, GLint first, GLsizei count) override;
+    void drawElements(GLenum mode, GLsizei count, size_t offset) override;
+};
+
+class RecordingGlBackend : public GlBackend {
+public:
+    enum class CallType {
+        Clear, UseProgram, BindVertexArray, BindTexture2D, SetCapability, PolygonMode, LineWidth,
+        GetUniformLocation, UniformMatrix4, Uniform3, Uniform1i, UploadUniformBuffer, BindUniformBufferRange,
+        DrawArrays, DrawElements
+    };
+
+    // One recorded call. Arguments that don't fit (matrices, names) are not kept.
+    struct Call {
+        CallType type;
+        int64_t args[3];
+    };
+
+    void clear(float red, float green, float blue, float alpha, GLbitfield mask) override;
+    void useProgram(GLuint program) override;
+    void bindVertexArray(GLuint vao) override;
+    void bindTexture2D(GLuint texture) override;
+    void setCapability(GLenum capability, bool enabled) override;
+    void polygonMode(GLenum mode) override;
+    void lineWidth(float width) override;
+    // Hands out a distinct location per (program, name), stable across calls
+    GLint getUniformLocation(GLuint program, const char* name) override;
+    void uniformMatrix4(GLint location, const float* value) override;
+    void uniform3(GLint location, const float* value) override;
+    void uniform1i(GLint location, GLint value) override;
+    void uploadUniformBuffer(GLuint buffer, const void* data, size_t size) override;
+    void bindUniformBufferRange(GLuint bindingPoint, GLuint buffer, size_t offset, size_t size) override;
+    void drawArrays(GLenum mode, GLint first, GLsizei count) override;
+    void drawElements(GLenum mode, GLsizei count, size_t offset) override;
+
+    const std::vector<Call>& getCalls() const { return m_calls; }
+    size_t getCallCount() const { return m_calls.size(); }
+    size_t getCallCount(CallType type) const;
+    void reset() { m_calls.clear(); }
+
+private:
+    void record(CallType type, int64_t a = 0, int64_t b = 0, int64_t c = 0);
+
+    std::vector<Call> m_calls;
+    std::map<std::pair<GLuint, std::string>, GLint> m_uniformLocations;
+};
+
+#endif // GLBACKEND_H
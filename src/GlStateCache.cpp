@@ -0,0 +1,89 @@
+#include "GlStateCache.h"
+#include <glm/gtc/type_ptr.hpp> // For glm::value_ptr
+
+GlStateCache::GlStateCache(GlBackend& backend) : m_backend(backend), m_issued(0), m_skipped(0) {
+    invalidate();
+}
+
+void GlStateCache::invalidate() {
+    m_program = 0;                m_programKnown = false;
+    m_vao = 0;                    m_vaoKnown = false;
+    m_texture2D = 0;              m_texture2DKnown = false;
+    m_depthTest = false;          m_depthTestKnown = false;
+    m_blend = false;              m_blendKnown = false;
+    m_polygonMode = GL_FILL;      m_polygonModeKnown = false;
+    m_lineWidth = 1.0f;           m_lineWidthKnown = false;
+    for (int i = 0; i < MAX_UNIFORM_BINDINGS; ++i) m_uniformBindingKnown[i] = false;
+    m_matrixUniforms.clear();
+    m_intUniforms.clear();
+}
+
+void GlStateCache::useProgram(GLuint program) {
+    if (update(m_program, program, m_programKnown)) m_backend.useProgram(program);
+}
+
+void GlStateCache::bindVertexArray(GLuint vao) {
+    if (update(m_vao, vao, m_vaoKnown)) m_backend.bindVertexArray(vao);
+}
+
+void GlStateCache::bindTexture2D(GLuint texture) {
+    if (update(m_texture2D, texture, m_texture2DKnown)) m_backend.bindTexture2D(texture);
+}
+
+void GlStateCache::setEnabled(GLenum capability, bool enabled) {
+    bool changed;
+    if (capability == GL_DEPTH_TEST) {
+        changed = update(m_depthTest, enabled, m_depthTestKnown);
+    } else if (capability == GL_BLEND) {
+        changed = update(m_blend, enabled, m_blendKnown);
+    } else {
+        changed = true; // Untracked
+        ++m_issued;
+    }
+    if (changed) m_backend.setCapability(capability, enabled);
+}
+
+void GlStateCache::setPolygonMode(GLenum mode) {
+    if (update(m_polygonMode, mode, m_polygonModeKnown)) m_backend.polygonMode(mode);
+}
+
+void GlStateCache::setLineWidth(float width) {
+    if (update(m_lineWidth, width, m_lineWidthKnown)) m_backend.lineWidth(width);
+}
+
+void GlStateCache::setUniformMatrix4(GLint location, const glm::mat4& value) {
+    if (location < 0) return;
+    uint64_t key = uniformKey(m_program, location);
+    auto it = m_matrixUniforms.find(key);
+    if (it != m_matrixUniforms.end() && it->second == value) {
+        ++m_skipped;
+        return;
+    }
+    m_matrixUniforms[key] = value;
+    ++m_issued;
+    m_backend.uniformMatrix4(location, glm::value_ptr(value));
+}
+
+void GlStateCache::setUniformInt(GLint location, GLint value) {
+    if (location < 0) return;
+    auto inserted = m_intUniforms.emplace(uniformKey(m_program, location), value);
+    if (!inserted.second && inserted.first->second == value) {
+        ++m_skipped;
+        return;
+    }
+    inserted.first->second = value;
+    ++m_issued;
+    m_backend.uniform1i(location, value);
+}
+
+void GlStateCache::bindUniformBufferRange(GLuint bindingPoint, GLuint buffer, size_t offset, size_t size) {
+    if (bindingPoint >= static_cast<GLuint>(MAX_UNIFORM_BINDINGS)) {
+        ++m_issued;
+        m_backend.bindUniformBufferRange(bindingPoint, buffer, offset, size);
+        return;
+    }
+    UniformBinding binding = {buffer, offset, size};
+    if (update(m_uniformBindings[bindingPoint], binding, m_uniformBindingKnown[bindingPoint])) {
+        m_backend.bindUniformBufferRange(bindingPoint, buffer, offset, size);
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef GLSTATECACHE_H
+#define GLSTATECACHE_H
+
+#include "GlBackend.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+
+// Shadow copy of the GL state the renderers change per draw. Setting a value that is already
+// current is dropped instead of reaching the driver. Everything drawn on the render thread has to
+// go through one cache, otherwise its copy goes stale; call invalidate() after raw GL state changes.
+class GlStateCache {
+public:
+    explicit GlStateCache(GlBackend& backend);
+
+    GlBackend& getBackend() { return m_backend; }
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindTexture2D(GLuint texture);
+    void setEnabled(GLenum capability, bool enabled); // GL_DEPTH_TEST and GL_BLEND are tracked, others pass through
+    void setPolygonMode(GLenum mode);
+    void setLineWidth(float width);
+    // Uniform of the current program. Values are remembered per program, so switching back and forth keeps them.
+    void setUniformMatrix4(GLint location, const glm::mat4& value);
+    void setUniformInt(GLint location, GLint value);
+    // Indexed uniform buffer binding (glBindBufferRange), points below MAX_UNIFORM_BINDINGS are tracked
+    void bindUniformBufferRange(GLuint bindingPoint, GLuint buffer, size_t offset, size_t size);
+
+    // Forgets every cached value, so the next set of each reaches GL
+    void invalidate();
+    // Call before deleting a VAO: GL unbinds a deleted VAO, and a new one may get the same name
+    void onVertexArrayDeleted(GLuint vao) { if (m_vao == vao) m_vaoKnown = false; }
+
+    // Calls that reached the backend / were dropped as redundant since the last resetCounters()
+    uint64_t getIssuedCount() const { return m_issued; }
+    uint64_t getSkippedCount() const { return m_skipped; }
+    void resetCounters() { m_issued = 0; m_skipped = 0; }
+
+    static const int MAX_UNIFORM_BINDINGS = 4;
+
+private:
+    struct UniformBinding {
+        GLuint buffer;
+        size_t offset;
+        size_t size;
+        bool operator==(const UniformBinding& other) const {
+            return buffer == other.buffer && offset == other.offset && size == other.size;
+        }
+    };
+
+    static uint64_t uniformKey(GLuint program, GLint location) {
+        return (static_cast<uint64_t>(program) << 32) | static_cast<uint32_t>(location);
+    }
+
+    // Returns true (and counts the call) if the value changes
+    template <typename T>
+    bool update(T& cached, const T& value, bool& known) {
+        if (known && cached == value) { ++m_skipped; return false; }
+        cached = value;
+        known = true;
+        ++m_issued;
+        return true;
+    }
+
+    GlBackend& m_backend;
+
+    GLuint m_program;          bool m_programKnown;
+    GLuint m_vao;              bool m_vaoKnown;
+    GLuint m_texture2D;        bool m_texture2DKnown;
+    bool m_depthTest;          bool m_depthTestKnown;
+    bool m_blend;              bool m_blendKnown;
+    GLenum m_polygonMode;      bool m_polygonModeKnown;
+    float m_lineWidth;         bool m_lineWidthKnown;
+    UniformBinding m_uniformBindings[MAX_UNIFORM_BINDINGS];
+    bool m_uniformBindingKnown[MAX_UNIFORM_BINDINGS];
+    // uniformKey(program, location) -> last value uploaded
+    std::unordered_map<uint64_t, glm::mat4> m_matrixUniforms;
+    std::unordered_map<uint64_t, GLint> m_intUniforms;
+
+    uint64_t m_issued;
+    uint64_t m_skipped;
+};
+
+#endif // GLSTATECACHE_H
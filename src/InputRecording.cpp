@@ -0,0 +1,106 @@
+#include "InputRecording.h"
+#include <iostream>
+
+static const uint32_t FILE_MAGIC = 0x43524E49; // "INRC"
+static const uint32_t FILE_VERSION = 1;        // Bump when the frame layout changes
+static const uint32_t MAX_EVENTS_PER_FRAME = 1 << 16; // Anything more means a damaged file
+
+// File layout: magic, version, tick rate, then per frame: time, ticks, keys, event count and the
+// events (type, offsets, button, action). Native endianness, like the mesh cache.
+template <typename T>
+static void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+bool InputRecorder::open(const std::string& path, double ticksPerSecond) {
+    close();
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        std::cerr << "InputRecorder Error: Can't write " << path << std::endl;
+        return false;
+    }
+    writeValue(m_file, FILE_MAGIC);
+    writeValue(m_file, FILE_VERSION);
+    writeValue(m_file, ticksPerSecond);
+    m_pendingEvents.clear();
+    m_frameCount = 0;
+    return true;
+}
+
+void InputRecorder::close() {
+    if (m_file.is_open()) m_file.close();
+}
+
+void InputRecorder::addMouseMove(float xOffset, float yOffset) {
+    if (!isOpen()) return;
+    InputEvent event;
+    event.type = InputEvent::MouseMove;
+    event.xOffset = xOffset;
+    event.yOffset = yOffset;
+    m_pendingEvents.push_back(event);
+}
+
+void InputRecorder::addMouseButton(int button, int action) {
+    if (!isOpen()) return;
+    InputEvent event;
+    event.type = InputEvent::MouseButton;
+    event.button = button;
+    event.action = action;
+    m_pendingEvents.push_back(event);
+}
+
+void InputRecorder::endFrame(double time, int ticks, uint32_t keys) {
+    if (!isOpen()) return;
+    writeValue(m_file, time);
+    writeValue(m_file, static_cast<int32_t>(ticks));
+    writeValue(m_file, keys);
+    writeValue(m_file, static_cast<uint32_t>(m_pendingEvents.size()));
+    for (const InputEvent& event : m_pendingEvents) {
+        writeValue(m_file, event.type);
+        writeValue(m_file, event.xOffset);
+        writeValue(m_file, event.yOffset);
+        writeValue(m_file, event.button);
+        writeValue(m_file, event.action);
+    }
+    m_pendingEvents.clear();
+    ++m_frameCount;
+}
+
+bool InputReplay::load(const std::string& path) {
+    m_frames.clear();
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "InputReplay Error: Can't read " << path << std::endl;
+        return false;
+    }
+    uint32_t magic = 0, version = 0;
+    if (!readValue(file, magic) || !readValue(file, version) || !readValue(file, m_ticksPerSecond) ||
+        magic != FILE_MAGIC || version != FILE_VERSION || !(m_ticksPerSecond > 0.0)) {
+        std::cerr << "InputReplay Error: " << path << " is not an input recording (or from another version)" << std::endl;
+        return false;
+    }
+
+    // A session killed mid-write ends in a partial frame; everything before it still replays
+    InputFrame frame;
+    uint32_t eventCount = 0;
+    while (readValue(file, frame.time) && readValue(file, frame.ticks) && readValue(file, frame.keys) &&
+           readValue(file, eventCount)) {
+        if (frame.ticks < 0 || eventCount > MAX_EVENTS_PER_FRAME) break;
+        frame.events.resize(eventCount);
+        bool complete = true;
+        for (InputEvent& event : frame.events) {
+            complete = readValue(file, event.type) && readValue(file, event.xOffset) && readValue(file, event.yOffset) &&
+                       readValue(file, event.button) && readValue(file, event.action) &&
+                       (event.type == InputEvent::MouseMove || event.type == InputEvent::MouseButton);
+            if (!complete) break;
+        }
+        if (!complete) break;
+        m_frames.push_back(frame);
+    }
+    return true;
+}
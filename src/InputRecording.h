@@ -0,0 +1,81 @@
+#ifndef INPUTRECORDING_H
+#define INPUTRECORDING_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Keys the main loop reads, as bits of InputFrame::keys
+enum InputKey : uint32_t {
+    KEY_W = 1u << 0,
+    KEY_A = 1u << 1,
+    KEY_S = 1u << 2,
+    KEY_D = 1u << 3,
+    KEY_SPACE = 1u << 4,
+    KEY_LEFT_SHIFT = 1u << 5,
+    KEY_F3 = 1u << 6,
+    KEY_F4 = 1u << 7,
+    KEY_G = 1u << 8,
+    KEY_1 = 1u << 9, // KEY_1 .. KEY_1 << 5 are the number keys 1-6
+};
+
+// Input that arrives through callbacks, in arrival order
+struct InputEvent {
+    enum Type : uint8_t { MouseMove, MouseButton } type;
+    float xOffset = 0.0f; // MouseMove: offsets as passed to Camera::ProcessMouseMovement
+    float yOffset = 0.0f;
+    int32_t button = 0;   // MouseButton: GLFW button and action
+    int32_t action = 0;
+};
+
+// Everything one main loop iteration consumed: the callback events, the keys held when
+// processInput ran and how many simulation ticks followed
+struct InputFrame {
+    double time = 0.0; // Seconds since the recording started
+    int32_t ticks = 0;
+    uint32_t keys = 0;
+    std::vector<InputEvent> events;
+};
+
+// Writes the frames of a live session to a file, one frame per main loop iteration.
+//
+// Replaying a recording runs the same ticks with the same input in the same order, so the
+// simulation follows the same path no matter how fast the machine is. Chunk work is part of that:
+// a replay gives the ChunkScheduler a fixed number of jobs per tick instead of its time budget
+// (see ChunkScheduler::setJobLimit), so the chunks under a walking player or mob exist at the same
+// tick on every machine. A benchmark measures how long those ticks take.
+class InputRecorder {
+public:
+    bool open(const std::string& path, double ticksPerSecond);
+    bool isOpen() const { return m_file.is_open(); }
+    void close();
+
+    // Callbacks queue their events; endFrame() writes them with the rest of the frame
+    void addMouseMove(float xOffset, float yOffset);
+    void addMouseButton(int button, int action);
+    void endFrame(double time, int ticks, uint32_t keys);
+
+    uint64_t getFrameCount() const { return m_frameCount; }
+
+private:
+    std::ofstream m_file;
+    std::vector<InputEvent> m_pendingEvents;
+    uint64_t m_frameCount = 0;
+};
+
+// A recording loaded for replay
+class InputReplay {
+public:
+    // False (with a message on stderr) if the file is missing, damaged or from another version
+    bool load(const std::string& path);
+
+    double getTicksPerSecond() const { return m_ticksPerSecond; }
+    const std::vector<InputFrame>& getFrames() const { return m_frames; }
+
+private:
+    double m_ticksPerSecond = 0.0;
+    std::vector<InputFrame> m_frames;
+};
+
+#endif // INPUTRECORDING_H
@@ -0,0 +1,143 @@
+#include "InterestManager.h"
+#include "Chunk.h"
+#include <algorithm> // For std::sort, std::find
+
+void InterestManager::addObserver(ObserverId id, const glm::vec3& cameraPosition, int viewRadius, int verticalRadius, InterestDelta& outDelta) {
+    outDelta.entered.clear();
+    outDelta.left.clear();
+    if (m_observers.count(id)) {
+        InterestDelta removed;
+        removeObserver(id, removed);
+    }
+    Observer observer{cameraToChunkCoord(cameraPosition), std::max(0, viewRadius), std::max(0, verticalRadius)};
+    applyBox(id, observer, false, observer, outDelta);
+    m_observers[id] = observer;
+}
+
+void InterestManager::removeObserver(ObserverId id, InterestDelta& outDelta) {
+    outDelta.entered.clear();
+    outDelta.left.clear();
+    auto it = m_observers.find(id);
+    if (it == m_observers.end()) return;
+
+    const Observer& observer = it->second;
+    for (int y = -observer.verticalRadius; y <= observer.verticalRadius; ++y) {
+        for (int z = -observer.viewRadius; z <= observer.viewRadius; ++z) {
+            for (int x = -observer.viewRadius; x <= observer.viewRadius; ++x) {
+                glm::ivec3 chunkCoord = observer.centerChunk + glm::ivec3(x, y, z);
+                removeFromIndex(chunkCoord, id);
+                outDelta.left.push_back(chunkCoord);
+            }
+        }
+    }
+    m_observers.erase(it);
+}
+
+bool InterestManager::updateObserver(ObserverId id, const glm::vec3& cameraPosition, InterestDelta& outDelta) {
+    outDelta.entered.clear();
+    outDelta.left.clear();
+    auto it = m_observers.find(id);
+    if (it == m_observers.end()) return false;
+
+    glm::ivec3 centerChunk = cameraToChunkCoord(cameraPosition);
+    if (centerChunk == it->second.centerChunk) return false; // Still in the same chunk: nothing to do
+
+    Observer newBox = it->second;
+    newBox.centerChunk = centerChunk;
+    applyBox(id, it->second, true, newBox, outDelta);
+    it->second = newBox;
+    return true;
+}
+
+bool InterestManager::setViewRadius(ObserverId id, int viewRadius, int verticalRadius, InterestDelta& outDelta) {
+    outDelta.entered.clear();
+    outDelta.left.clear();
+    auto it = m_observers.find(id);
+    if (it == m_observers.end()) return false;
+
+    Observer newBox = it->second;
+    newBox.viewRadius = std::max(0, viewRadius);
+    newBox.verticalRadius = std::max(0, verticalRadius);
+    if (newBox.viewRadius == it->second.viewRadius && newBox.verticalRadius == it->second.verticalRadius) return false;
+
+    applyBox(id, it->second, true, newBox, outDelta);
+    it->second = newBox;
+    return true;
+}
+
+const std::vector<InterestManager::ObserverId>& InterestManager::getObserversOfChunk(const glm::ivec3& chunkCoord) const {
+    static const std::vector<ObserverId> s_none;
+    auto it = m_chunkObservers.find(chunkCoord);
+    return it != m_chunkObservers.end() ? it->second : s_none;
+}
+
+bool InterestManager::isInterested(ObserverId id, const glm::ivec3& chunkCoord) const {
+    auto it = m_observers.find(id);
+    return it != m_observers.end() && boxContains(it->second, chunkCoord);
+}
+
+glm::ivec3 InterestManager::cameraToChunkCoord(const glm::vec3& cameraPosition) {
+    return glm::ivec3(
+        static_cast<int>(glm::floor(cameraPosition.x / Chunk::CHUNK_WIDTH)),
+        static_cast<int>(glm::floor(cameraPosition.y / Chunk::CHUNK_HEIGHT)),
+        static_cast<int>(glm::floor(cameraPosition.z / Chunk::CHUNK_DEPTH)));
+}
+
+bool InterestManager::boxContains(const Observer& observer, const glm::ivec3& chunkCoord) {
+    glm::ivec3 offset = glm::abs(chunkCoord - observer.centerChunk);
+    return offset.x <= observer.viewRadius && offset.z <= observer.viewRadius && offset.y <= observer.verticalRadius;
+}
+
+void InterestManager::applyBox(ObserverId id, const Observer& oldBox, bool hadOldBox, const Observer& newBox, InterestDelta& outDelta) {
+    // Chunks of the new box that were not in the old one entered; chunks of the old box that
+    // are not in the new one left. Membership is a box test, so this is O(box size).
+    for (int y = -newBox.verticalRadius; y <= newBox.verticalRadius; ++y) {
+        for (int z = -newBox.viewRadius; z <= newBox.viewRadius; ++z) {
+            for (int x = -newBox.viewRadius; x <= newBox.viewRadius; ++x) {
+                glm::ivec3 chunkCoord = newBox.centerChunk + glm::ivec3(x, y, z);
+                if (!hadOldBox || !boxContains(oldBox, chunkCoord)) {
+                    addToIndex(chunkCoord, id);
+                    outDelta.entered.push_back(chunkCoord);
+                }
+            }
+        }
+    }
+    if (hadOldBox) {
+        for (int y = -oldBox.verticalRadius; y <= oldBox.verticalRadius; ++y) {
+            for (int z = -oldBox.viewRadius; z <= oldBox.viewRadius; ++z) {
+                for (int x = -oldBox.viewRadius; x <= oldBox.viewRadius; ++x) {
+                    glm::ivec3 chunkCoord = oldBox.centerChunk + glm::ivec3(x, y, z);
+                    if (!boxContains(newBox, chunkCoord)) {
+                        removeFromIndex(chunkCoord, id);
+                        outDelta.left.push_back(chunkCoord);
+                    }
+                }
+            }
+        }
+    }
+
+    glm::ivec3 center = newBox.centerChunk;
+    std::sort(outDelta.entered.begin(), outDelta.entered.end(), [center](const glm::ivec3& a, const glm::ivec3& b) {
+        glm::ivec3 da = a - center;
+        glm::ivec3 db = b - center;
+        return da.x * da.x + da.y * da.y + da.z * da.z < db.x * db.x + db.y * db.y + db.z * db.z;
+    });
+}
+
+void InterestManager::addToIndex(const glm::ivec3& chunkCoord, ObserverId id) {
+    m_chunkObservers[chunkCoord].push_back(id);
+}
+
+void InterestManager::removeFromIndex(const glm::ivec3& chunkCoord, ObserverId id) {
+    auto it = m_chunkObservers.find(chunkCoord);
+    if (it == m_chunkObservers.end()) return;
+    std::vector<ObserverId>& observers = it->second;
+    auto found = std::find(observers.begin(), observers.end(), id);
+    if (found != observers.end()) {
+        *found = observers.back(); // Order doesn't matter, swap-remove
+        observers.pop_back();
+    }
+    if (observers.empty()) {
+        m_chunkObservers.erase(it);
+    }
+}
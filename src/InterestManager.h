@@ -0,0 +1,60 @@
+#ifndef INTERESTMANAGER_H
+#define INTERESTMANAGER_H
+
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp> // For std::hash<glm::ivec3>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// Tracks which chunks each observer (usually a connected player) is interested in.
+// An observer's interest set is the box of chunks within viewRadius (horizontally) and
+// verticalRadius (vertically) of the chunk its camera is in.
+//
+// Sets are only recomputed when an observer crosses a chunk border or changes radius, and the
+// work is proportional to the size of its view box, never to the size of the world.
+// A reverse index (chunk -> observers) lets callers route a chunk event to exactly the
+// observers that can see it.
+class InterestManager {
+public:
+    using ObserverId = uint32_t;
+
+    struct InterestDelta {
+        std::vector<glm::ivec3> entered; // Sorted nearest first, so callers can stream in that order
+        std::vector<glm::ivec3> left;
+    };
+
+    // Adds an observer. outDelta.entered receives its whole initial interest set.
+    void addObserver(ObserverId id, const glm::vec3& cameraPosition, int viewRadius, int verticalRadius, InterestDelta& outDelta);
+    // Removes an observer. outDelta.left receives the chunks it was interested in.
+    void removeObserver(ObserverId id, InterestDelta& outDelta);
+
+    // Moves an observer. Returns true (and fills outDelta) only if the interest set changed.
+    bool updateObserver(ObserverId id, const glm::vec3& cameraPosition, InterestDelta& outDelta);
+    bool setViewRadius(ObserverId id, int viewRadius, int verticalRadius, InterestDelta& outDelta);
+
+    // Observers whose interest set contains chunkCoord (empty if none).
+    const std::vector<ObserverId>& getObserversOfChunk(const glm::ivec3& chunkCoord) const;
+    bool isInterested(ObserverId id, const glm::ivec3& chunkCoord) const;
+    bool hasObserver(ObserverId id) const { return m_observers.count(id) != 0; }
+
+    static glm::ivec3 cameraToChunkCoord(const glm::vec3& cameraPosition);
+
+private:
+    struct Observer {
+        glm::ivec3 centerChunk;
+        int viewRadius;
+        int verticalRadius;
+    };
+
+    static bool boxContains(const Observer& observer, const glm::ivec3& chunkCoord);
+    // Moves the observer to a new box, reporting the chunks that entered/left
+    void applyBox(ObserverId id, const Observer& oldBox, bool hadOldBox, const Observer& newBox, InterestDelta& outDelta);
+    void addToIndex(const glm::ivec3& chunkCoord, ObserverId id);
+    void removeFromIndex(const glm::ivec3& chunkCoord, ObserverId id);
+
+    std::unordered_map<ObserverId, Observer> m_observers;
+    std::unordered_map<glm::ivec3, std::vector<ObserverId>> m_chunkObservers;
+};
+
+#endif // INTERESTMANAGER_H
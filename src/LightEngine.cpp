@@ -0,0 +1,240 @@
+#include "LightEngine.h"
+#include "World.h"
+#include "Chunk.h"
+
+static const int DIRECTION_UP = 2;   // Index of +Y in Chunk::NEIGHBOR_OFFSETS
+static const int DIRECTION_DOWN = 3; // Index of -Y
+static const uint8_t MAX_LIGHT = 15;
+
+LightEngine::LightEngine(World& world) : m_world(world) {}
+
+void LightEngine::onBlockChanged(const glm::ivec3& worldBlockPos) {
+    m_pendingChanges.push_back(worldBlockPos);
+}
+
+uint8_t LightEngine::getLight(const Chunk* chunk, int index, Channel channel) {
+    return channel == SkyChannel ? chunk->getSkyLight(index) : chunk->getBlockLight(index);
+}
+
+void LightEngine::setLight(Chunk* chunk, int index, Channel channel, uint8_t level) {
+    if (channel == SkyChannel) chunk->setSkyLight(index, level);
+    else chunk->setBlockLight(index, level);
+    chunk->setNeedsMeshBuild(true);
+
+    // Faces of the neighbor chunk that look into a border block are lit by it too
+    int x = index % Chunk::CHUNK_WIDTH;
+    int y = (index / Chunk::CHUNK_WIDTH) % Chunk::CHUNK_HEIGHT;
+    int z = index / (Chunk::CHUNK_WIDTH * Chunk::CHUNK_HEIGHT);
+    int borderDirection = -1;
+    if (x == Chunk::CHUNK_WIDTH - 1) borderDirection = 0;
+    else if (x == 0) borderDirection = 1;
+    if (borderDirection >= 0) {
+        if (Chunk* neighbor = chunk->getNeighbor(borderDirection)) neighbor->setNeedsMeshBuild(true);
+    }
+    borderDirection = -1;
+    if (y == Chunk::CHUNK_HEIGHT - 1) borderDirection = 2;
+    else if (y == 0) borderDirection = 3;
+    if (borderDirection >= 0) {
+        if (Chunk* neighbor = chunk->getNeighbor(borderDirection)) neighbor->setNeedsMeshBuild(true);
+    }
+    borderDirection = -1;
+    if (z == Chunk::CHUNK_DEPTH - 1) borderDirection = 4;
+    else if (z == 0) borderDirection = 5;
+    if (borderDirection >= 0) {
+        if (Chunk* neighbor = chunk->getNeighbor(borderDirection)) neighbor->setNeedsMeshBuild(true);
+    }
+}
+
+bool LightEngine::isOpenToSky(const Chunk* chunk) const {
+    Chunk* above = chunk->getNeighbor(DIRECTION_UP);
+    return !above || !above->isGenerated() || !above->isLit();
+}
+
+bool LightEngine::getNeighbor(Chunk* chunk, int index, int direction, Chunk*& outChunk, int& outIndex) const {
+    const glm::ivec3& offset = Chunk::NEIGHBOR_OFFSETS[direction];
+    int x = index % Chunk::CHUNK_WIDTH + offset.x;
+    int y = (index / Chunk::CHUNK_WIDTH) % Chunk::CHUNK_HEIGHT + offset.y;
+    int z = index / (Chunk::CHUNK_WIDTH * Chunk::CHUNK_HEIGHT) + offset.z;
+
+    if (chunk->isPositionInBounds(x, y, z)) {
+        outChunk = chunk;
+        outIndex = Chunk::localIndex(x, y, z);
+        return true;
+    }
+
+    // Crossed a chunk border: only propagate into chunks that are already lit. Unlit chunks pull
+    // light from their neighbors in lightChunk().
+    Chunk* neighbor = chunk->getNeighbor(direction);
+    if (!neighbor || !neighbor->isGenerated() || !neighbor->isLit()) return false;
+    outChunk = neighbor;
+    outIndex = Chunk::localIndex((x + Chunk::CHUNK_WIDTH) % Chunk::CHUNK_WIDTH,
+                                 (y + Chunk::CHUNK_HEIGHT) % Chunk::CHUNK_HEIGHT,
+                                 (z + Chunk::CHUNK_DEPTH) % Chunk::CHUNK_DEPTH);
+    return true;
+}
+
+void LightEngine::lightChunk(Chunk* chunk) {
+    chunk->clearLight();
+    chunk->setLit(true);
+    const BlockType* blocks = chunk->getBlockData();
+
+    // Sky columns. If a lit chunk sits above, its bottom layer seeds us below instead.
+    if (isOpenToSky(chunk)) {
+        for (int z = 0; z < Chunk::CHUNK_DEPTH; ++z) {
+            for (int x = 0; x < Chunk::CHUNK_WIDTH; ++x) {
+                for (int y = Chunk::CHUNK_HEIGHT - 1; y >= 0; --y) {
+                    int index = Chunk::localIndex(x, y, z);
+                    if (isOpaque(blocks[index])) break;
+                    chunk->setSkyLight(index, MAX_LIGHT);
+                    m_addQueue[SkyChannel].push_back({chunk, static_cast<uint16_t>(index), MAX_LIGHT});
+                }
+            }
+        }
+    }
+
+    // Emitters
+    for (int index = 0; index < Chunk::CHUNK_VOLUME; ++index) {
+        uint8_t emission = getLightEmission(blocks[index]);
+        if (emission > 0) {
+            chunk->setBlockLight(index, emission);
+            m_addQueue[BlockChannel].push_back({chunk, static_cast<uint16_t>(index), emission});
+        }
+    }
+
+    // Light flowing in from lit neighbors: seed their border layer facing this chunk
+    for (int direction = 0; direction < 6; ++direction) {
+        const glm::ivec3& offset = Chunk::NEIGHBOR_OFFSETS[direction];
+        Chunk* neighbor = chunk->getNeighbor(direction);
+        if (!neighbor || !neighbor->isGenerated() || !neighbor->isLit()) continue;
+
+        glm::ivec3 minCell(0), maxCell(Chunk::CHUNK_WIDTH - 1, Chunk::CHUNK_HEIGHT - 1, Chunk::CHUNK_DEPTH - 1);
+        for (int axis = 0; axis < 3; ++axis) {
+            if (offset[axis] > 0) maxCell[axis] = 0;               // Neighbor's low face touches us
+            else if (offset[axis] < 0) minCell[axis] = maxCell[axis]; // Neighbor's high face touches us
+        }
+        for (int z = minCell.z; z <= maxCell.z; ++z) {
+            for (int y = minCell.y; y <= maxCell.y; ++y) {
+                for (int x = minCell.x; x <= maxCell.x; ++x) {
+                    int index = Chunk::localIndex(x, y, z);
+                    for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                        uint8_t level = getLight(neighbor, index, static_cast<Channel>(channel));
+                        if (level > 1) m_addQueue[channel].push_back({neighbor, static_cast<uint16_t>(index), level});
+                    }
+                }
+            }
+        }
+    }
+
+    propagateAdds(SkyChannel);
+    propagateAdds(BlockChannel);
+    chunk->setNeedsMeshBuild(true);
+}
+
+void LightEngine::update() {
+    if (m_pendingChanges.empty()) return;
+
+    // 1. Take the old light out of every changed block and remove what flowed from it
+    for (const glm::ivec3& worldBlockPos : m_pendingChanges) {
+        Chunk* chunk = m_world.getChunk(World::worldBlockToChunkCoord(worldBlockPos));
+        if (!chunk || !chunk->isLit()) continue; // lightChunk() will see the new block anyway
+        glm::ivec3 local = World::worldBlockToLocalCoord(worldBlockPos);
+        int index = Chunk::localIndex(local.x, local.y, local.z);
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+            uint8_t level = getLight(chunk, index, static_cast<Channel>(channel));
+            if (level > 0) {
+                setLight(chunk, index, static_cast<Channel>(channel), 0);
+                m_removeQueue[channel].push_back({chunk, static_cast<uint16_t>(index), level});
+            }
+        }
+    }
+    propagateRemovals(SkyChannel);
+    propagateRemovals(BlockChannel);
+
+    // 2. New emitters, and let the neighbors shine back in (e.g. into a block that was just dug out)
+    for (const glm::ivec3& worldBlockPos : m_pendingChanges) {
+        Chunk* chunk = m_world.getChunk(World::worldBlockToChunkCoord(worldBlockPos));
+        if (!chunk || !chunk->isLit()) continue;
+        glm::ivec3 local = World::worldBlockToLocalCoord(worldBlockPos);
+        int index = Chunk::localIndex(local.x, local.y, local.z);
+
+        uint8_t emission = getLightEmission(chunk->getBlockData()[index]);
+        if (emission > chunk->getBlockLight(index)) {
+            setLight(chunk, index, BlockChannel, emission);
+            m_addQueue[BlockChannel].push_back({chunk, static_cast<uint16_t>(index), emission});
+        }
+        // Open sky above the top of the world
+        if (local.y == Chunk::CHUNK_HEIGHT - 1 && !isOpaque(chunk->getBlockData()[index]) && isOpenToSky(chunk)) {
+            setLight(chunk, index, SkyChannel, MAX_LIGHT);
+            m_addQueue[SkyChannel].push_back({chunk, static_cast<uint16_t>(index), MAX_LIGHT});
+        }
+        for (int direction = 0; direction < 6; ++direction) {
+            Chunk* neighborChunk;
+            int neighborIndex;
+            if (!getNeighbor(chunk, index, direction, neighborChunk, neighborIndex)) continue;
+            for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+                uint8_t level = getLight(neighborChunk, neighborIndex, static_cast<Channel>(channel));
+                if (level > 1) {
+                    m_addQueue[channel].push_back({neighborChunk, static_cast<uint16_t>(neighborIndex), level});
+                }
+            }
+        }
+    }
+    m_pendingChanges.clear();
+
+    propagateAdds(SkyChannel);
+    propagateAdds(BlockChannel);
+}
+
+void LightEngine::propagateRemovals(Channel channel) {
+    std::vector<LightNode>& queue = m_removeQueue[channel];
+    for (size_t head = 0; head < queue.size(); ++head) {
+        LightNode node = queue[head]; // Copy: push_back below may reallocate
+        for (int direction = 0; direction < 6; ++direction) {
+            Chunk* neighborChunk;
+            int neighborIndex;
+            if (!getNeighbor(node.chunk, node.index, direction, neighborChunk, neighborIndex)) continue;
+
+            uint8_t neighborLevel = getLight(neighborChunk, neighborIndex, channel);
+            if (neighborLevel == 0) continue;
+
+            // Dimmer neighbors (and full sky light directly below full sky light) were lit through this block
+            bool litByNode = neighborLevel < node.level ||
+                             (channel == SkyChannel && direction == DIRECTION_DOWN && node.level == MAX_LIGHT && neighborLevel == MAX_LIGHT);
+            if (litByNode) {
+                setLight(neighborChunk, neighborIndex, channel, 0);
+                queue.push_back({neighborChunk, static_cast<uint16_t>(neighborIndex), neighborLevel});
+            } else {
+                // Lit by some other source: it refills the cleared area in the add pass
+                m_addQueue[channel].push_back({neighborChunk, static_cast<uint16_t>(neighborIndex), neighborLevel});
+            }
+        }
+    }
+    queue.clear();
+}
+
+void LightEngine::propagateAdds(Channel channel) {
+    std::vector<LightNode>& queue = m_addQueue[channel];
+    for (size_t head = 0; head < queue.size(); ++head) {
+        LightNode node = queue[head];
+        // The stored level can be stale if the block was cleared or brightened after being queued
+        uint8_t level = getLight(node.chunk, node.index, channel);
+        if (level == 0) continue;
+
+        for (int direction = 0; direction < 6; ++direction) {
+            bool skyColumn = channel == SkyChannel && direction == DIRECTION_DOWN && level == MAX_LIGHT;
+            uint8_t newLevel = skyColumn ? MAX_LIGHT : static_cast<uint8_t>(level - 1);
+            if (newLevel == 0) continue;
+
+            Chunk* neighborChunk;
+            int neighborIndex;
+            if (!getNeighbor(node.chunk, node.index, direction, neighborChunk, neighborIndex)) continue;
+            if (isOpaque(neighborChunk->getBlockData()[neighborIndex])) continue;
+
+            if (getLight(neighborChunk, neighborIndex, channel) < newLevel) {
+                setLight(neighborChunk, neighborIndex, channel, newLevel);
+                queue.push_back({neighborChunk, static_cast<uint16_t>(neighborIndex), newLevel});
+            }
+        }
+    }
+    queue.clear();
+}
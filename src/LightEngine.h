@@ -0,0 +1,61 @@
+#ifndef LIGHTENGINE_H
+#define LIGHTENGINE_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class World;
+class Chunk;
+
+// Flood-fill sky and block lighting.
+// Every block stores two 4-bit levels (see Chunk light storage). Sky light starts at 15 in columns
+// open to the sky and travels straight down without loss; both channels lose one level per step
+// sideways. A block change only relights the region it affects: a removal BFS clears the light
+// that came through the changed block, then an add BFS refills it from the surviving frontier
+// and from any new emitter. Whole chunks are only lit once, when they are generated or received.
+class LightEngine {
+public:
+    explicit LightEngine(World& world);
+
+    // Queues a relight around a changed block. Applied by update().
+    void onBlockChanged(const glm::ivec3& worldBlockPos);
+
+    // Lights a freshly generated chunk from its own blocks and its lit neighbors.
+    void lightChunk(Chunk* chunk);
+
+    // Processes all queued block changes
+    void update();
+    bool hasPendingChanges() const { return !m_pendingChanges.empty(); }
+
+private:
+    enum Channel { SkyChannel = 0, BlockChannel = 1, CHANNEL_COUNT = 2 };
+
+    struct LightNode {
+        Chunk* chunk;
+        uint16_t index; // Chunk::localIndex
+        uint8_t level;
+    };
+
+    void propagateRemovals(Channel channel);
+    void propagateAdds(Channel channel);
+
+    // Finds the block next to (chunk, index) in NEIGHBOR_OFFSETS direction. Returns false if it is
+    // in a chunk that isn't loaded or lit yet.
+    bool getNeighbor(Chunk* chunk, int index, int direction, Chunk*& outChunk, int& outIndex) const;
+
+    // True if nothing lit sits above the chunk, so its top layer gets full sky light
+    bool isOpenToSky(const Chunk* chunk) const;
+
+    static uint8_t getLight(const Chunk* chunk, int index, Channel channel);
+    // Writes a level and flags the chunk (and the neighbor across a border face) for remeshing
+    void setLight(Chunk* chunk, int index, Channel channel, uint8_t level);
+
+    World& m_world;
+    std::vector<glm::ivec3> m_pendingChanges;
+    // FIFO queues (vector + read position, reused between updates so they don't reallocate)
+    std::vector<LightNode> m_addQueue[CHANNEL_COUNT];
+    std::vector<LightNode> m_removeQueue[CHANNEL_COUNT];
+};
+
+#endif // LIGHTENGINE_H
@@ -0,0 +1,171 @@
+#include "Logger.h"
+#include <cctype> // For std::tolower
+#include <cstdio>
+#include <iostream>
+
+static const char* LEVEL_NAMES[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR", "OFF"};
+static const char* CATEGORY_NAMES[] = {"general", "world", "chunk", "render", "net", "input"};
+static const std::chrono::milliseconds IDLE_SLEEP(1); // Background thread poll interval while the ring is empty
+
+Logger& Logger::instance() {
+    static Logger* logger = new Logger(); // Leaked on purpose, see the header
+    return *logger;
+}
+
+Logger::Logger()
+    : m_cells(new Cell[CAPACITY]), m_enqueuePosition(0), m_dequeuePosition(0), m_written(0), m_dropped(0),
+      m_reportedDropped(0), m_running(true), m_startTime(std::chrono::steady_clock::now()) {
+    for (size_t i = 0; i < CAPACITY; ++i) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    for (std::atomic<LogLevel>& level : m_levels) level.store(LogLevel::Info, std::memory_order_relaxed);
+    m_thread = std::thread(&Logger::run, this);
+}
+
+void Logger::setLevel(LogCategory category, LogLevel level) {
+    m_levels[static_cast<size_t>(category)].store(level, std::memory_order_relaxed);
+}
+
+void Logger::setLevel(LogLevel level) {
+    for (std::atomic<LogLevel>& categoryLevel : m_levels) categoryLevel.store(level, std::memory_order_relaxed);
+}
+
+bool Logger::parseFilter(const std::string& filter) {
+    size_t equals = filter.find('=');
+    std::string levelName = equals == std::string::npos ? filter : filter.substr(equals + 1);
+    int level = -1;
+    for (int i = 0; i <= static_cast<int>(LogLevel::Off); ++i) {
+        std::string name = LEVEL_NAMES[i];
+        for (char& c : name) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        if (name == levelName) level = i;
+    }
+    if (level < 0) return false;
+
+    if (equals == std::string::npos) {
+        setLevel(static_cast<LogLevel>(level));
+        return true;
+    }
+    std::string categoryName = filter.substr(0, equals);
+    for (size_t i = 0; i < static_cast<size_t>(LogCategory::COUNT); ++i) {
+        if (categoryName == CATEGORY_NAMES[i]) {
+            setLevel(static_cast<LogCategory>(i), static_cast<LogLevel>(level));
+            return true;
+        }
+    }
+    return false;
+}
+
+Logger::Record* Logger::beginRecord() {
+    size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = m_cells[position & (CAPACITY - 1)];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            // Free slot: claim it (on failure position is reloaded and we retry)
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.record.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+                return &cell.record;
+            }
+        } else if (difference < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed); // Full: the writer is a whole ring behind
+            return nullptr;
+        } else {
+            position = m_enqueuePosition.load(std::memory_order_relaxed); // Another thread claimed it first
+        }
+    }
+}
+
+void Logger::commitRecord(Record* record) {
+    Cell* cell = reinterpret_cast<Cell*>(reinterpret_cast<char*>(record) - offsetof(Cell, record));
+    size_t position = cell->sequence.load(std::memory_order_relaxed);
+    cell->sequence.store(position + 1, std::memory_order_release); // Ready for the reader
+
+    if (!m_running.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(m_drainMutex);
+        drainOnce();
+    }
+}
+
+bool Logger::drainOnce() {
+    std::string line;
+    bool wroteAny = false;
+    bool wroteError = false;
+    for (;;) {
+        Cell& cell = m_cells[m_dequeuePosition & (CAPACITY - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1) break; // Empty (or still being filled)
+
+        line.clear();
+        formatRecord(cell.record, line);
+        bool isError = cell.record.level >= LogLevel::Warn;
+        cell.sequence.store(m_dequeuePosition + CAPACITY, std::memory_order_release); // Free for the next lap
+        ++m_dequeuePosition;
+
+        (isError ? std::cerr : std::cout) << line;
+        wroteAny = true;
+        wroteError = wroteError || isError;
+        m_written.fetch_add(1, std::memory_order_release);
+    }
+    uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_reportedDropped) {
+        std::cerr << "[log] " << dropped - m_reportedDropped << " records dropped (ring full)\n";
+        m_reportedDropped = dropped;
+        wroteError = true;
+    }
+    if (wroteAny || wroteError) {
+        std::cout.flush(); // Once per batch instead of once per line
+        if (wroteError) std::cerr.flush();
+    }
+    return wroteAny;
+}
+
+void Logger::run() {
+    while (m_running.load(std::memory_order_acquire)) {
+        bool wroteAny;
+        {
+            // Uncontended until shutdown(), when callers may start draining themselves
+            std::lock_guard<std::mutex> lock(m_drainMutex);
+            wroteAny = drainOnce();
+        }
+        if (!wroteAny) std::this_thread::sleep_for(IDLE_SLEEP);
+    }
+}
+
+void Logger::flush() {
+    size_t target = m_enqueuePosition.load(std::memory_order_acquire);
+    while (m_written.load(std::memory_order_acquire) < target && m_running.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void Logger::shutdown() {
+    if (!m_running.exchange(false)) return;
+    if (m_thread.joinable()) m_thread.join();
+    std::lock_guard<std::mutex> lock(m_drainMutex);
+    drainOnce(); // Whatever arrived while the thread was stopping
+}
+
+void Logger::formatRecord(const Record& record, std::string& out) {
+    char prefix[48];
+    std::snprintf(prefix, sizeof(prefix), "[%9.3f] %-5s %s: ", record.time, LEVEL_NAMES[static_cast<int>(record.level)],
+                  CATEGORY_NAMES[static_cast<int>(record.category)]);
+    out += prefix;
+
+    char number[32];
+    int nextArg = 0;
+    for (const char* c = record.format; *c; ++c) {
+        if (c[0] != '{' || c[1] != '}' || nextArg >= record.argCount) {
+            out += *c;
+            continue;
+        }
+        const Arg& arg = record.args[nextArg++];
+        switch (arg.type) {
+        case Arg::Int: std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(arg.i)); out += number; break;
+        case Arg::UInt: std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(arg.u)); out += number; break;
+        case Arg::Double: std::snprintf(number, sizeof(number), "%g", arg.d); out += number; break;
+        case Arg::Bool: out += arg.u ? "true" : "false"; break;
+        case Arg::Char: out += static_cast<char>(arg.u); break;
+        case Arg::String: out += arg.s; break;
+        }
+        ++c; // Skip the '}'
+    }
+    out += '\n';
+}
@@ -0,0 +1,184 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+enum class LogLevel : uint8_t { Trace = 0, Debug = 1, Info = 2, Warn = 3, Error = 4, Off = 5 };
+
+enum class LogCategory : uint8_t { General = 0, World, Chunk, Render, Net, Input, COUNT };
+
+// Levels below this are compiled out entirely (their arguments aren't even evaluated).
+// Debug builds keep everything, release builds start at Info. Override with -DLOG_COMPILE_LEVEL=<0-5>.
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL 2
+#else
+#define LOG_COMPILE_LEVEL 0
+#endif
+#endif
+
+// Asynchronous logger.
+//
+// A log call checks the category's runtime level (one relaxed atomic load) and, if enabled, copies
+// its format string pointer and arguments into a slot of a fixed ring buffer: a bounded lock-free
+// queue (one compare-and-swap to claim a slot), safe from any thread. A background thread formats
+// the records and writes them, flushing once per batch rather than per line. When the ring is full
+// the record is dropped and counted instead of blocking the caller; the writer reports the count.
+//
+// Messages use "{}" placeholders, filled with the arguments in order. Formats must be string literals
+// (only the pointer is queued); string arguments are copied, up to MAX_STRING_ARG - 1 characters.
+//
+// Use the LOG_* macros below rather than calling write() directly.
+class Logger {
+public:
+    static const size_t CAPACITY = 8192;     // Records in the ring (power of two), about 2.9 MB
+    static const int MAX_ARGS = 8;
+    static const int MAX_STRING_ARG = 32;
+
+    // Created on first use and never destroyed, so logging from static destructors stays valid
+    static Logger& instance();
+
+    bool isEnabled(LogLevel level, LogCategory category) const {
+        return level >= m_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+    void setLevel(LogCategory category, LogLevel level);
+    void setLevel(LogLevel level); // All categories
+    // Parses "<category>=<level>" or "<level>" (e.g. "chunk=trace", "warn"). Returns false if invalid.
+    bool parseFilter(const std::string& filter);
+
+    template <size_t N, typename... Args>
+    void write(LogLevel level, LogCategory category, const char (&format)[N], const Args&... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "Too many log arguments");
+        Record* record = beginRecord();
+        if (!record) return;
+        record->level = level;
+        record->category = category;
+        record->format = format;
+        record->argCount = static_cast<uint8_t>(sizeof...(Args));
+        Arg* arg = record->args;
+        int expand[] = {0, (setArg(*arg++, args), 0)...};
+        (void)expand;
+        (void)arg;
+        commitRecord(record);
+    }
+
+    // Waits until every record queued so far is written
+    void flush();
+    // Drains the queue and stops the background thread. Later calls are written synchronously.
+    void shutdown();
+
+    uint64_t getDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Arg {
+        enum Type : uint8_t { Int, UInt, Double, Bool, Char, String } type;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            char s[MAX_STRING_ARG];
+        };
+    };
+
+    struct Record {
+        double time; // Seconds since the logger started
+        LogLevel level;
+        LogCategory category;
+        uint8_t argCount;
+        const char* format;
+        Arg args[MAX_ARGS];
+    };
+
+    struct Cell {
+        std::atomic<size_t> sequence; // Vyukov bounded queue: slot state relative to the queue positions
+        Record record;
+    };
+
+    Logger();
+
+    Record* beginRecord(); // Claims a slot (null if full), stamps the time
+    void commitRecord(Record* record);
+    void run();            // Background thread
+    bool drainOnce();      // Writes everything queued now; false if there was nothing
+    static void formatRecord(const Record& record, std::string& out);
+
+    template <typename T>
+    static void setArg(Arg& arg, const T& value) {
+        if constexpr (std::is_same<T, bool>::value) {
+            arg.type = Arg::Bool; arg.u = value ? 1 : 0;
+        } else if constexpr (std::is_same<T, char>::value) {
+            arg.type = Arg::Char; arg.u = static_cast<unsigned char>(value);
+        } else if constexpr (std::is_enum<T>::value) {
+            arg.type = Arg::Int; arg.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+            arg.type = Arg::Int; arg.i = value;
+        } else if constexpr (std::is_integral<T>::value) {
+            arg.type = Arg::UInt; arg.u = value;
+        } else if constexpr (std::is_floating_point<T>::value) {
+            arg.type = Arg::Double; arg.d = value;
+        } else {
+            setStringArg(arg, stringOf(value));
+        }
+    }
+    static const char* stringOf(const char* value) { return value ? value : "(null)"; }
+    static const char* stringOf(const std::string& value) { return value.c_str(); }
+    static void setStringArg(Arg& arg, const char* value) {
+        arg.type = Arg::String;
+        std::strncpy(arg.s, value, MAX_STRING_ARG - 1);
+        arg.s[MAX_STRING_ARG - 1] = '\0';
+    }
+
+    Cell* m_cells; // CAPACITY cells
+    alignas(64) std::atomic<size_t> m_enqueuePosition;
+    alignas(64) size_t m_dequeuePosition; // Background thread only (or the caller after shutdown)
+    std::atomic<size_t> m_written;        // Records written, for flush()
+    std::atomic<uint64_t> m_dropped;
+    uint64_t m_reportedDropped;           // Writer side
+    std::atomic<LogLevel> m_levels[static_cast<size_t>(LogCategory::COUNT)];
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+    std::mutex m_drainMutex; // Serializes writing once the background thread has stopped
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+#define LOG_AT(level, category, ...)                                              \
+    do {                                                                          \
+        if (Logger::instance().isEnabled(level, category))                        \
+            Logger::instance().write(level, category, __VA_ARGS__);               \
+    } while (0)
+
+#if LOG_COMPILE_LEVEL <= 0
+#define LOG_TRACE(category, ...) LOG_AT(LogLevel::Trace, category, __VA_ARGS__)
+#else
+#define LOG_TRACE(category, ...) do {} while (0)
+#endif
+#if LOG_COMPILE_LEVEL <= 1
+#define LOG_DEBUG(category, ...) LOG_AT(LogLevel::Debug, category, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) do {} while (0)
+#endif
+#if LOG_COMPILE_LEVEL <= 2
+#define LOG_INFO(category, ...) LOG_AT(LogLevel::Info, category, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) do {} while (0)
+#endif
+#if LOG_COMPILE_LEVEL <= 3
+#define LOG_WARN(category, ...) LOG_AT(LogLevel::Warn, category, __VA_ARGS__)
+#else
+#define LOG_WARN(category, ...) do {} while (0)
+#endif
+#if LOG_COMPILE_LEVEL <= 4
+#define LOG_ERROR(category, ...) LOG_AT(LogLevel::Error, category, __VA_ARGS__)
+#else
+#define LOG_ERROR(category, ...) do {} while (0)
+#endif
+
+#endif // LOGGER_H
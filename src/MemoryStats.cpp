@@ -0,0 +1,65 @@
+#include "MemoryStats.h"
+#include "Logger.h"
+
+static const size_t CATEGORY_COUNT = static_cast<size_t>(MemoryCategory::COUNT);
+static const char* CATEGORY_NAMES[] = {"block data", "chunk objects", "mesh scratch", "CPU meshes",
+                                       "GPU buffers", "text atlas", "map overhead"};
+
+static std::atomic<int64_t> s_bytes[CATEGORY_COUNT];
+static std::atomic<int64_t> s_peakBytes[CATEGORY_COUNT];
+static std::atomic<int64_t> s_liveCount[CATEGORY_COUNT];
+static std::atomic<int64_t> s_totalBytes(0);
+static std::atomic<int64_t> s_peakTotalBytes(0);
+
+void MemoryStats::updatePeak(std::atomic<int64_t>& peak, int64_t value) {
+    int64_t current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        // current was reloaded; retry while we're still higher
+    }
+}
+
+void MemoryStats::resize(MemoryCategory category, size_t oldBytes, size_t newBytes) {
+    size_t i = static_cast<size_t>(category);
+    int64_t delta = static_cast<int64_t>(newBytes) - static_cast<int64_t>(oldBytes);
+    if (delta == 0) return;
+    int64_t bytes = s_bytes[i].fetch_add(delta, std::memory_order_relaxed) + delta;
+    int64_t total = s_totalBytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (delta > 0) {
+        updatePeak(s_peakBytes[i], bytes);
+        updatePeak(s_peakTotalBytes, total);
+    }
+}
+
+void MemoryStats::add(MemoryCategory category, size_t bytes) {
+    s_liveCount[static_cast<size_t>(category)].fetch_add(1, std::memory_order_relaxed);
+    resize(category, 0, bytes);
+}
+
+void MemoryStats::remove(MemoryCategory category, size_t bytes) {
+    s_liveCount[static_cast<size_t>(category)].fetch_sub(1, std::memory_order_relaxed);
+    resize(category, bytes, 0);
+}
+
+MemoryStats::Counter MemoryStats::get(MemoryCategory category) {
+    size_t i = static_cast<size_t>(category);
+    Counter counter;
+    counter.bytes = s_bytes[i].load(std::memory_order_relaxed);
+    counter.peakBytes = s_peakBytes[i].load(std::memory_order_relaxed);
+    counter.liveCount = s_liveCount[i].load(std::memory_order_relaxed);
+    return counter;
+}
+
+int64_t MemoryStats::getTotalBytes() { return s_totalBytes.load(std::memory_order_relaxed); }
+
+int64_t MemoryStats::getPeakTotalBytes() { return s_peakTotalBytes.load(std::memory_order_relaxed); }
+
+const char* MemoryStats::getName(MemoryCategory category) { return CATEGORY_NAMES[static_cast<size_t>(category)]; }
+
+void MemoryStats::dump() {
+    LOG_INFO(LogCategory::General, "Memory: {} KB total (peak {} KB)", getTotalBytes() / 1024, getPeakTotalBytes() / 1024);
+    for (size_t i = 0; i < CATEGORY_COUNT; ++i) {
+        Counter counter = get(static_cast<MemoryCategory>(i));
+        LOG_INFO(LogCategory::General, "  {}: {} KB (peak {} KB), {} live", CATEGORY_NAMES[i], counter.bytes / 1024,
+                 counter.peakBytes / 1024, counter.liveCount);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+enum class MemoryCategory : uint8_t {
+    BlockData = 0, // Chunk block arrays (Chunk::BlockSnapshot), including copies kept alive by readers
+    ChunkObjects,  // Chunk objects with their light and fluid arrays
+    MeshScratch,   // Reused CPU buffers of the meshers (mesh keys)
+    CpuMeshes,     // ChunkMesh vertex arrays, full-resolution and LOD
+    GpuBuffers,    // Vertex/index buffers the renderer uploaded
+    TextAtlas,     // Glyph texture of the text renderer
+    MapOverhead,   // Nodes and buckets of the chunk and mesh maps (estimated)
+    COUNT
+};
+
+// Byte counters per subsystem, updated where the memory is allocated and freed.
+//
+// Each category tracks its current bytes, the most it ever held (high-water mark) and how many
+// allocations are live, so a count that only grows (chunks that are never unloaded, meshes nobody
+// releases) shows up next to the byte total. Safe from any thread: the counters are relaxed atomics.
+//
+// Sizes are what the owner asked for (vector capacities, GL buffer sizes); allocator and driver
+// overhead isn't visible from here. Map overhead is an estimate from the node count, see mapNodeBytes.
+class MemoryStats {
+public:
+    struct Counter {
+        int64_t bytes;
+        int64_t peakBytes;
+        int64_t liveCount; // Allocations not freed yet
+    };
+
+    static void add(MemoryCategory category, size_t bytes);    // One more allocation
+    static void remove(MemoryCategory category, size_t bytes); // One allocation freed
+    // An existing allocation (or estimate) changed size
+    static void resize(MemoryCategory category, size_t oldBytes, size_t newBytes);
+
+    static Counter get(MemoryCategory category);
+    static int64_t getTotalBytes();
+    static int64_t getPeakTotalBytes(); // Highest total at any moment, not the sum of the category peaks
+    static const char* getName(MemoryCategory category);
+
+    // Logs every category (Info, General) for an on-demand report
+    static void dump();
+
+    // Rough heap size of a node of a std::map (tree: three links and a color) or std::unordered_map
+    // (next link and cached hash) holding Value. Close for the common standard libraries.
+    template <typename Value>
+    static constexpr size_t treeNodeBytes() { return sizeof(Value) + 4 * sizeof(void*); }
+    template <typename Value>
+    static constexpr size_t hashNodeBytes() { return sizeof(Value) + 2 * sizeof(void*); }
+    template <typename Map>
+    static size_t hashMapBytes(const Map& map) {
+        return map.size() * hashNodeBytes<typename Map::value_type>() + map.bucket_count() * sizeof(void*);
+    }
+    template <typename Map>
+    static size_t treeMapBytes(const Map& map) { return map.size() * treeNodeBytes<typename Map::value_type>(); }
+
+private:
+    static void updatePeak(std::atomic<int64_t>& peak, int64_t value);
+};
+
+#endif // MEMORYSTATS_H
@@ -0,0 +1,92 @@
+#include "NetClient.h"
+#include "World.h"
+#include "Chunk.h"
+
+NetClient::NetClient(World& world, std::unique_ptr<NetConnection> connection)
+    : m_world(world), m_connection(std::move(connection)),
+      m_hasSentState(false), m_bytesReceived(0), m_lastServerTick(0) {}
+
+void NetClient::sendPlayerState(const glm::vec3& position, float yawDegrees, float pitchDegrees) {
+    if (!isConnected()) return;
+
+    PlayerNetState state = PlayerNetState::quantize(position, yawDegrees, pitchDegrees);
+    if (!m_hasSentState) {
+        m_connection->send(encodePlayerState(0, state)); // Player id is assigned by the server
+        m_hasSentState = true;
+    } else if (state != m_lastSentState) {
+        m_connection->send(encodePlayerMove(0, m_lastSentState, state));
+    }
+    m_lastSentState = state;
+}
+
+void NetClient::processIncoming() {
+    if (!m_connection) return;
+
+    PacketBuffer packet;
+    while (m_connection->receive(packet)) {
+        m_bytesReceived += packet->size();
+
+        PacketType type;
+        if (!readPacketType(packet, type)) continue;
+        switch (type) {
+            case PacketType::ChunkData: applyChunkData(packet); break;
+            case PacketType::ChunkUnload: applyChunkUnload(packet); break;
+            case PacketType::BlockUpdates: applyBlockUpdates(packet); break;
+            case PacketType::PlayerState:
+            case PacketType::PlayerMove:
+            case PacketType::PlayerLeave: applyPlayerPacket(type, packet); break;
+            default: break; // Unknown packet, skip
+        }
+    }
+}
+
+void NetClient::applyChunkData(const PacketBuffer& packet) {
+    glm::ivec3 chunkCoord;
+    if (!decodeChunkData(packet, chunkCoord, m_chunkScratch)) return;
+
+    m_world.ensureChunkExists(chunkCoord);
+    Chunk* chunk = m_world.getChunk(chunkCoord);
+    if (chunk) {
+        chunk->setBlockData(m_chunkScratch.data());
+    }
+}
+
+void NetClient::applyChunkUnload(const PacketBuffer& packet) {
+    glm::ivec3 chunkCoord;
+    if (decodeChunkUnload(packet, chunkCoord)) {
+        m_world.unloadChunk(chunkCoord);
+    }
+}
+
+void NetClient::applyBlockUpdates(const PacketBuffer& packet) {
+    uint32_t tick;
+    if (!decodeBlockUpdates(packet, tick, m_updateScratch)) return;
+    m_lastServerTick = tick;
+
+    for (const BlockUpdate& update : m_updateScratch) {
+        // Updates for chunks we haven't received yet are dropped; the chunk data sent
+        // later already contains them.
+        Chunk* chunk = m_world.getChunk(World::worldBlockToChunkCoord(update.worldBlockPos));
+        if (chunk && chunk->isGenerated()) {
+            m_world.setBlock(update.worldBlockPos, update.type);
+        }
+    }
+}
+
+void NetClient::applyPlayerPacket(PacketType type, const PacketBuffer& packet) {
+    uint32_t playerId = 0;
+    PlayerNetState scratch;
+    // Peek the id first: PlayerMove has to be applied on top of the known state
+    if (!decodePlayerPacket(packet, playerId, scratch)) return;
+
+    if (type == PacketType::PlayerLeave) {
+        m_remotePlayers.erase(playerId);
+    } else if (type == PacketType::PlayerState) {
+        m_remotePlayers[playerId] = scratch;
+    } else {
+        auto it = m_remotePlayers.find(playerId);
+        if (it != m_remotePlayers.end()) {
+            decodePlayerPacket(packet, playerId, it->second);
+        }
+    }
+}
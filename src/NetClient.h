@@ -0,0 +1,52 @@
+#ifndef NETCLIENT_H
+#define NETCLIENT_H
+
+#include "NetProtocol.h"
+#include "NetTransport.h"
+#include <map>
+#include <memory>
+#include <vector>
+
+class World;
+
+// Client side of the replication protocol. Applies chunks and block updates received from a
+// NetServer to a local World mirror, drops chunks that left the view and tracks the other
+// players that are in view.
+class NetClient {
+public:
+    NetClient(World& world, std::unique_ptr<NetConnection> connection);
+
+    // Reports the local player's state. The first call sends a full PlayerState,
+    // later calls only the delta (nothing at all if the quantized state didn't change).
+    void sendPlayerState(const glm::vec3& position, float yawDegrees, float pitchDegrees);
+
+    // Applies every packet received since the last call.
+    void processIncoming();
+
+    const std::map<uint32_t, PlayerNetState>& getRemotePlayers() const { return m_remotePlayers; }
+    uint64_t getBytesReceived() const { return m_bytesReceived; }
+    uint32_t getLastServerTick() const { return m_lastServerTick; }
+    bool isConnected() const { return m_connection && m_connection->isOpen(); }
+
+private:
+    void applyChunkData(const PacketBuffer& packet);
+    void applyChunkUnload(const PacketBuffer& packet);
+    void applyBlockUpdates(const PacketBuffer& packet);
+    void applyPlayerPacket(PacketType type, const PacketBuffer& packet);
+
+    World& m_world;
+    std::unique_ptr<NetConnection> m_connection;
+    std::map<uint32_t, PlayerNetState> m_remotePlayers;
+
+    PlayerNetState m_lastSentState;
+    bool m_hasSentState;
+
+    uint64_t m_bytesReceived;
+    uint32_t m_lastServerTick;
+
+    // Reused between packets to avoid reallocating
+    std::vector<BlockType> m_chunkScratch;
+    std::vector<BlockUpdate> m_updateScratch;
+};
+
+#endif // NETCLIENT_H
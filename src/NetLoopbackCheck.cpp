@@ -0,0 +1,150 @@
+// NetLoopbackCheck: a NetServer replicating a World to two NetClients over LoopbackConnections,
+// all in one process without a window. Checks that the client worlds end up with the server's
+// chunks, that a batch of block changes arrives as one BlockUpdates packet per client, that
+// movement reaches the other client as PlayerState then PlayerMove, and that chunks leaving a
+// client's view are unloaded there. Exits with 1 and lists the failed checks if anything is off.
+#include "NetServer.h"
+#include "NetClient.h"
+#include "NetTransport.h"
+#include "World.h"
+#include "WorldEdit.h"
+#include "Chunk.h"
+#include <algorithm> // For std::equal
+#include <cmath>     // For std::abs
+#include <iostream>
+
+static int g_failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (condition) return;
+    std::cerr << "FAILED: " << what << std::endl;
+    ++g_failures;
+}
+
+static const int VIEW_RADIUS = 2; // 5 x 5 chunks per client
+static const int CHUNKS_IN_VIEW = (2 * VIEW_RADIUS + 1) * (2 * VIEW_RADIUS + 1);
+static const double TICK_SECONDS = 1.0 / 60.0;
+
+// Wraps a loopback endpoint to count the packets that pass through it, by type
+class CountingConnection : public NetConnection {
+public:
+    CountingConnection(std::unique_ptr<NetConnection> inner, int (&received)[8]) : m_inner(std::move(inner)), m_received(received) {}
+
+    void send(const PacketBuffer& packet) override { m_inner->send(packet); }
+    bool receive(PacketBuffer& outPacket) override {
+        if (!m_inner->receive(outPacket)) return false;
+        PacketType type;
+        if (readPacketType(outPacket, type) && static_cast<int>(type) < 8) ++m_received[static_cast<int>(type)];
+        return true;
+    }
+    bool isOpen() const override { return m_inner->isOpen(); }
+    void close() override { m_inner->close(); }
+
+private:
+    std::unique_ptr<NetConnection> m_inner;
+    int (&m_received)[8];
+};
+
+struct TestClient {
+    World world;
+    int received[8] = {};
+    std::unique_ptr<NetClient> client;
+    NetServer::ClientId id = 0;
+};
+
+static void connect(NetServer& server, TestClient& testClient) {
+    auto pair = LoopbackConnection::createPair();
+    testClient.id = server.addClient(std::move(pair.first), VIEW_RADIUS);
+    std::unique_ptr<NetConnection> clientEnd(new CountingConnection(std::move(pair.second), testClient.received));
+    testClient.client.reset(new NetClient(testClient.world, std::move(clientEnd)));
+}
+
+// Server tick (with its world's chunk work, so requested chunks get generated), then both clients read
+static void step(World& serverWorld, NetServer& server, TestClient& a, TestClient& b, double& time) {
+    server.tick(time);
+    serverWorld.getScheduler().runAll();
+    a.client->processIncoming();
+    b.client->processIncoming();
+    time += TICK_SECONDS;
+}
+
+// Chunks the client holds, compared block for block with the server's. Returns how many matched.
+static int countMatchingChunks(const World& serverWorld, const World& clientWorld, bool& allMatch) {
+    int matching = 0;
+    allMatch = true;
+    for (const auto& pair : clientWorld.getLoadedChunks()) {
+        const Chunk* serverChunk = serverWorld.getChunk(pair.first);
+        const Chunk& clientChunk = *pair.second;
+        bool same = serverChunk && clientChunk.isGenerated() &&
+                    std::equal(clientChunk.getBlockData(), clientChunk.getBlockData() + Chunk::CHUNK_VOLUME,
+                               serverChunk->getBlockData());
+        if (same) ++matching; else allMatch = false;
+    }
+    return matching;
+}
+
+static bool near(const glm::vec3& a, const glm::vec3& b) {
+    const float tolerance = 1.0f / POSITION_SCALE;
+    return std::abs(a.x - b.x) <= tolerance && std::abs(a.y - b.y) <= tolerance && std::abs(a.z - b.z) <= tolerance;
+}
+
+int main() {
+    World serverWorld;
+    NetServer server(serverWorld);
+    TestClient a, b;
+    connect(server, a);
+    connect(server, b);
+    double time = 0.0;
+
+    // Both players report where they are; the server streams the chunks around them
+    glm::vec3 positionA(8.0f, 10.0f, 8.0f);
+    glm::vec3 positionB(24.0f, 10.0f, 8.0f); // One chunk over: in each other's view
+    a.client->sendPlayerState(positionA, 0.0f, 0.0f);
+    b.client->sendPlayerState(positionB, 90.0f, 0.0f);
+    for (int tick = 0; tick < 40; ++tick) step(serverWorld, server, a, b, time);
+
+    bool allMatch = false;
+    check(countMatchingChunks(serverWorld, a.world, allMatch) == CHUNKS_IN_VIEW && allMatch, "client A has every chunk in view, equal to the server's");
+    check(countMatchingChunks(serverWorld, b.world, allMatch) == CHUNKS_IN_VIEW && allMatch, "client B has every chunk in view, equal to the server's");
+    check(a.received[static_cast<int>(PacketType::ChunkData)] == CHUNKS_IN_VIEW, "each chunk sent once");
+
+    // A batch of changes across chunk borders, plus a single block: one BlockUpdates packet per client
+    WorldEdit edit(serverWorld);
+    edit.fillBox(glm::ivec3(12, 9, 4), glm::ivec3(19, 11, 6), BlockType::Stone);
+    serverWorld.setBlock(glm::ivec3(3, 9, 3), BlockType::Torch);
+    int updatesBefore = a.received[static_cast<int>(PacketType::BlockUpdates)];
+    step(serverWorld, server, a, b, time);
+    check(a.received[static_cast<int>(PacketType::BlockUpdates)] == updatesBefore + 1, "a tick's changes arrive in one packet");
+    check(a.client->getLastServerTick() == server.getCurrentTick(), "the packet carries the server tick");
+    check(a.world.getBlock(glm::ivec3(19, 11, 6)) == BlockType::Stone && a.world.getBlock(glm::ivec3(3, 9, 3)) == BlockType::Torch,
+          "client A applied the changes");
+    check(countMatchingChunks(serverWorld, b.world, allMatch) == CHUNKS_IN_VIEW && allMatch, "client B still equals the server after the edit");
+
+    // Movement: B first learns A's full state, then deltas
+    check(b.client->getRemotePlayers().count(a.id) == 1, "B sees A");
+    check(b.received[static_cast<int>(PacketType::PlayerState)] == 1, "B got A's full state once");
+    glm::vec3 movedA = positionA + glm::vec3(0.75f, 0.0f, -1.25f);
+    a.client->sendPlayerState(movedA, 45.0f, 10.0f);
+    step(serverWorld, server, a, b, time);
+    check(b.received[static_cast<int>(PacketType::PlayerMove)] == 1, "A's move reached B as one delta");
+    auto remoteA = b.client->getRemotePlayers().find(a.id);
+    check(remoteA != b.client->getRemotePlayers().end() && near(remoteA->second.getPosition(), movedA), "B has A's new position");
+    check(server.getClientStats(a.id).bytesSent == a.client->getBytesReceived(), "bytes sent to A equal bytes A received");
+
+    // A walks far away: its old chunks are unloaded on its side, the new ones streamed in
+    glm::vec3 farA(8.0f + 10 * Chunk::CHUNK_WIDTH, 10.0f, 8.0f);
+    a.client->sendPlayerState(farA, 45.0f, 10.0f);
+    for (int tick = 0; tick < 40; ++tick) step(serverWorld, server, a, b, time);
+    check(a.received[static_cast<int>(PacketType::ChunkUnload)] == CHUNKS_IN_VIEW, "every old chunk unloaded on A");
+    check(a.world.getChunk(glm::ivec3(0, 0, 0)) == nullptr, "A dropped the chunk it left");
+    check(countMatchingChunks(serverWorld, a.world, allMatch) == CHUNKS_IN_VIEW && allMatch, "A holds the new area, equal to the server's");
+    check(b.client->getRemotePlayers().count(a.id) == 0, "A left B's view");
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "NetLoopbackCheck: all checks passed (" << a.client->getBytesReceived() << " bytes to A, "
+              << b.client->getBytesReceived() << " bytes to B)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,335 @@
+#include "NetProtocol.h"
+#include "Chunk.h"
+#include "World.h" // For chunk coordinate helpers
+#include <algorithm> // For std::sort
+#include <cmath>     // For std::round, std::fmod
+
+// --- PacketWriter ---
+
+PacketWriter::PacketWriter(PacketType type, size_t reserveBytes) {
+    m_data.reserve(reserveBytes);
+    m_data.push_back(static_cast<uint8_t>(type));
+}
+
+void PacketWriter::writeU8(uint8_t value) {
+    m_data.push_back(value);
+}
+
+void PacketWriter::writeU16(uint16_t value) {
+    m_data.push_back(static_cast<uint8_t>(value & 0xFF));
+    m_data.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void PacketWriter::writeVarUInt(uint64_t value) {
+    while (value >= 0x80) {
+        m_data.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    m_data.push_back(static_cast<uint8_t>(value));
+}
+
+void PacketWriter::writeVarInt(int64_t value) {
+    // Zigzag: 0 -> 0, -1 -> 1, 1 -> 2, -2 -> 3 ... keeps small negative numbers small
+    writeVarUInt((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void PacketWriter::writeBytes(const uint8_t* data, size_t size) {
+    m_data.insert(m_data.end(), data, data + size);
+}
+
+PacketBuffer PacketWriter::finish() {
+    return std::make_shared<const std::vector<uint8_t>>(std::move(m_data));
+}
+
+// --- PacketReader ---
+
+PacketReader::PacketReader(const uint8_t* data, size_t size)
+    : m_data(data), m_size(size), m_pos(0), m_error(false) {}
+
+PacketReader::PacketReader(const PacketBuffer& packet)
+    : m_data(packet ? packet->data() : nullptr), m_size(packet ? packet->size() : 0), m_pos(0), m_error(false) {}
+
+uint8_t PacketReader::readU8() {
+    if (m_pos >= m_size) {
+        m_error = true;
+        return 0;
+    }
+    return m_data[m_pos++];
+}
+
+uint16_t PacketReader::readU16() {
+    uint16_t low = readU8();
+    uint16_t high = readU8();
+    return static_cast<uint16_t>(low | (high << 8));
+}
+
+uint64_t PacketReader::readVarUInt() {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = readU8();
+        if (m_error) return 0;
+        result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return result;
+    }
+    m_error = true; // Varint longer than 10 bytes
+    return 0;
+}
+
+int64_t PacketReader::readVarInt() {
+    uint64_t raw = readVarUInt();
+    return static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+}
+
+// --- PlayerNetState ---
+
+PlayerNetState PlayerNetState::quantize(const glm::vec3& position, float yawDegrees, float pitchDegrees) {
+    PlayerNetState state;
+    state.position = glm::ivec3(glm::round(position * POSITION_SCALE));
+    float wrappedYaw = std::fmod(yawDegrees, 360.0f);
+    if (wrappedYaw < 0.0f) wrappedYaw += 360.0f;
+    state.yaw = static_cast<uint16_t>(static_cast<uint32_t>(std::round(wrappedYaw / 360.0f * 65536.0f)) & 0xFFFF);
+    float clampedPitch = glm::clamp(pitchDegrees, -90.0f, 90.0f);
+    state.pitch = static_cast<uint16_t>(std::round((clampedPitch + 90.0f) / 180.0f * 65535.0f));
+    return state;
+}
+
+glm::vec3 PlayerNetState::getPosition() const {
+    return glm::vec3(position) / POSITION_SCALE;
+}
+
+float PlayerNetState::getYawDegrees() const {
+    return yaw / 65536.0f * 360.0f;
+}
+
+float PlayerNetState::getPitchDegrees() const {
+    return pitch / 65535.0f * 180.0f - 90.0f;
+}
+
+// --- Helpers ---
+
+bool readPacketType(const PacketBuffer& packet, PacketType& outType) {
+    if (!packet || packet->empty()) return false;
+    outType = static_cast<PacketType>((*packet)[0]);
+    return true;
+}
+
+// Opens a reader positioned after the type byte, verifying the type.
+static bool beginPacket(const PacketBuffer& packet, PacketType expected, PacketReader& reader) {
+    PacketType type;
+    if (!readPacketType(packet, type) || type != expected) return false;
+    reader.readU8();
+    return true;
+}
+
+static void writeIvec3(PacketWriter& writer, const glm::ivec3& v) {
+    writer.writeVarInt(v.x);
+    writer.writeVarInt(v.y);
+    writer.writeVarInt(v.z);
+}
+
+static glm::ivec3 readIvec3(PacketReader& reader) {
+    glm::ivec3 v;
+    v.x = static_cast<int>(reader.readVarInt());
+    v.y = static_cast<int>(reader.readVarInt());
+    v.z = static_cast<int>(reader.readVarInt());
+    return v;
+}
+
+// --- Chunk data ---
+// Layout: [type][chunk x,y,z][run count] then per run: [length varint][block u8].
+// Terrain is mostly long runs of the same block along X, so a flat 16^3 chunk shrinks from
+// 4096 bytes to a few hundred.
+
+PacketBuffer encodeChunkData(const Chunk& chunk) {
+    const BlockType* blocks = chunk.getBlockData();
+
+    // Count runs first so the header can be written up front without a second buffer.
+    uint32_t runCount = 0;
+    for (int i = 0; i < Chunk::CHUNK_VOLUME; ) {
+        int runEnd = i + 1;
+        while (runEnd < Chunk::CHUNK_VOLUME && blocks[runEnd] == blocks[i]) ++runEnd;
+        ++runCount;
+        i = runEnd;
+    }
+
+    PacketWriter writer(PacketType::ChunkData, 16 + runCount * 3);
+    writeIvec3(writer, chunk.getWorldPosition());
+    writer.writeVarUInt(runCount);
+    for (int i = 0; i < Chunk::CHUNK_VOLUME; ) {
+        int runEnd = i + 1;
+        while (runEnd < Chunk::CHUNK_VOLUME && blocks[runEnd] == blocks[i]) ++runEnd;
+        writer.writeVarUInt(static_cast<uint64_t>(runEnd - i));
+        writer.writeU8(static_cast<uint8_t>(blocks[i]));
+        i = runEnd;
+    }
+    return writer.finish();
+}
+
+bool decodeChunkData(const PacketBuffer& packet, glm::ivec3& outChunkCoord, std::vector<BlockType>& outBlocks) {
+    PacketReader reader(packet);
+    if (!beginPacket(packet, PacketType::ChunkData, reader)) return false;
+
+    outChunkCoord = readIvec3(reader);
+    uint64_t runCount = reader.readVarUInt();
+    outBlocks.resize(Chunk::CHUNK_VOLUME);
+
+    size_t written = 0;
+    for (uint64_t run = 0; run < runCount && reader.ok(); ++run) {
+        uint64_t length = reader.readVarUInt();
+        BlockType type = static_cast<BlockType>(reader.readU8());
+        if (length > Chunk::CHUNK_VOLUME - written) return false; // Would overflow the chunk
+        std::fill(outBlocks.begin() + written, outBlocks.begin() + written + length, type);
+        written += static_cast<size_t>(length);
+    }
+    return reader.ok() && written == static_cast<size_t>(Chunk::CHUNK_VOLUME);
+}
+
+PacketBuffer encodeChunkUnload(const glm::ivec3& chunkCoord) {
+    PacketWriter writer(PacketType::ChunkUnload, 16);
+    writeIvec3(writer, chunkCoord);
+    return writer.finish();
+}
+
+bool decodeChunkUnload(const PacketBuffer& packet, glm::ivec3& outChunkCoord) {
+    PacketReader reader(packet);
+    if (!beginPacket(packet, PacketType::ChunkUnload, reader)) return false;
+    outChunkCoord = readIvec3(reader);
+    return reader.ok();
+}
+
+// --- Block updates ---
+// Layout: [type][tick][chunk group count] then per group: [chunk x,y,z][update count]
+// and per update: [local index u16][block u8]. Grouping avoids repeating chunk coordinates.
+
+PacketBuffer encodeBlockUpdates(uint32_t tick, const std::vector<BlockUpdate>& updates) {
+    struct LocalUpdate {
+        glm::ivec3 chunkCoord;
+        uint16_t localIndex;
+        BlockType type;
+    };
+    std::vector<LocalUpdate> sorted;
+    sorted.reserve(updates.size());
+    for (const BlockUpdate& update : updates) {
+        glm::ivec3 chunkCoord = World::worldBlockToChunkCoord(update.worldBlockPos);
+        glm::ivec3 local = update.worldBlockPos - chunkCoord * glm::ivec3(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH);
+        uint16_t localIndex = static_cast<uint16_t>(local.x + local.y * Chunk::CHUNK_WIDTH + local.z * Chunk::CHUNK_WIDTH * Chunk::CHUNK_HEIGHT);
+        sorted.push_back({chunkCoord, localIndex, update.type});
+    }
+    // Stable so several changes of the same block in one tick keep their order (last one wins).
+    std::stable_sort(sorted.begin(), sorted.end(), [](const LocalUpdate& a, const LocalUpdate& b) {
+        if (a.chunkCoord.x != b.chunkCoord.x) return a.chunkCoord.x < b.chunkCoord.x;
+        if (a.chunkCoord.y != b.chunkCoord.y) return a.chunkCoord.y < b.chunkCoord.y;
+        return a.chunkCoord.z < b.chunkCoord.z;
+    });
+
+    uint32_t groupCount = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (i == 0 || sorted[i].chunkCoord != sorted[i - 1].chunkCoord) ++groupCount;
+    }
+
+    PacketWriter writer(PacketType::BlockUpdates, 8 + groupCount * 8 + sorted.size() * 3);
+    writer.writeVarUInt(tick);
+    writer.writeVarUInt(groupCount);
+    for (size_t i = 0; i < sorted.size(); ) {
+        size_t groupEnd = i + 1;
+        while (groupEnd < sorted.size() && sorted[groupEnd].chunkCoord == sorted[i].chunkCoord) ++groupEnd;
+        writeIvec3(writer, sorted[i].chunkCoord);
+        writer.writeVarUInt(groupEnd - i);
+        for (size_t j = i; j < groupEnd; ++j) {
+            writer.writeU16(sorted[j].localIndex);
+            writer.writeU8(static_cast<uint8_t>(sorted[j].type));
+        }
+        i = groupEnd;
+    }
+    return writer.finish();
+}
+
+bool decodeBlockUpdates(const PacketBuffer& packet, uint32_t& outTick, std::vector<BlockUpdate>& outUpdates) {
+    PacketReader reader(packet);
+    if (!beginPacket(packet, PacketType::BlockUpdates, reader)) return false;
+
+    outUpdates.clear();
+    outTick = static_cast<uint32_t>(reader.readVarUInt());
+    uint64_t groupCount = reader.readVarUInt();
+    for (uint64_t group = 0; group < groupCount && reader.ok(); ++group) {
+        glm::ivec3 chunkOrigin = readIvec3(reader) * glm::ivec3(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH);
+        uint64_t count = reader.readVarUInt();
+        for (uint64_t i = 0; i < count && reader.ok(); ++i) {
+            uint16_t localIndex = reader.readU16();
+            BlockType type = static_cast<BlockType>(reader.readU8());
+            if (localIndex >= Chunk::CHUNK_VOLUME) return false;
+            glm::ivec3 local(localIndex % Chunk::CHUNK_WIDTH,
+                             (localIndex / Chunk::CHUNK_WIDTH) % Chunk::CHUNK_HEIGHT,
+                             localIndex / (Chunk::CHUNK_WIDTH * Chunk::CHUNK_HEIGHT));
+            outUpdates.push_back({chunkOrigin + local, type});
+        }
+    }
+    return reader.ok();
+}
+
+// --- Player movement ---
+// PlayerMove flags: bit 0 = position delta present, bit 1 = orientation present.
+// At 20 ticks/s a walking player moves ~16 units of 1/128 block per tick, so a delta fits in
+// one byte per axis and a typical move packet is 6 bytes instead of 17 for a full state.
+
+const uint8_t MOVE_FLAG_POSITION    = 1 << 0;
+const uint8_t MOVE_FLAG_ORIENTATION = 1 << 1;
+
+PacketBuffer encodePlayerState(uint32_t playerId, const PlayerNetState& state) {
+    PacketWriter writer(PacketType::PlayerState, 24);
+    writer.writeVarUInt(playerId);
+    writeIvec3(writer, state.position);
+    writer.writeU16(state.yaw);
+    writer.writeU16(state.pitch);
+    return writer.finish();
+}
+
+PacketBuffer encodePlayerMove(uint32_t playerId, const PlayerNetState& previous, const PlayerNetState& current) {
+    uint8_t flags = 0;
+    if (current.position != previous.position) flags |= MOVE_FLAG_POSITION;
+    if (current.yaw != previous.yaw || current.pitch != previous.pitch) flags |= MOVE_FLAG_ORIENTATION;
+
+    PacketWriter writer(PacketType::PlayerMove, 16);
+    writer.writeVarUInt(playerId);
+    writer.writeU8(flags);
+    if (flags & MOVE_FLAG_POSITION) {
+        writeIvec3(writer, current.position - previous.position);
+    }
+    if (flags & MOVE_FLAG_ORIENTATION) {
+        writer.writeU16(current.yaw);
+        writer.writeU16(current.pitch);
+    }
+    return writer.finish();
+}
+
+PacketBuffer encodePlayerLeave(uint32_t playerId) {
+    PacketWriter writer(PacketType::PlayerLeave, 8);
+    writer.writeVarUInt(playerId);
+    return writer.finish();
+}
+
+bool decodePlayerPacket(const PacketBuffer& packet, uint32_t& outPlayerId, PlayerNetState& io_state) {
+    PacketType type;
+    if (!readPacketType(packet, type)) return false;
+    PacketReader reader(packet);
+    reader.readU8();
+
+    outPlayerId = static_cast<uint32_t>(reader.readVarUInt());
+    if (type == PacketType::PlayerState) {
+        io_state.position = readIvec3(reader);
+        io_state.yaw = reader.readU16();
+        io_state.pitch = reader.readU16();
+    } else if (type == PacketType::PlayerMove) {
+        uint8_t flags = reader.readU8();
+        if (flags & MOVE_FLAG_POSITION) {
+            io_state.position += readIvec3(reader);
+        }
+        if (flags & MOVE_FLAG_ORIENTATION) {
+            io_state.yaw = reader.readU16();
+            io_state.pitch = reader.readU16();
+        }
+    } else if (type != PacketType::PlayerLeave) {
+        return false;
+    }
+    return reader.ok();
+}
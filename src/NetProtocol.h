@@ -0,0 +1,124 @@
+#ifndef NETPROTOCOL_H
+#define NETPROTOCOL_H
+
+#include "BlockType.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class Chunk;
+
+// Wire format for client/server replication.
+// Every packet starts with a one byte PacketType. Integers are written as LEB128 varints
+// (signed values zigzag-encoded first) so small numbers such as deltas and local block indices
+// cost one or two bytes.
+
+enum class PacketType : uint8_t {
+    ChunkData    = 1, // Full chunk contents, RLE-compressed straight from Chunk storage
+    BlockUpdates = 2, // All block changes of one server tick, grouped by chunk
+    PlayerState  = 3, // Absolute (quantized) player position + orientation, sent when a player first appears
+    PlayerMove   = 4, // Movement relative to the last PlayerState/PlayerMove of the same player
+    PlayerLeave  = 5, // Player disconnected or left the receiver's view
+    ChunkUnload  = 6  // Chunk left the receiver's view and can be dropped
+};
+
+// An encoded packet. Packets are immutable once built, so one buffer can be queued to any number
+// of clients without copying (the shared_ptr refcount is the only per-client cost).
+using PacketBuffer = std::shared_ptr<const std::vector<uint8_t>>;
+
+// Positions are sent as fixed point with 1/POSITION_SCALE block precision.
+const float POSITION_SCALE = 128.0f;
+
+// Appends primitive values to a growing byte buffer.
+class PacketWriter {
+public:
+    explicit PacketWriter(PacketType type, size_t reserveBytes = 64);
+
+    void writeU8(uint8_t value);
+    void writeU16(uint16_t value);
+    void writeVarUInt(uint64_t value);
+    void writeVarInt(int64_t value); // Zigzag + varint
+    void writeBytes(const uint8_t* data, size_t size);
+
+    size_t size() const { return m_data.size(); }
+    // Hands the bytes over to an immutable shared buffer. The writer is empty afterwards.
+    PacketBuffer finish();
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+// Reads primitive values from a packet. Any out-of-bounds read sets the error flag
+// and returns 0, so decoders can read everything and check ok() once at the end.
+class PacketReader {
+public:
+    PacketReader(const uint8_t* data, size_t size);
+    explicit PacketReader(const PacketBuffer& packet);
+
+    uint8_t readU8();
+    uint16_t readU16();
+    uint64_t readVarUInt();
+    int64_t readVarInt();
+
+    bool ok() const { return !m_error; }
+    bool atEnd() const { return m_pos >= m_size; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_pos;
+    bool m_error;
+};
+
+// A single block change inside a chunk, as carried by BlockUpdates packets.
+struct BlockUpdate {
+    glm::ivec3 worldBlockPos;
+    BlockType type;
+};
+
+// Quantized player state shared by PlayerState and PlayerMove packets.
+struct PlayerNetState {
+    glm::ivec3 position = glm::ivec3(0); // In 1/POSITION_SCALE blocks
+    uint16_t yaw = 0;                    // Full circle mapped to 0..65535
+    uint16_t pitch = 0;                  // -90..90 degrees mapped to 0..65535
+
+    static PlayerNetState quantize(const glm::vec3& position, float yawDegrees, float pitchDegrees);
+    glm::vec3 getPosition() const;
+    float getYawDegrees() const;
+    float getPitchDegrees() const;
+    bool operator==(const PlayerNetState& other) const {
+        return position == other.position && yaw == other.yaw && pitch == other.pitch;
+    }
+    bool operator!=(const PlayerNetState& other) const { return !(*this == other); }
+};
+
+// Peeks the type of an encoded packet. Returns false for empty packets.
+bool readPacketType(const PacketBuffer& packet, PacketType& outType);
+
+// --- Chunk data ---
+// Encodes the chunk's block array with run-length compression. The raw array is read in place;
+// no intermediate copy of the chunk is made.
+PacketBuffer encodeChunkData(const Chunk& chunk);
+// Decodes into outBlocks (resized to Chunk::CHUNK_VOLUME). Returns false on malformed input.
+bool decodeChunkData(const PacketBuffer& packet, glm::ivec3& outChunkCoord, std::vector<BlockType>& outBlocks);
+
+PacketBuffer encodeChunkUnload(const glm::ivec3& chunkCoord);
+bool decodeChunkUnload(const PacketBuffer& packet, glm::ivec3& outChunkCoord);
+
+// --- Block updates ---
+// Updates do not need to be sorted; they are grouped by chunk while encoding.
+PacketBuffer encodeBlockUpdates(uint32_t tick, const std::vector<BlockUpdate>& updates);
+bool decodeBlockUpdates(const PacketBuffer& packet, uint32_t& outTick, std::vector<BlockUpdate>& outUpdates);
+
+// --- Player movement ---
+PacketBuffer encodePlayerState(uint32_t playerId, const PlayerNetState& state);
+// Encodes the difference between two quantized states. Unchanged fields are omitted.
+PacketBuffer encodePlayerMove(uint32_t playerId, const PlayerNetState& previous, const PlayerNetState& current);
+PacketBuffer encodePlayerLeave(uint32_t playerId);
+// Decodes PlayerState, PlayerMove and PlayerLeave packets. For PlayerMove, io_state must hold the
+// previously known state of the player and is updated in place.
+bool decodePlayerPacket(const PacketBuffer& packet, uint32_t& outPlayerId, PlayerNetState& io_state);
+
+#endif // NETPROTOCOL_H
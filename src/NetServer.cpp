@@ -0,0 +1,276 @@
+#include "NetServer.h"
+#include "Chunk.h"
+#include <algorithm> // For std::remove
+
+NetServer::NetServer(World& world)
+    : m_world(world), m_listenerHandle(0), m_nextClientId(1), m_tick(0) {
+    m_listenerHandle = m_world.addBlockChangeListener(
+        [this](const glm::ivec3& worldBlockPos, BlockType newType) { onBlockChanged(worldBlockPos, newType); });
+}
+
+NetServer::~NetServer() {
+    m_world.removeBlockChangeListener(m_listenerHandle);
+}
+
+NetServer::ClientId NetServer::addClient(std::unique_ptr<NetConnection> connection, int viewRadius) {
+    ClientId id = m_nextClientId++;
+    Client& client = m_clients[id];
+    client.connection = std::move(connection);
+    client.viewRadius = viewRadius;
+    // The client becomes an observer once its first PlayerState tells us where it is.
+    return id;
+}
+
+void NetServer::removeClient(ClientId id) {
+    auto it = m_clients.find(id);
+    if (it == m_clients.end()) return;
+    it->second.connection->close();
+    m_clients.erase(it);
+
+    InterestManager::InterestDelta delta;
+    m_interest.removeObserver(id, delta);
+
+    PacketBuffer leavePacket;
+    for (auto& pair : m_clients) {
+        Client& other = pair.second;
+        if (other.knownPlayers.erase(id)) {
+            if (!leavePacket) leavePacket = encodePlayerLeave(id);
+            sendTo(other, leavePacket);
+        }
+    }
+}
+
+void NetServer::setClientViewRadius(ClientId id, int viewRadius) {
+    auto it = m_clients.find(id);
+    if (it == m_clients.end()) return;
+    it->second.viewRadius = viewRadius;
+
+    InterestManager::InterestDelta delta;
+    if (m_interest.setViewRadius(id, viewRadius, DEFAULT_VERTICAL_RADIUS, delta)) {
+        applyInterestDelta(it->second, delta);
+    }
+}
+
+NetServer::ClientStats NetServer::getClientStats(ClientId id) const {
+    auto it = m_clients.find(id);
+    return it != m_clients.end() ? it->second.stats : ClientStats();
+}
+
+void NetServer::onBlockChanged(const glm::ivec3& worldBlockPos, BlockType newType) {
+    m_pendingUpdates.push_back({worldBlockPos, newType});
+}
+
+void NetServer::tick(double timeSeconds) {
+    ++m_tick;
+
+    // Drop clients whose connection went away, then read input from the rest.
+    std::vector<ClientId> closed;
+    for (auto& pair : m_clients) {
+        if (!pair.second.connection->isOpen()) {
+            closed.push_back(pair.first);
+            continue;
+        }
+        receiveFromClient(pair.first, pair.second);
+    }
+    for (ClientId id : closed) removeClient(id);
+
+    routeBlockUpdates();
+    routePlayerMovement();
+
+    // Chunks wanted by several clients in the same tick are only encoded once.
+    std::map<glm::ivec3, PacketBuffer, Ivec3Compare> encodedThisTick;
+    for (auto& pair : m_clients) {
+        sendPendingChunks(pair.second, encodedThisTick);
+    }
+
+    for (auto& pair : m_clients) {
+        updateBandwidthStats(pair.second, timeSeconds);
+    }
+}
+
+void NetServer::receiveFromClient(ClientId id, Client& client) {
+    PacketBuffer packet;
+    bool moved = false;
+    while (client.connection->receive(packet)) {
+        PacketType type;
+        if (!readPacketType(packet, type)) continue;
+
+        if (type == PacketType::PlayerState || type == PacketType::PlayerMove) {
+            // A move before the first full state has nothing to apply to
+            if (type == PacketType::PlayerMove && !client.hasState) continue;
+            uint32_t ignoredId; // Clients can only move themselves
+            if (decodePlayerPacket(packet, ignoredId, client.state)) {
+                client.hasState = true;
+                moved = true;
+            }
+        }
+        // Other packet types are server -> client only and are ignored here.
+    }
+    if (!moved) return;
+
+    // Only chunk border crossings change the interest set; updateObserver returns early otherwise.
+    InterestManager::InterestDelta delta;
+    glm::vec3 position = client.state.getPosition();
+    if (!m_interest.hasObserver(id)) {
+        m_interest.addObserver(id, position, client.viewRadius, DEFAULT_VERTICAL_RADIUS, delta);
+        applyInterestDelta(client, delta);
+    } else if (m_interest.updateObserver(id, position, delta)) {
+        applyInterestDelta(client, delta);
+    }
+}
+
+void NetServer::applyInterestDelta(Client& client, const InterestManager::InterestDelta& delta) {
+    for (const glm::ivec3& chunkCoord : delta.left) {
+        if (client.sentChunks.erase(chunkCoord)) {
+            sendTo(client, encodeChunkUnload(chunkCoord));
+        }
+    }
+    if (!delta.left.empty()) {
+        // Forget queued chunks that are no longer in view
+        client.pendingChunks.erase(
+            std::remove_if(client.pendingChunks.begin(), client.pendingChunks.end(),
+                           [&delta](const glm::ivec3& chunkCoord) {
+                               return std::find(delta.left.begin(), delta.left.end(), chunkCoord) != delta.left.end();
+                           }),
+            client.pendingChunks.end());
+    }
+    // New chunks go in front of older pending ones: they are nearer to where the player is now.
+    for (auto it = delta.entered.rbegin(); it != delta.entered.rend(); ++it) {
+        m_world.ensureChunkExists(*it); // Streams the chunk in on the server side too
+        client.pendingChunks.push_front(*it);
+    }
+}
+
+void NetServer::routeBlockUpdates() {
+    if (m_pendingUpdates.empty()) return;
+
+    // Bucket this tick's changes by chunk, then hand each bucket to the chunk's observers.
+    std::map<glm::ivec3, std::vector<BlockUpdate>, Ivec3Compare> updatesByChunk;
+    for (const BlockUpdate& update : m_pendingUpdates) {
+        updatesByChunk[World::worldBlockToChunkCoord(update.worldBlockPos)].push_back(update);
+    }
+    m_pendingUpdates.clear();
+
+    // For each client, the list of chunk buckets it should receive (indices into updatesByChunk order).
+    std::vector<const std::vector<BlockUpdate>*> buckets;
+    std::map<ClientId, std::vector<int>> bucketsPerClient;
+    for (const auto& pair : updatesByChunk) {
+        int bucketIndex = static_cast<int>(buckets.size());
+        buckets.push_back(&pair.second);
+        for (InterestManager::ObserverId observer : m_interest.getObserversOfChunk(pair.first)) {
+            auto clientIt = m_clients.find(observer);
+            // Clients still waiting for this chunk get the new contents with the chunk itself.
+            if (clientIt != m_clients.end() && clientIt->second.sentChunks.count(pair.first)) {
+                bucketsPerClient[observer].push_back(bucketIndex);
+            }
+        }
+    }
+
+    // Clients that see the same set of changed chunks (the common case: players standing close
+    // together) share a single encoded packet.
+    std::map<std::vector<int>, PacketBuffer> packetsBySelection;
+    std::vector<BlockUpdate> selection;
+    for (const auto& pair : bucketsPerClient) {
+        PacketBuffer& packet = packetsBySelection[pair.second];
+        if (!packet) {
+            selection.clear();
+            for (int bucketIndex : pair.second) {
+                selection.insert(selection.end(), buckets[bucketIndex]->begin(), buckets[bucketIndex]->end());
+            }
+            packet = encodeBlockUpdates(m_tick, selection);
+        }
+        sendTo(m_clients[pair.first], packet);
+    }
+}
+
+void NetServer::routePlayerMovement() {
+    for (auto& pair : m_clients) {
+        ClientId playerId = pair.first;
+        Client& player = pair.second;
+        if (!player.hasState) continue;
+
+        bool moved = player.state != player.broadcastState;
+        PacketBuffer movePacket;  // Encoded lazily, shared by all observers
+        PacketBuffer statePacket;
+
+        glm::ivec3 playerChunk = InterestManager::cameraToChunkCoord(player.state.getPosition());
+        for (InterestManager::ObserverId observerId : m_interest.getObserversOfChunk(playerChunk)) {
+            if (observerId == playerId) continue;
+            auto observerIt = m_clients.find(observerId);
+            if (observerIt == m_clients.end()) continue;
+            Client& observer = observerIt->second;
+
+            if (observer.knownPlayers.count(playerId)) {
+                if (moved) {
+                    if (!movePacket) movePacket = encodePlayerMove(playerId, player.broadcastState, player.state);
+                    sendTo(observer, movePacket);
+                }
+            } else {
+                // Player just came into view: send the absolute state the following deltas build on
+                if (!statePacket) statePacket = encodePlayerState(playerId, player.state);
+                sendTo(observer, statePacket);
+                observer.knownPlayers.insert(playerId);
+            }
+        }
+        player.broadcastState = player.state;
+    }
+
+    // Players that went out of a client's view are removed on that client.
+    for (auto& pair : m_clients) {
+        Client& observer = pair.second;
+        for (auto it = observer.knownPlayers.begin(); it != observer.knownPlayers.end(); ) {
+            auto playerIt = m_clients.find(*it);
+            bool stillVisible = playerIt != m_clients.end() &&
+                m_interest.isInterested(pair.first, InterestManager::cameraToChunkCoord(playerIt->second.state.getPosition()));
+            if (!stillVisible) {
+                sendTo(observer, encodePlayerLeave(*it));
+                it = observer.knownPlayers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void NetServer::sendPendingChunks(Client& client, std::map<glm::ivec3, PacketBuffer, Ivec3Compare>& encodedThisTick) {
+    int sentThisTick = 0;
+    for (auto it = client.pendingChunks.begin(); it != client.pendingChunks.end() && sentThisTick < MAX_CHUNKS_PER_TICK; ) {
+        const Chunk* chunk = m_world.getChunk(*it);
+        if (!chunk) {
+            // Chunk can't exist (e.g. outside the world's vertical range): nothing will ever be sent
+            it = client.pendingChunks.erase(it);
+            continue;
+        }
+        if (!chunk->isGenerated()) {
+            ++it; // Not generated yet, try again next tick
+            continue;
+        }
+
+        PacketBuffer& packet = encodedThisTick[*it];
+        if (!packet) packet = encodeChunkData(*chunk);
+        sendTo(client, packet);
+        client.sentChunks.insert(*it);
+        it = client.pendingChunks.erase(it);
+        ++sentThisTick;
+    }
+}
+
+void NetServer::sendTo(Client& client, const PacketBuffer& packet) {
+    client.connection->send(packet);
+    client.stats.bytesSent += packet->size();
+    client.stats.packetsSent += 1;
+    client.windowBytes += packet->size();
+}
+
+void NetServer::updateBandwidthStats(Client& client, double timeSeconds) {
+    if (client.windowStart < 0.0) {
+        client.windowStart = timeSeconds;
+        return;
+    }
+    double elapsed = timeSeconds - client.windowStart;
+    if (elapsed >= 1.0) {
+        client.stats.bytesPerSecond = client.windowBytes / elapsed;
+        client.windowBytes = 0;
+        client.windowStart = timeSeconds;
+    }
+}
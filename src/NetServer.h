@@ -0,0 +1,89 @@
+#ifndef NETSERVER_H
+#define NETSERVER_H
+
+#include "NetProtocol.h"
+#include "NetTransport.h"
+#include "InterestManager.h"
+#include "World.h" // For Ivec3Compare
+#include <deque>
+#include <map>
+#include <set>
+#include <memory>
+#include <vector>
+
+// Replicates one authoritative World to any number of connected clients.
+// Call tick() once per simulation tick: it reads client input, then sends
+//  1. the block changes of this tick, routed per chunk to the clients that can see that chunk,
+//  2. movement of players that are inside the receiving client's view,
+//  3. chunks that entered the client's view (a few per tick so joins don't spike bandwidth).
+// What each client can see is decided by an InterestManager keyed on the client's reported
+// position, so per-tick cost scales with players x nearby chunks rather than world size.
+// Packets that go to several clients are encoded once and shared between their queues.
+class NetServer {
+public:
+    using ClientId = uint32_t;
+
+    struct ClientStats {
+        uint64_t bytesSent = 0;
+        uint64_t packetsSent = 0;
+        double bytesPerSecond = 0.0; // Measured over the last full one second window
+    };
+
+    // Chunks sent per client per tick while it is catching up
+    static const int MAX_CHUNKS_PER_TICK = 4;
+    static const int DEFAULT_VIEW_RADIUS = 4;     // In chunks, horizontally
+    static const int DEFAULT_VERTICAL_RADIUS = 1; // In chunks
+
+    explicit NetServer(World& world);
+    ~NetServer();
+
+    NetServer(const NetServer&) = delete;
+    NetServer& operator=(const NetServer&) = delete;
+
+    ClientId addClient(std::unique_ptr<NetConnection> connection, int viewRadius = DEFAULT_VIEW_RADIUS);
+    void removeClient(ClientId id);
+    void setClientViewRadius(ClientId id, int viewRadius);
+
+    void tick(double timeSeconds);
+
+    ClientStats getClientStats(ClientId id) const;
+    size_t getClientCount() const { return m_clients.size(); }
+    uint32_t getCurrentTick() const { return m_tick; }
+
+private:
+    struct Client {
+        std::unique_ptr<NetConnection> connection;
+        int viewRadius = DEFAULT_VIEW_RADIUS;
+
+        std::set<glm::ivec3, Ivec3Compare> sentChunks; // Chunks the client currently holds
+        std::deque<glm::ivec3> pendingChunks;          // In view but not sent yet, nearest first
+        std::set<ClientId> knownPlayers;               // Players the client has a PlayerState for
+
+        PlayerNetState state;          // Latest state reported by the client
+        PlayerNetState broadcastState; // State the observing clients currently know about
+        bool hasState = false;         // False until the first PlayerState arrives
+
+        ClientStats stats;
+        uint64_t windowBytes = 0;
+        double windowStart = -1.0;
+    };
+
+    void onBlockChanged(const glm::ivec3& worldBlockPos, BlockType newType);
+    void receiveFromClient(ClientId id, Client& client);
+    void applyInterestDelta(Client& client, const InterestManager::InterestDelta& delta);
+    void routeBlockUpdates();
+    void routePlayerMovement();
+    void sendPendingChunks(Client& client, std::map<glm::ivec3, PacketBuffer, Ivec3Compare>& encodedThisTick);
+    void sendTo(Client& client, const PacketBuffer& packet);
+    void updateBandwidthStats(Client& client, double timeSeconds);
+
+    World& m_world;
+    int m_listenerHandle;
+    InterestManager m_interest;
+    std::map<ClientId, Client> m_clients;
+    std::vector<BlockUpdate> m_pendingUpdates; // Collected from World::setBlock until the next tick
+    ClientId m_nextClientId;
+    uint32_t m_tick;
+};
+
+#endif // NETSERVER_H
@@ -0,0 +1,37 @@
+#include "NetTransport.h"
+
+std::pair<std::unique_ptr<LoopbackConnection>, std::unique_ptr<LoopbackConnection>> LoopbackConnection::createPair() {
+    std::shared_ptr<Channel> channel = std::make_shared<Channel>();
+    // Constructor is private, so make_unique can't be used here
+    std::unique_ptr<LoopbackConnection> first(new LoopbackConnection(channel, 0));
+    std::unique_ptr<LoopbackConnection> second(new LoopbackConnection(channel, 1));
+    return {std::move(first), std::move(second)};
+}
+
+LoopbackConnection::LoopbackConnection(std::shared_ptr<Channel> channel, int side)
+    : m_channel(std::move(channel)), m_side(side) {}
+
+void LoopbackConnection::send(const PacketBuffer& packet) {
+    std::lock_guard<std::mutex> lock(m_channel->mutex);
+    if (!m_channel->open || !packet) return;
+    m_channel->queues[1 - m_side].push_back(packet); // Shares the buffer, no byte copy
+}
+
+bool LoopbackConnection::receive(PacketBuffer& outPacket) {
+    std::lock_guard<std::mutex> lock(m_channel->mutex);
+    std::deque<PacketBuffer>& queue = m_channel->queues[m_side];
+    if (queue.empty()) return false;
+    outPacket = std::move(queue.front());
+    queue.pop_front();
+    return true;
+}
+
+bool LoopbackConnection::isOpen() const {
+    std::lock_guard<std::mutex> lock(m_channel->mutex);
+    return m_channel->open;
+}
+
+void LoopbackConnection::close() {
+    std::lock_guard<std::mutex> lock(m_channel->mutex);
+    m_channel->open = false;
+}
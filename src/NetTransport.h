@@ -0,0 +1,47 @@
+#ifndef NETTRANSPORT_H
+#define NETTRANSPORT_H
+
+#include "NetProtocol.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+
+// One end of a reliable, ordered packet stream between a client and the server.
+// Implementations must not copy packet bytes: send() only keeps a reference to the shared buffer.
+class NetConnection {
+public:
+    virtual ~NetConnection() = default;
+
+    virtual void send(const PacketBuffer& packet) = 0;
+    // Pops the next received packet. Returns false if nothing is pending.
+    virtual bool receive(PacketBuffer& outPacket) = 0;
+    virtual bool isOpen() const = 0;
+    virtual void close() = 0;
+};
+
+// In-process transport: two connected endpoints sharing a pair of queues.
+// Thread-safe, so a client and the server may run on different threads.
+class LoopbackConnection : public NetConnection {
+public:
+    // Creates a connected pair. first is handed to one side, second to the other.
+    static std::pair<std::unique_ptr<LoopbackConnection>, std::unique_ptr<LoopbackConnection>> createPair();
+
+    void send(const PacketBuffer& packet) override;
+    bool receive(PacketBuffer& outPacket) override;
+    bool isOpen() const override;
+    void close() override;
+
+private:
+    struct Channel {
+        std::mutex mutex;
+        std::deque<PacketBuffer> queues[2]; // queues[i] holds packets waiting to be received by endpoint i
+        bool open = true;
+    };
+
+    LoopbackConnection(std::shared_ptr<Channel> channel, int side);
+
+    std::shared_ptr<Channel> m_channel;
+    int m_side; // 0 or 1
+};
+
+#endif // NETTRANSPORT_H
@@ -0,0 +1,501 @@
+#include "Pathfinder.h"
+#include "World.h"
+#include "Chunk.h"
+#include <algorithm> // For std::reverse
+#include <cstdlib>   // For std::abs
+#include <map>
+
+static const glm::ivec3 HORIZONTAL_DIRECTIONS[4] = {
+    glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1)
+};
+static const int BUCKET_SIZE = 4; // Border crossings are merged per 4x4x4 blocks
+
+// Lower bound of the walking cost: every move steps exactly one block horizontally and costs at least 1
+static float heuristic(const glm::ivec3& a, const glm::ivec3& b) {
+    return static_cast<float>(std::abs(a.x - b.x) + std::abs(a.z - b.z));
+}
+
+static glm::ivec3 bucketOf(const glm::ivec3& pos) {
+    return glm::ivec3(glm::floor(glm::vec3(pos) / static_cast<float>(BUCKET_SIZE)));
+}
+
+struct Crossing {
+    glm::ivec3 from; // Walkable cell a move starts in
+    glm::ivec3 to;   // Walkable cell in another chunk it ends in
+};
+
+// Orders crossings so both chunks of a border pick the same representative
+static bool crossingLess(const Crossing& a, const Crossing& b) {
+    Ivec3Compare less;
+    if (a.from != b.from) return less(a.from, b.from);
+    return less(a.to, b.to);
+}
+
+// (bucket of the source cell, destination chunk)
+struct CrossingKeyCompare {
+    bool operator()(const std::pair<glm::ivec3, glm::ivec3>& a, const std::pair<glm::ivec3, glm::ivec3>& b) const {
+        Ivec3Compare less;
+        if (a.first != b.first) return less(a.first, b.first);
+        return less(a.second, b.second);
+    }
+};
+using CrossingMap = std::map<std::pair<glm::ivec3, glm::ivec3>, Crossing, CrossingKeyCompare>;
+
+static void keepRepresentative(CrossingMap& crossings, const Crossing& crossing) {
+    auto key = std::make_pair(bucketOf(crossing.from), World::worldBlockToChunkCoord(crossing.to));
+    auto it = crossings.find(key);
+    if (it == crossings.end()) {
+        crossings.emplace(key, crossing);
+    } else if (crossingLess(crossing, it->second)) {
+        it->second = crossing;
+    }
+}
+
+Pathfinder::Pathfinder(World& world)
+    : m_world(world), m_nextRequestId(1),
+      m_localCost(Chunk::CHUNK_VOLUME), m_localParent(Chunk::CHUNK_VOLUME), m_localVisited(Chunk::CHUNK_VOLUME, 0),
+      m_localStamp(0), m_expansionsThisTick(0) {}
+
+// --- Block queries ---
+
+bool Pathfinder::isSolidAt(const glm::ivec3& pos) const {
+    // Blocks of missing chunks count as air, so nothing stands on them
+    return isSolid(m_world.getBlock(pos));
+}
+
+bool Pathfinder::isPassableAt(const glm::ivec3& pos) const {
+    BlockType type = m_world.getBlock(pos);
+    return !isSolid(type) && type != BlockType::Lava;
+}
+
+bool Pathfinder::isWalkable(const glm::ivec3& pos) const {
+    return isPassableAt(pos) && isPassableAt(pos + glm::ivec3(0, 1, 0)) && isSolidAt(pos - glm::ivec3(0, 1, 0));
+}
+
+bool Pathfinder::canMove(const glm::ivec3& from, const glm::ivec3& to) const {
+    glm::ivec3 delta = to - from;
+    if (std::abs(delta.x) + std::abs(delta.z) != 1 || delta.y > 1 || delta.y < -MAX_DROP) return false;
+    if (delta.y == 1) {
+        return isPassableAt(from + glm::ivec3(0, 2, 0)); // Head room for the jump
+    }
+    // Dropping: the column above the landing cell must be clear up to head height at the start
+    for (int y = to.y + 2; y <= from.y + 1; ++y) {
+        if (!isPassableAt(glm::ivec3(to.x, y, to.z))) return false;
+    }
+    return true;
+}
+
+float Pathfinder::moveCost(const glm::ivec3& from, const glm::ivec3& to) {
+    return 1.0f + 0.5f * static_cast<float>(std::abs(to.y - from.y));
+}
+
+void Pathfinder::getMoves(const glm::ivec3& pos, bool reverse, std::vector<glm::ivec3>& out) const {
+    out.clear();
+    for (const glm::ivec3& direction : HORIZONTAL_DIRECTIONS) {
+        // At most one height per direction can be a valid move (a step up needs a solid block where
+        // a drop would need air), so stop at the first one
+        for (int dy = 1; dy >= -MAX_DROP; --dy) {
+            glm::ivec3 offset = direction + glm::ivec3(0, dy, 0);
+            glm::ivec3 other = reverse ? pos - offset : pos + offset;
+            if (!isWalkable(other)) continue;
+            if (reverse ? canMove(other, pos) : canMove(pos, other)) {
+                out.push_back(other);
+                break;
+            }
+        }
+    }
+}
+
+glm::ivec3 Pathfinder::clusterOf(const glm::ivec3& pos) {
+    return World::worldBlockToChunkCoord(pos);
+}
+
+bool Pathfinder::isInCluster(const glm::ivec3& clusterCoord, const glm::ivec3& pos) {
+    return clusterOf(pos) == clusterCoord;
+}
+
+// --- Cluster graph ---
+
+Pathfinder::Cluster* Pathfinder::ensureCluster(const glm::ivec3& clusterCoord) {
+    Chunk* chunk = m_world.getChunk(clusterCoord);
+    if (!chunk || !chunk->isGenerated()) return nullptr;
+    Cluster& cluster = m_clusters[clusterCoord];
+    if (cluster.dirty) {
+        if (m_expansionsThisTick >= EXPANSIONS_PER_TICK) return &cluster; // Starts on the next tick
+        findClusterNodes(clusterCoord, cluster);
+        cluster.dirty = false;
+    }
+    connectClusterNodes(clusterCoord, cluster);
+    return &cluster;
+}
+
+void Pathfinder::findClusterNodes(const glm::ivec3& clusterCoord, Cluster& cluster) {
+    cluster.nodes.clear();
+    glm::ivec3 origin = clusterCoord * glm::ivec3(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH);
+
+    // Find every move across the chunk border, in both directions, and keep one per bucket and chunk.
+    // Moves are one block sideways, at most one up and MAX_DROP down, so only cells near a face can cross.
+    CrossingMap outgoing, incoming;
+    std::vector<glm::ivec3> moves;
+    for (int z = 0; z < Chunk::CHUNK_DEPTH; ++z) {
+        for (int y = 0; y < Chunk::CHUNK_HEIGHT; ++y) {
+            for (int x = 0; x < Chunk::CHUNK_WIDTH; ++x) {
+                bool nearFace = x == 0 || x == Chunk::CHUNK_WIDTH - 1 || z == 0 || z == Chunk::CHUNK_DEPTH - 1 ||
+                                y < MAX_DROP || y >= Chunk::CHUNK_HEIGHT - MAX_DROP;
+                if (!nearFace) continue;
+                glm::ivec3 pos = origin + glm::ivec3(x, y, z);
+                if (!isWalkable(pos)) continue;
+                ++m_expansionsThisTick; // Two move lookups, about what a search expansion costs
+                getMoves(pos, false, moves);
+                for (const glm::ivec3& to : moves) {
+                    if (!isInCluster(clusterCoord, to)) keepRepresentative(outgoing, {pos, to});
+                }
+                getMoves(pos, true, moves);
+                for (const glm::ivec3& from : moves) {
+                    if (!isInCluster(clusterCoord, from)) keepRepresentative(incoming, {from, pos});
+                }
+            }
+        }
+    }
+
+    for (const auto& entry : outgoing) {
+        const Crossing& crossing = entry.second;
+        cluster.nodes[crossing.from].push_back({crossing.to, moveCost(crossing.from, crossing.to)});
+    }
+    for (const auto& entry : incoming) {
+        cluster.nodes[entry.second.to]; // Entry point; its edges are the intra-cluster ones below
+    }
+
+    cluster.buildOrder.clear();
+    for (const auto& node : cluster.nodes) cluster.buildOrder.push_back(node.first);
+    cluster.nextNode = 0;
+}
+
+void Pathfinder::connectClusterNodes(const glm::ivec3& clusterCoord, Cluster& cluster) {
+    // Connect the nodes inside the chunk with their walking cost. Budget is checked between nodes;
+    // one node's search is at most one chunk's worth of cells.
+    while (cluster.nextNode < cluster.buildOrder.size() && m_expansionsThisTick < EXPANSIONS_PER_TICK) {
+        const glm::ivec3& source = cluster.buildOrder[cluster.nextNode++];
+        runLocalSearch(clusterCoord, source, false, nullptr);
+        std::vector<Edge>& edges = cluster.nodes[source];
+        for (const auto& other : cluster.nodes) {
+            if (other.first == source) continue;
+            float cost = getLocalCost(clusterCoord, other.first);
+            if (cost >= 0.0f) edges.push_back({other.first, cost});
+        }
+    }
+}
+
+void Pathfinder::markDirty(const glm::ivec3& clusterCoord) {
+    auto it = m_clusters.find(clusterCoord);
+    if (it != m_clusters.end()) it->second.dirty = true;
+}
+
+// --- Local searches ---
+
+bool Pathfinder::runLocalSearch(const glm::ivec3& clusterCoord, const glm::ivec3& source, bool reverse, const glm::ivec3* goal) {
+    if (++m_localStamp == 0) { // Wrapped around: old stamps could match again
+        std::fill(m_localVisited.begin(), m_localVisited.end(), 0u);
+        m_localStamp = 1;
+    }
+    glm::ivec3 origin = clusterCoord * glm::ivec3(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH);
+    auto indexOf = [&origin](const glm::ivec3& pos) {
+        glm::ivec3 local = pos - origin;
+        return Chunk::localIndex(local.x, local.y, local.z);
+    };
+    auto estimate = [goal](const glm::ivec3& pos) { return goal ? heuristic(pos, *goal) : 0.0f; };
+
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+    int sourceIndex = indexOf(source);
+    m_localVisited[sourceIndex] = m_localStamp;
+    m_localCost[sourceIndex] = 0.0f;
+    m_localParent[sourceIndex] = -1;
+    open.push({estimate(source), source});
+
+    m_localExpansions = 0;
+    std::vector<glm::ivec3> moves;
+    while (!open.empty()) {
+        OpenEntry entry = open.top();
+        open.pop();
+        int index = indexOf(entry.pos);
+        float cost = m_localCost[index];
+        if (entry.f > cost + estimate(entry.pos) + 1e-4f) continue; // Superseded by a cheaper entry
+
+        ++m_localExpansions;
+        if (goal && entry.pos == *goal) break;
+
+        getMoves(entry.pos, reverse, moves);
+        for (const glm::ivec3& next : moves) {
+            if (!isInCluster(clusterCoord, next)) continue;
+            int nextIndex = indexOf(next);
+            float nextCost = cost + moveCost(entry.pos, next);
+            if (m_localVisited[nextIndex] != m_localStamp || nextCost < m_localCost[nextIndex]) {
+                m_localVisited[nextIndex] = m_localStamp;
+                m_localCost[nextIndex] = nextCost;
+                m_localParent[nextIndex] = index;
+                open.push({nextCost + estimate(next), next});
+            }
+        }
+    }
+    m_expansionsThisTick += m_localExpansions;
+    return !goal || getLocalCost(clusterCoord, *goal) >= 0.0f;
+}
+
+float Pathfinder::getLocalCost(const glm::ivec3& clusterCoord, const glm::ivec3& pos) const {
+    if (!isInCluster(clusterCoord, pos)) return -1.0f;
+    glm::ivec3 local = World::worldBlockToLocalCoord(pos);
+    int index = Chunk::localIndex(local.x, local.y, local.z);
+    return m_localVisited[index] == m_localStamp ? m_localCost[index] : -1.0f;
+}
+
+bool Pathfinder::findLocalPath(const glm::ivec3& from, const glm::ivec3& to, std::vector<glm::ivec3>& outCells) {
+    glm::ivec3 clusterCoord = clusterOf(from);
+    if (!runLocalSearch(clusterCoord, from, false, &to)) return false;
+
+    glm::ivec3 origin = clusterCoord * glm::ivec3(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH);
+    size_t firstNew = outCells.size();
+    glm::ivec3 local = to - origin;
+    for (int index = Chunk::localIndex(local.x, local.y, local.z); m_localParent[index] != -1; index = m_localParent[index]) {
+        int x = index % Chunk::CHUNK_WIDTH;
+        int y = (index / Chunk::CHUNK_WIDTH) % Chunk::CHUNK_HEIGHT;
+        int z = index / (Chunk::CHUNK_WIDTH * Chunk::CHUNK_HEIGHT);
+        outCells.push_back(origin + glm::ivec3(x, y, z));
+    }
+    std::reverse(outCells.begin() + firstNew, outCells.end());
+    return true;
+}
+
+// --- Requests ---
+
+PathRequestId Pathfinder::requestPath(const glm::ivec3& start, const glm::ivec3& goal, PathCallback callback) {
+    Request request;
+    request.id = m_nextRequestId++;
+    if (m_nextRequestId == 0) m_nextRequestId = 1;
+    request.start = start;
+    request.goal = goal;
+    request.callback = std::move(callback);
+    m_requests.push_back(std::move(request));
+    return m_requests.back().id;
+}
+
+void Pathfinder::cancel(PathRequestId id) {
+    for (auto it = m_requests.begin(); it != m_requests.end(); ++it) {
+        if (it->id == id) {
+            m_requests.erase(it);
+            return;
+        }
+    }
+}
+
+void Pathfinder::update() {
+    m_expansionsThisTick = 0;
+    while (!m_requests.empty() && m_expansionsThisTick < EXPANSIONS_PER_TICK) {
+        Request& request = m_requests.front();
+        switch (request.phase) {
+            case RequestPhase::Start:    startRequest(request); break;
+            case RequestPhase::Abstract: stepAbstract(request); break;
+            case RequestPhase::Refine:   stepRefine(request); break;
+            case RequestPhase::Done:     break;
+        }
+        if (request.phase == RequestPhase::Done) {
+            // Pop before calling back: the callback may queue or cancel requests
+            PathResult result;
+            result.id = request.id;
+            result.found = request.found;
+            if (request.found) result.cells = std::move(request.cells);
+            PathCallback callback = std::move(request.callback);
+            m_requests.pop_front();
+            if (callback) callback(result);
+        }
+    }
+}
+
+bool Pathfinder::snapToGround(glm::ivec3& pos) const {
+    for (int i = 0; i <= MAX_DROP; ++i) {
+        if (isWalkable(pos)) return true;
+        pos.y -= 1;
+    }
+    return false;
+}
+
+void Pathfinder::startRequest(Request& request) {
+    // Runs again on the next tick while the clusters are being built; snapping a snapped cell keeps it
+    if (!snapToGround(request.start) || !snapToGround(request.goal)) {
+        request.phase = RequestPhase::Done;
+        return;
+    }
+    if (request.start == request.goal) {
+        request.found = true;
+        request.cells.assign(1, request.start);
+        request.phase = RequestPhase::Done;
+        return;
+    }
+
+    glm::ivec3 startCluster = clusterOf(request.start);
+    glm::ivec3 goalCluster = clusterOf(request.goal);
+    Cluster* start = ensureCluster(startCluster);
+    Cluster* goal = start ? ensureCluster(goalCluster) : nullptr;
+    if (!start || !goal) {
+        request.phase = RequestPhase::Done; // Not loaded
+        return;
+    }
+    if (!start->isBuilt() || !goal->isBuilt()) return; // Out of budget; still in the Start phase
+
+    // Temporary edges: from start into its cluster's nodes, and from the goal cluster's nodes to goal
+    runLocalSearch(goalCluster, request.goal, true, nullptr);
+    for (const auto& node : goal->nodes) {
+        float cost = getLocalCost(goalCluster, node.first);
+        if (cost >= 0.0f) request.goalCosts[node.first] = cost;
+    }
+    runLocalSearch(startCluster, request.start, false, nullptr);
+    for (const auto& node : start->nodes) {
+        float cost = getLocalCost(startCluster, node.first);
+        if (cost >= 0.0f && node.first != request.start) request.startEdges.push_back({node.first, cost});
+    }
+    if (startCluster == goalCluster) {
+        float cost = getLocalCost(startCluster, request.goal);
+        if (cost >= 0.0f) request.startEdges.push_back({request.goal, cost});
+    }
+
+    request.records[request.start] = {0.0f, request.start};
+    request.open.push({heuristic(request.start, request.goal), request.start});
+    request.phase = RequestPhase::Abstract;
+}
+
+void Pathfinder::stepAbstract(Request& request) {
+    while (m_expansionsThisTick < EXPANSIONS_PER_TICK) {
+        if (request.open.empty() || request.abstractExpansions >= MAX_ABSTRACT_EXPANSIONS) {
+            request.phase = RequestPhase::Done; // Unreachable
+            return;
+        }
+        OpenEntry entry = request.open.top();
+        request.open.pop();
+        NodeRecord& record = request.records[entry.pos];
+        if (record.closed) continue;
+
+        // Expanding a node needs its cluster's edges. A build that runs out of budget continues on the
+        // next tick; the node goes back into the open list until then.
+        Cluster* cluster = nullptr;
+        if (entry.pos != request.goal) {
+            cluster = ensureCluster(clusterOf(entry.pos));
+            if (cluster && !cluster->isBuilt()) {
+                request.open.push(entry);
+                return;
+            }
+        }
+        record.closed = true;
+        ++request.abstractExpansions;
+        ++m_expansionsThisTick;
+
+        if (entry.pos == request.goal) {
+            for (glm::ivec3 pos = request.goal; pos != request.start; pos = request.records[pos].parent) {
+                request.waypoints.push_back(pos);
+            }
+            request.waypoints.push_back(request.start);
+            std::reverse(request.waypoints.begin(), request.waypoints.end());
+            request.cells.assign(1, request.start);
+            request.nextWaypoint = 1;
+            request.phase = RequestPhase::Refine;
+            return;
+        }
+
+        auto relax = [&request](const glm::ivec3& to, float g, const glm::ivec3& parent) {
+            auto it = request.records.find(to);
+            if (it == request.records.end()) {
+                request.records.emplace(to, NodeRecord{g, parent});
+            } else if (!it->second.closed && g < it->second.g) {
+                it->second.g = g;
+                it->second.parent = parent;
+            } else {
+                return;
+            }
+            request.open.push({g + heuristic(to, request.goal), to});
+        };
+
+        float g = record.g;
+        auto goalCost = request.goalCosts.find(entry.pos);
+        if (goalCost != request.goalCosts.end()) relax(request.goal, g + goalCost->second, entry.pos);
+
+        if (entry.pos == request.start) {
+            for (const Edge& edge : request.startEdges) relax(edge.to, g + edge.cost, entry.pos);
+        }
+        // The start can be a node itself (standing on a crossing): its own edges lead out of the cluster
+        if (!cluster) continue;
+        auto node = cluster->nodes.find(entry.pos);
+        if (node == cluster->nodes.end()) continue; // Not a node, or the cluster was rebuilt without it
+        for (const Edge& edge : node->second) relax(edge.to, g + edge.cost, entry.pos);
+    }
+}
+
+void Pathfinder::stepRefine(Request& request) {
+    // Budget is checked between segments; one segment is at most one chunk's worth of cells
+    while (request.nextWaypoint < request.waypoints.size() && m_expansionsThisTick < EXPANSIONS_PER_TICK) {
+        const glm::ivec3& from = request.waypoints[request.nextWaypoint - 1];
+        const glm::ivec3& to = request.waypoints[request.nextWaypoint];
+        if (clusterOf(from) == clusterOf(to)) {
+            if (!findLocalPath(from, to, request.cells)) {
+                restartOrFail(request);
+                return;
+            }
+        } else {
+            if (!isWalkable(to) || !canMove(from, to)) {
+                restartOrFail(request);
+                return;
+            }
+            request.cells.push_back(to);
+        }
+        ++request.nextWaypoint;
+    }
+    if (request.nextWaypoint >= request.waypoints.size()) {
+        request.found = true;
+        request.phase = RequestPhase::Done;
+    }
+}
+
+void Pathfinder::restartOrFail(Request& request) {
+    if (request.retried) {
+        request.phase = RequestPhase::Done;
+        return;
+    }
+    // Blocks changed since the abstract path was found; clusters they touched are dirty and get rebuilt
+    request.retried = true;
+    request.phase = RequestPhase::Start;
+    request.open = decltype(request.open)();
+    request.records.clear();
+    request.startEdges.clear();
+    request.goalCosts.clear();
+    request.abstractExpansions = 0;
+    request.waypoints.clear();
+    request.cells.clear();
+}
+
+// --- Notifications ---
+
+void Pathfinder::onBlockChanged(const glm::ivec3& worldBlockPos) {
+    // A block affects walkability and moves a few blocks around it (ground, head room, drops),
+    // which can reach into neighboring chunks
+    const int margin = MAX_DROP + 1;
+    for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dz = -1; dz <= 1; ++dz) {
+                markDirty(clusterOf(worldBlockPos + glm::ivec3(dx, dy, dz) * margin));
+            }
+        }
+    }
+}
+
+void Pathfinder::onChunkLoaded(const glm::ivec3& chunkCoord) {
+    // Border crossings of the neighbors depend on this chunk's blocks
+    for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dz = -1; dz <= 1; ++dz) {
+                markDirty(chunkCoord + glm::ivec3(dx, dy, dz));
+            }
+        }
+    }
+}
+
+void Pathfinder::onChunkUnloaded(const glm::ivec3& chunkCoord) {
+    m_clusters.erase(chunkCoord);
+    onChunkLoaded(chunkCoord); // Neighbors lose their crossings into it
+}
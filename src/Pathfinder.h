@@ -0,0 +1,172 @@
+#ifndef PATHFINDER_H
+#define PATHFINDER_H
+
+#include "BlockType.h"
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp> // For std::hash<glm::ivec3>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+class World;
+class Chunk;
+
+using PathRequestId = uint32_t;
+
+struct PathResult {
+    PathRequestId id = 0;
+    bool found = false;
+    std::vector<glm::ivec3> cells; // Feet cells from start to goal (inclusive) when found
+};
+
+// Walkable-path queries for mobs (2 blocks tall, steps up 1 block, drops up to MAX_DROP).
+//
+// Hierarchical A* over a coarse graph: every chunk is a cluster whose abstract nodes are the walkable
+// cells where paths enter or leave it (one per 4x4x4 block bucket and neighbor chunk). Inside a cluster
+// nodes are connected by edges with their true walking cost, between clusters by the single move that
+// crosses the border. A query searches that graph, then refines each intra-cluster hop with a local A*
+// confined to one chunk.
+//
+// Clusters are built lazily the first time a search reaches them and rebuilt after block changes near
+// them. Requests are queued and served from update() with a per-tick expansion budget, so a long search
+// is spread over several ticks; the callback runs on the simulation thread once the path is known.
+// Cluster builds count against the same budget: one that doesn't fit continues on the next tick, and
+// the search waiting for it resumes once it is done.
+class Pathfinder {
+public:
+    using PathCallback = std::function<void(const PathResult&)>;
+
+    static const int MAX_DROP = 3;                        // Highest ledge a mob walks off
+    static const int EXPANSIONS_PER_TICK = 20000;         // Budget of searched cells/nodes per update()
+    static const int MAX_ABSTRACT_EXPANSIONS = 20000;     // Per request, before giving up as unreachable
+
+    explicit Pathfinder(World& world);
+
+    // Queues a search from start to goal (feet cells; a cell standing in the air is snapped down to the
+    // ground below it). callback is called once from a later update(), also when no path exists.
+    PathRequestId requestPath(const glm::ivec3& start, const glm::ivec3& goal, PathCallback callback);
+    void cancel(PathRequestId id);
+
+    // Serves queued requests until the tick's budget is used up
+    void update();
+
+    // Notifications from World
+    void onBlockChanged(const glm::ivec3& worldBlockPos);
+    void onChunkLoaded(const glm::ivec3& chunkCoord);
+    void onChunkUnloaded(const glm::ivec3& chunkCoord);
+
+    // A mob's feet fit in pos: feet and head cells passable, solid ground below
+    bool isWalkable(const glm::ivec3& pos) const;
+
+    size_t getPendingRequestCount() const { return m_requests.size(); }
+    size_t getClusterCount() const { return m_clusters.size(); }
+
+private:
+    struct Edge {
+        glm::ivec3 to;
+        float cost;
+    };
+
+    struct Cluster {
+        // Abstract nodes of this chunk -> their outgoing edges (intra-cluster and border crossings).
+        // Nodes only entered from outside have an entry with no edges leaving the chunk.
+        std::unordered_map<glm::ivec3, std::vector<Edge>> nodes;
+        // A build finds all nodes in one pass over the border, then searches their intra-cluster edges
+        // one node at a time while budget remains: buildOrder[i] for i < nextNode have theirs.
+        std::vector<glm::ivec3> buildOrder;
+        size_t nextNode = 0;
+        bool dirty = true; // Blocks changed: the next ensureCluster() starts the build over
+
+        bool isBuilt() const { return !dirty && nextNode == buildOrder.size(); }
+    };
+
+    struct NodeRecord {
+        float g;
+        glm::ivec3 parent;
+        bool closed = false;
+    };
+
+    struct OpenEntry {
+        float f;
+        glm::ivec3 pos;
+        bool operator>(const OpenEntry& other) const { return f > other.f; }
+    };
+
+    enum class RequestPhase { Start, Abstract, Refine, Done };
+
+    struct Request {
+        PathRequestId id;
+        glm::ivec3 start, goal;
+        PathCallback callback;
+        RequestPhase phase = RequestPhase::Start;
+        bool retried = false; // Refinement failed once (world changed mid-request) and the search restarted
+        bool found = false;   // Result, once phase is Done
+
+        // Abstract search
+        std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+        std::unordered_map<glm::ivec3, NodeRecord> records;
+        std::vector<Edge> startEdges;                   // start -> nodes of its cluster (and goal if same cluster)
+        std::unordered_map<glm::ivec3, float> goalCosts; // Nodes of the goal's cluster -> cost to goal
+        int abstractExpansions = 0;
+
+        // Refinement
+        std::vector<glm::ivec3> waypoints; // start, abstract nodes..., goal
+        size_t nextWaypoint = 1;
+        std::vector<glm::ivec3> cells;
+    };
+
+    // --- Block queries ---
+    bool isSolidAt(const glm::ivec3& pos) const;
+    bool isPassableAt(const glm::ivec3& pos) const; // Feet or head may be in it
+    // Whether a mob in walkable cell from can move to walkable cell to (horizontally adjacent, dy in [-MAX_DROP, 1])
+    bool canMove(const glm::ivec3& from, const glm::ivec3& to) const;
+    static float moveCost(const glm::ivec3& from, const glm::ivec3& to);
+    // Walkable cells one move away from pos (reverse: cells that can move to pos)
+    void getMoves(const glm::ivec3& pos, bool reverse, std::vector<glm::ivec3>& out) const;
+
+    static glm::ivec3 clusterOf(const glm::ivec3& pos);
+    static bool isInCluster(const glm::ivec3& clusterCoord, const glm::ivec3& pos);
+
+    // --- Cluster graph ---
+    // Builds/rebuilds the cluster as far as the tick's budget allows. Null if the chunk isn't loaded;
+    // check isBuilt() on the result, a build can take several ticks.
+    Cluster* ensureCluster(const glm::ivec3& clusterCoord);
+    void findClusterNodes(const glm::ivec3& clusterCoord, Cluster& cluster); // Border crossings, no edges yet
+    void connectClusterNodes(const glm::ivec3& clusterCoord, Cluster& cluster); // Next nodes' edges, within budget
+    void markDirty(const glm::ivec3& clusterCoord);
+
+    // --- Local (single cluster) searches, results in the m_local* scratch arrays ---
+    // Dijkstra from source over the whole cluster (reverse: costs *to* source), or A* stopping at *goal.
+    // Returns false if goal was given and not reached.
+    bool runLocalSearch(const glm::ivec3& clusterCoord, const glm::ivec3& source, bool reverse, const glm::ivec3* goal);
+    float getLocalCost(const glm::ivec3& clusterCoord, const glm::ivec3& pos) const; // After runLocalSearch, <0 if unreached
+    // Appends the cells after from up to and including to. Both must be in the same cluster.
+    bool findLocalPath(const glm::ivec3& from, const glm::ivec3& to, std::vector<glm::ivec3>& outCells);
+
+    // --- Request phases. Each advances the request while budget remains; Done when it has a result ---
+    void startRequest(Request& request);
+    void stepAbstract(Request& request);
+    void stepRefine(Request& request);
+    void restartOrFail(Request& request); // A refined segment no longer exists: search again once
+    bool snapToGround(glm::ivec3& pos) const;
+
+    World& m_world;
+    PathRequestId m_nextRequestId;
+    std::deque<Request> m_requests;
+    std::unordered_map<glm::ivec3, Cluster> m_clusters;
+
+    // Local search scratch, one entry per block of a cluster. m_localStamp marks entries that belong to
+    // the current search, so nothing needs clearing between searches.
+    std::vector<float> m_localCost;
+    std::vector<int> m_localParent;
+    std::vector<uint32_t> m_localVisited;
+    uint32_t m_localStamp;
+    int m_localExpansions; // Cells expanded by the last runLocalSearch
+
+    int m_expansionsThisTick; // Cells and abstract nodes expanded during the current update()
+};
+
+#endif // PATHFINDER_H
@@ -0,0 +1,93 @@
+#include "RenderQueue.h"
+#include <algorithm> // For std::sort, std::min
+
+static const int SEQUENCE_BITS = 20;
+static const int DEPTH_BITS = 24;
+static const int STATE_BITS = 8;
+static const int PROGRAM_BITS = 8;
+
+RenderQueue::RenderQueue() : m_perDrawBuffer(0), m_pageStride(PER_DRAW_PAGE_ENTRIES * sizeof(glm::ivec4)) {}
+
+void RenderQueue::setPerDrawBuffer(GLuint buffer, size_t offsetAlignment) {
+    m_perDrawBuffer = buffer;
+    size_t pageSize = PER_DRAW_PAGE_ENTRIES * sizeof(glm::ivec4);
+    if (offsetAlignment == 0) offsetAlignment = 1;
+    m_pageStride = (pageSize + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+}
+
+uint8_t RenderState::getSortBits() const {
+    int width = std::min(31, static_cast<int>(lineWidth)); // Whole pixels are enough to group by
+    return static_cast<uint8_t>((depthTest ? 1 : 0) | (blend ? 2 : 0) | (wireframe ? 4 : 0) | (width << 3));
+}
+
+void RenderQueue::submit(Layer layer, float depth, const RenderCommand& command) {
+    const uint64_t maxDepth = (1ull << DEPTH_BITS) - 1;
+    float clampedDepth = std::min(std::max(depth, 0.0f), MAX_SORT_DEPTH);
+    uint64_t depthBits = static_cast<uint64_t>(clampedDepth / MAX_SORT_DEPTH * static_cast<float>(maxDepth));
+    // Program ids are small; ids that share their low bits only group less well, the order stays valid
+    uint64_t key = static_cast<uint64_t>(layer) << (PROGRAM_BITS + STATE_BITS + DEPTH_BITS + SEQUENCE_BITS);
+    key |= static_cast<uint64_t>(command.program & ((1u << PROGRAM_BITS) - 1)) << (STATE_BITS + DEPTH_BITS + SEQUENCE_BITS);
+    key |= static_cast<uint64_t>(command.state.getSortBits()) << (DEPTH_BITS + SEQUENCE_BITS);
+    key |= std::min(depthBits, maxDepth) << SEQUENCE_BITS;
+    key |= static_cast<uint64_t>(m_entries.size()) & ((1ull << SEQUENCE_BITS) - 1);
+    m_entries.push_back({key, command, 0, 0});
+}
+
+void RenderQueue::packPerDrawData() {
+    m_perDrawData.clear();
+    const size_t entriesPerPage = m_pageStride / sizeof(glm::ivec4);
+    int page = -1;
+    int nextId = PER_DRAW_PAGE_ENTRIES; // Forces a page for the first entry
+    const glm::ivec4* previous = nullptr;
+    for (Entry& entry : m_entries) {
+        if (entry.command.drawIdLocation < 0) continue;
+        // Draws in a row with the same data (a chunk's direction buckets) share one slot
+        if (previous && *previous == entry.command.perDrawData) {
+            entry.page = page;
+            entry.drawId = nextId - 1;
+            continue;
+        }
+        if (nextId == PER_DRAW_PAGE_ENTRIES) {
+            ++page;
+            nextId = 0;
+            m_perDrawData.resize((page + 1) * entriesPerPage, glm::ivec4(0)); // Whole pages, so every bound range is in the buffer
+        }
+        m_perDrawData[page * entriesPerPage + nextId] = entry.command.perDrawData;
+        previous = &entry.command.perDrawData;
+        entry.page = page;
+        entry.drawId = nextId++;
+    }
+}
+
+void RenderQueue::execute(GlStateCache& state) {
+    std::sort(m_entries.begin(), m_entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+    GlBackend& backend = state.getBackend();
+    packPerDrawData();
+    if (!m_perDrawData.empty() && m_perDrawBuffer != 0) {
+        backend.uploadUniformBuffer(m_perDrawBuffer, m_perDrawData.data(), m_perDrawData.size() * sizeof(glm::ivec4));
+    }
+
+    for (const Entry& entry : m_entries) {
+        const RenderCommand& command = entry.command;
+        state.useProgram(command.program);
+        state.setEnabled(GL_DEPTH_TEST, command.state.depthTest);
+        state.setEnabled(GL_BLEND, command.state.blend);
+        state.setPolygonMode(command.state.wireframe ? GL_LINE : GL_FILL);
+        state.setLineWidth(command.state.lineWidth);
+        state.bindVertexArray(command.vao);
+        state.setUniformMatrix4(command.modelLocation, command.model);
+        if (command.drawIdLocation >= 0) {
+            state.bindUniformBufferRange(PER_DRAW_BINDING, m_perDrawBuffer, entry.page * m_pageStride,
+                                         PER_DRAW_PAGE_ENTRIES * sizeof(glm::ivec4));
+            state.setUniformInt(command.drawIdLocation, entry.drawId);
+        }
+
+        if (command.indexed) {
+            backend.drawElements(command.mode, command.count, static_cast<size_t>(command.first) * sizeof(GLuint));
+        } else {
+            backend.drawArrays(command.mode, command.first, command.count);
+        }
+    }
+    m_entries.clear();
+}
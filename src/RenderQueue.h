@@ -0,0 +1,93 @@
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include "GlStateCache.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Fixed-function state a draw needs, set through the GlStateCache before it
+struct RenderState {
+    bool depthTest = true;
+    bool blend = false;
+    bool wireframe = false;
+    float lineWidth = 1.0f;
+
+    uint8_t getSortBits() const; // Draws with equal state sort next to each other
+};
+
+// One recorded draw: everything needed to issue it later, in any order
+struct RenderCommand {
+    GLuint program = 0;
+    GLuint vao = 0;
+    RenderState state;
+    GLint modelLocation = -1;         // -1: the program has no model matrix
+    glm::mat4 model = glm::mat4(1.0f);
+    // Per-draw data (a chunk's block offset) the vertex shader reads from the RenderQueue's per-draw
+    // uniform block, at the index the queue sets in the drawIdLocation uniform. -1: not used.
+    GLint drawIdLocation = -1;
+    glm::ivec4 perDrawData = glm::ivec4(0);
+
+    GLenum mode = GL_TRIANGLES;
+    bool indexed = false;             // glDrawElements with 32-bit indices from the VAO's element buffer
+    GLint first = 0;                  // First vertex (arrays) or first index (indexed)
+    GLsizei count = 0;                // Vertices or indices
+};
+
+// A frame's draws, recorded first and then issued sorted by a 64-bit key:
+//
+//   layer (4 bits) | program (8) | state (8) | depth (24) | submission order (20)
+//
+// so everything drawn with the same program and state runs together, the world before overlays
+// and the HUD, and opaque draws go front to back (cheaper for the depth test). Commands of one
+// chunk share its depth and stay adjacent, so their VAO is bound once.
+//
+// Per-draw data is packed in execution order into one uniform buffer, uploaded once per execute().
+// Shaders see it a page at a time as
+//     layout(std140) uniform PerDraw { ivec4 u_perDraw[PER_DRAW_PAGE_ENTRIES]; };
+// indexed by an int uniform: GL 3.3 has no gl_DrawID, so setting that int is the one uniform
+// call left per draw (skipped when consecutive draws share their data, like a chunk's buckets).
+class RenderQueue {
+public:
+    static const GLuint PER_DRAW_BINDING = 1;     // Uniform buffer binding point of the PerDraw block
+    static const int PER_DRAW_PAGE_ENTRIES = 1024; // 16 KB, the smallest GL_MAX_UNIFORM_BLOCK_SIZE allowed
+
+    enum Layer {
+        LAYER_WORLD = 0,   // Depth-tested scene
+        LAYER_OVERLAY = 1, // Drawn over the scene (block outline)
+        LAYER_HUD = 2      // Screen space (crosshair)
+    };
+
+    static constexpr float MAX_SORT_DEPTH = 4096.0f; // Distances beyond this sort as equal
+
+    RenderQueue();
+
+    // Buffer for the per-draw data; offsetAlignment is GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    void setPerDrawBuffer(GLuint buffer, size_t offsetAlignment);
+
+    // depth: distance from the camera (only orders draws within a layer, program and state)
+    void submit(Layer layer, float depth, const RenderCommand& command);
+
+    // Sorts and issues every recorded command through state, then clears the queue
+    void execute(GlStateCache& state);
+
+    size_t size() const { return m_entries.size(); }
+    void clear() { m_entries.clear(); }
+
+private:
+    struct Entry {
+        uint64_t key;
+        RenderCommand command;
+        int drawId;  // Index into the page, assigned after sorting
+        int page;
+    };
+
+    void packPerDrawData(); // Assigns drawId/page in execution order and fills m_perDrawData
+
+    std::vector<Entry> m_entries; // Capacity reused between frames
+    GLuint m_perDrawBuffer;
+    size_t m_pageStride;                  // Bytes between pages (a page rounded up to the offset alignment)
+    std::vector<glm::ivec4> m_perDrawData; // Pages back to back, m_pageStride apart
+};
+
+#endif // RENDERQUEUE_H
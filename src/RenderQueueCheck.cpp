@@ -0,0 +1,122 @@
+// RenderQueueCheck: runs a frame's worth of RenderQueue commands through GlStateCache on a
+// RecordingGlBackend (no window, no GPU) and checks the GL calls that come out: sorted by layer,
+// program and state, opaque draws front to back, and no redundant program, VAO, state or uniform
+// calls. Exits with 1 and lists the failed checks if anything is off.
+#include "RenderQueue.h"
+#include "GlBackend.h"
+#include "GlStateCache.h"
+#include <iostream>
+#include <vector>
+
+static int g_failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (condition) return;
+    std::cerr << "FAILED: " << what << std::endl;
+    ++g_failures;
+}
+
+static const GLuint CHUNK_PROGRAM = 1;
+static const GLuint OUTLINE_PROGRAM = 2;
+static const GLuint HUD_PROGRAM = 3;
+static const GLuint PER_DRAW_BUFFER = 7;
+static const GLint DRAW_ID_LOCATION = 4;
+static const GLint MODEL_LOCATION = 5;
+static const int CHUNK_COUNT = 3;
+static const int BUCKETS_PER_CHUNK = 2; // Direction groups of one chunk mesh: same VAO, same per-draw data
+
+// The frame the renderer would submit, deliberately out of order: HUD first, chunks far to near
+static void submitFrame(RenderQueue& queue) {
+    RenderCommand hud;
+    hud.program = HUD_PROGRAM;
+    hud.vao = 30;
+    hud.state.depthTest = false;
+    hud.count = 4;
+    queue.submit(RenderQueue::LAYER_HUD, 0.0f, hud);
+
+    for (int chunk = CHUNK_COUNT - 1; chunk >= 0; --chunk) {
+        for (int bucket = 0; bucket < BUCKETS_PER_CHUNK; ++bucket) {
+            RenderCommand command;
+            command.program = CHUNK_PROGRAM;
+            command.vao = 10 + chunk;
+            command.drawIdLocation = DRAW_ID_LOCATION;
+            command.perDrawData = glm::ivec4(chunk * 16, 0, 0, 0);
+            command.indexed = true;
+            command.first = bucket * 600;
+            command.count = 600;
+            queue.submit(RenderQueue::LAYER_WORLD, 10.0f + chunk * 16.0f, command);
+        }
+    }
+
+    RenderCommand outline;
+    outline.program = OUTLINE_PROGRAM;
+    outline.vao = 20;
+    outline.state.depthTest = false;
+    outline.state.blend = true;
+    outline.state.wireframe = true;
+    outline.state.lineWidth = 2.0f;
+    outline.modelLocation = MODEL_LOCATION;
+    outline.model[3] = glm::vec4(1.0f, 2.0f, 3.0f, 1.0f);
+    outline.mode = GL_LINES;
+    outline.count = 24;
+    queue.submit(RenderQueue::LAYER_OVERLAY, 5.0f, outline);
+}
+
+int main() {
+    using CallType = RecordingGlBackend::CallType;
+    RecordingGlBackend backend;
+    GlStateCache state(backend);
+    RenderQueue queue;
+    queue.setPerDrawBuffer(PER_DRAW_BUFFER, 256);
+
+    // First frame, nothing cached yet
+    submitFrame(queue);
+    queue.execute(state);
+    check(queue.size() == 0, "execute() empties the queue");
+
+    const int drawCount = CHUNK_COUNT * BUCKETS_PER_CHUNK + 2;
+    check(backend.getCallCount(CallType::DrawElements) == CHUNK_COUNT * BUCKETS_PER_CHUNK, "one indexed draw per chunk bucket");
+    check(backend.getCallCount(CallType::DrawArrays) == 2, "one array draw each for outline and HUD");
+    check(backend.getCallCount(CallType::UseProgram) == 3, "each program used once");
+    check(backend.getCallCount(CallType::BindVertexArray) == CHUNK_COUNT + 2, "each VAO bound once, a chunk's buckets share it");
+    // Chunks: depth test on, blend off. Outline: both flip. HUD: blend back off.
+    check(backend.getCallCount(CallType::SetCapability) == 5, "depth test and blend set only when they change");
+    check(backend.getCallCount(CallType::PolygonMode) == 3, "polygon mode set only when it changes");
+    check(backend.getCallCount(CallType::LineWidth) == 3, "line width set only when it changes");
+    check(backend.getCallCount(CallType::UniformMatrix4) == 1, "model matrix only for the draw that has one");
+    check(backend.getCallCount(CallType::UploadUniformBuffer) == 1, "per-draw data uploaded once per frame");
+    check(backend.getCallCount(CallType::BindUniformBufferRange) == 1, "one per-draw page bound");
+    check(backend.getCallCount(CallType::Uniform1i) == CHUNK_COUNT, "draw index set once per chunk");
+
+    // Order: programs in layer order, chunk VAOs nearest first
+    std::vector<int64_t> programs, vaos;
+    int draws = 0;
+    for (const RecordingGlBackend::Call& call : backend.getCalls()) {
+        if (call.type == CallType::UseProgram) programs.push_back(call.args[0]);
+        if (call.type == CallType::BindVertexArray) vaos.push_back(call.args[0]);
+        if (call.type == CallType::DrawArrays || call.type == CallType::DrawElements) ++draws;
+    }
+    check(draws == drawCount, "every command drawn");
+    check(programs == std::vector<int64_t>({CHUNK_PROGRAM, OUTLINE_PROGRAM, HUD_PROGRAM}), "world, overlay, HUD order");
+    check(vaos == std::vector<int64_t>({10, 11, 12, 20, 30}), "opaque chunks front to back");
+
+    // Second frame with the same cache: state that differs from where the last frame ended is set
+    // again, the rest (model matrix, per-draw binding) is reused
+    backend.reset();
+    state.resetCounters();
+    submitFrame(queue);
+    queue.execute(state);
+    check(backend.getCallCount(CallType::UseProgram) == 3, "programs switch in the same order next frame");
+    check(backend.getCallCount(CallType::UniformMatrix4) == 0, "unchanged model matrix skipped next frame");
+    check(backend.getCallCount(CallType::Uniform1i) == CHUNK_COUNT, "draw index still set once per chunk next frame");
+    check(backend.getCallCount(CallType::BindUniformBufferRange) == 0, "unchanged per-draw page binding skipped next frame");
+    check(state.getSkippedCount() > 0, "the cache drops redundant calls");
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "RenderQueueCheck: all checks passed (" << backend.getCallCount() << " GL calls in the second frame, "
+              << state.getSkippedCount() << " skipped by the cache)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,161 @@
+#define GLFW_INCLUDE_NONE
+#include "RenderThread.h"
+#include "Renderer.h"
+#include "TextRenderer.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/gtc/matrix_transform.hpp> // For glm::lookAt
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+RenderThread::RenderThread() : m_running(false), m_framesPerSecond(0.0f), m_nextSequence(1) {}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+bool RenderThread::start(GLFWwindow* window, int windowWidth, int windowHeight) {
+    if (m_thread.joinable()) return true;
+
+    std::promise<bool> initResult;
+    std::future<bool> initDone = initResult.get_future();
+    m_running = true;
+    m_thread = std::thread(&RenderThread::run, this, window, windowWidth, windowHeight, std::move(initResult));
+
+    // Only startup waits for the render thread
+    if (!initDone.get()) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void RenderThread::stop() {
+    m_running = false;
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void RenderThread::publishSnapshot() {
+    m_snapshots.beginWrite().sequence = m_nextSequence++;
+    m_snapshots.publish();
+}
+
+void RenderThread::run(GLFWwindow* window, int windowWidth, int windowHeight, std::promise<bool> initResult) {
+    // The GL context lives on this thread for its whole lifetime
+    glfwMakeContextCurrent(window);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        glfwMakeContextCurrent(nullptr);
+        initResult.set_value(false);
+        return;
+    }
+    glfwSwapInterval(1); // vsync paces this thread
+    glViewport(0, 0, windowWidth, windowHeight);
+    std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
+
+    Renderer renderer;
+    if (!renderer.init(windowWidth, windowHeight, window)) {
+        std::cerr << "Failed to initialize Renderer" << std::endl;
+        glfwMakeContextCurrent(nullptr);
+        initResult.set_value(false);
+        return;
+    }
+    TextRenderer* textRenderer = new TextRenderer(renderer.getStateCache(), windowWidth, windowHeight);
+    initResult.set_value(true);
+
+    int viewportWidth = windowWidth;
+    int viewportHeight = windowHeight;
+    double fpsWindowStart = glfwGetTime();
+    int framesThisWindow = 0;
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        m_snapshots.update(); // Newest snapshot if one arrived, otherwise keep drawing the last
+        const FrameSnapshot& snapshot = m_snapshots.read();
+
+        if (snapshot.sequence != 0 && snapshot.windowHeight > 0 &&
+            (snapshot.windowWidth != viewportWidth || snapshot.windowHeight != viewportHeight)) {
+            viewportWidth = snapshot.windowWidth;
+            viewportHeight = snapshot.windowHeight;
+            renderer.setViewport(0, 0, viewportWidth, viewportHeight);
+            textRenderer->setWindowSize(viewportWidth, viewportHeight);
+        }
+
+        // Interpolate the camera with this thread's clock so motion stays smooth even when
+        // several frames are drawn from the same snapshot.
+        double now = glfwGetTime();
+        float alpha = 1.0f;
+        if (snapshot.tickDuration > 0.0) {
+            alpha = glm::clamp(static_cast<float>((now - snapshot.tickTime) / snapshot.tickDuration), 0.0f, 1.0f);
+        }
+        glm::vec3 cameraPosition = glm::mix(snapshot.previousTickPosition, snapshot.cameraPosition, alpha);
+        glm::mat4 view = glm::lookAt(cameraPosition, cameraPosition + snapshot.cameraFront, snapshot.cameraUp);
+
+        renderer.beginFrame(view, snapshot.projection, cameraPosition);
+        for (const FrameSnapshot::ChunkDrawItem& item : snapshot.chunks) {
+            renderer.drawChunk(item.chunkCoord, *item.mesh);
+        }
+        for (const FrameSnapshot::EntityBox& box : snapshot.entities) {
+            renderer.drawBox(box.min, box.max);
+        }
+        if (snapshot.showOutline) {
+            renderer.drawBlockOutline(snapshot.outlinePos);
+        }
+        renderer.drawCrosshair();
+        renderer.flush();
+
+        // Render Debug Text (F3 screen). Every draw sets the state it needs, so nothing is restored afterwards.
+        if (snapshot.showOverlay) {
+            GlStateCache& state = renderer.getStateCache();
+            uint64_t stateCallsIssued = state.getIssuedCount();
+            uint64_t stateCallsSkipped = state.getSkippedCount();
+            state.setEnabled(GL_BLEND, true);
+            state.setEnabled(GL_DEPTH_TEST, false);
+            state.setPolygonMode(GL_FILL);
+
+            float yPos = viewportHeight - 20.0f; // Start from top
+            float lineHeight = 20.0f; // Adjust as needed based on font size and scale
+            float textScale = 0.7f;
+
+            // FPS is measured here, everything else comes from the simulation thread
+            std::ostringstream oss;
+            oss << "FPS: " << std::fixed << std::setprecision(1) << getFramesPerSecond();
+            textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, glm::vec3(1.0f));
+            yPos -= lineHeight;
+            oss.str("");
+            oss << "Quads: " << renderer.getSubmittedQuadCount() << " drawn of " << renderer.getMeshQuadCount()
+                << " (rest face away from the camera)";
+            textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, glm::vec3(1.0f));
+            yPos -= lineHeight;
+            oss.str("");
+            oss << "GL state calls: " << stateCallsIssued << " issued, " << stateCallsSkipped << " skipped (world and HUD)";
+            textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, glm::vec3(1.0f));
+            yPos -= lineHeight;
+
+            for (const FrameSnapshot::OverlayLine& line : snapshot.overlayLines) {
+                textRenderer->renderText(line.text, 10.0f, yPos, textScale, line.color);
+                yPos -= lineHeight;
+            }
+        }
+
+        renderer.endFrame();
+        glfwSwapBuffers(window);
+
+        ++framesThisWindow;
+        double elapsed = glfwGetTime() - fpsWindowStart;
+        if (elapsed >= 0.5) {
+            m_framesPerSecond.store(static_cast<float>(framesThisWindow / elapsed), std::memory_order_relaxed);
+            framesThisWindow = 0;
+            fpsWindowStart += elapsed;
+        }
+    }
+
+    // Release GL objects while the context is still current
+    delete textRenderer;
+    renderer.cleanup();
+    glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,46 @@
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include "FrameSnapshot.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <future>
+#include <thread>
+
+struct GLFWwindow;
+
+// Owns the OpenGL context and draws FrameSnapshots on its own thread.
+// The simulation thread fills a snapshot with beginSnapshot()/publishSnapshot(); the render
+// thread always draws the newest one (redrawing the previous one with a freshly interpolated
+// camera if nothing new arrived). Neither thread waits for the other: a slow tick doesn't drop
+// the frame rate and a slow frame (vsync, GPU stall) doesn't delay the simulation.
+class RenderThread {
+public:
+    RenderThread();
+    ~RenderThread();
+
+    // Starts the thread, makes the window's context current on it and initializes the
+    // renderers. Blocks until that is done; returns false if initialization failed.
+    bool start(GLFWwindow* window, int windowWidth, int windowHeight);
+    // Stops the thread after its current frame and releases all GL resources.
+    void stop();
+
+    // --- Simulation thread side ---
+    FrameSnapshot& beginSnapshot() { return m_snapshots.beginWrite(); }
+    void publishSnapshot();
+
+    // Frames per second measured on the render thread
+    float getFramesPerSecond() const { return m_framesPerSecond.load(std::memory_order_relaxed); }
+
+private:
+    void run(GLFWwindow* window, int windowWidth, int windowHeight, std::promise<bool> initResult);
+
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<float> m_framesPerSecond;
+
+    TripleBuffer<FrameSnapshot> m_snapshots;
+    uint64_t m_nextSequence; // Simulation thread only
+};
+
+#endif // RENDERTHREAD_H
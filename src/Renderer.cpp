@@ -1,7 +1,7 @@
 #include "Renderer.h"
 #include "Shader.h"
-#include "Camera.h"
-#include "Chunk.h" // Include Chunk for its definition
+#include "Chunk.h" // For chunk dimensions
+#include "MemoryStats.h"
 
 // GLAD must be included before GLFW if we need GL functions here
 // For now, we only need GLFW for window pointer and glad for glClear etc.
@@ -9,18 +9,25 @@
 #include <GLFW/glfw3.h> // For GLFWwindow type, glfwSwapBuffers if we move it here
 
 #include <iostream> // For error reporting
-// #include <vector> // No longer needed for blockVertices
+#include <vector> // For the quad index buffer
+#include <algorithm> // For std::fill
 #include <glm/gtc/matrix_transform.hpp> // For glm::translate, glm::rotate, glm::scale
 #include <glm/gtc/type_ptr.hpp> // For glm::value_ptr if needed for uniforms
 
 // blockVertices array removed from here. It's temporarily in Chunk.cpp
 
-Renderer::Renderer() : m_shader(nullptr), m_crosshairShader(nullptr), 
+// Size of the shared quad index buffer (m_quadEBO)
+static const size_t QUAD_INDEX_BYTES = ChunkMesh::MAX_QUADS * ChunkMesh::INDICES_PER_QUAD * sizeof(GLuint);
+
+Renderer::Renderer() : m_shader(nullptr), m_crosshairShader(nullptr), m_chunkShader(nullptr),
+                       m_state(m_backend),
+                       m_modelLocation(-1), m_drawIdLocation(-1), m_cameraUBO(0), m_perDrawUBO(0),
                        m_outlineVAO(0), m_outlineVBO(0),
-                       m_crosshairVAO(0), m_crosshairVBO(0),
-                       m_viewMatrix(1.0f) {
+                       m_crosshairVAO(0), m_crosshairVBO(0), m_quadEBO(0),
+                       m_frameIndex(0), m_cameraPosition(0.0f), m_submittedQuads(0), m_meshQuads(0),
+                       m_trackedMapBytes(0), m_viewProjection(1.0f) {
     // m_blockVAO and m_blockVBO removed
-    // m_viewMatrix and m_projectionMatrix initialized by beginFrame
+    // m_viewProjection initialized by beginFrame
 }
 
 Renderer::~Renderer() {
@@ -43,10 +50,31 @@ bool Renderer::init(int windowWidth, int windowHeight, GLFWwindow* windowHandle)
         return false;
     }
 
+    m_chunkShader = new Shader();
+    if (!m_chunkShader->load("shaders/chunk.vert", "shaders/simple.frag")) {
+        std::cerr << "Renderer Error: Failed to load chunk shaders!" << std::endl;
+        delete m_chunkShader; m_chunkShader = nullptr;
+        delete m_crosshairShader; m_crosshairShader = nullptr;
+        delete m_shader; m_shader = nullptr;
+        return false;
+    }
+
     setViewport(0, 0, windowWidth, windowHeight); 
-    glEnable(GL_DEPTH_TEST);
-    //glEnable(GL_BLEND); // For potentially transparent UI elements later
-    //glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); // Blending itself is enabled per draw (F3 text)
+
+    // Uniform locations never change after linking, so look them up once
+    m_modelLocation = m_shader->getUniformLocation("model");
+    m_drawIdLocation = m_chunkShader->getUniformLocation("u_drawId");
+
+    // Uniform buffers: camera data once per frame for every program, chunk offsets through the render queue
+    m_shader->bindUniformBlock("Camera", CAMERA_BINDING);
+    m_chunkShader->bindUniformBlock("Camera", CAMERA_BINDING);
+    m_chunkShader->bindUniformBlock("PerDraw", RenderQueue::PER_DRAW_BINDING);
+    glGenBuffers(1, &m_cameraUBO);
+    glGenBuffers(1, &m_perDrawUBO);
+    GLint uniformOffsetAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformOffsetAlignment);
+    m_queue.setPerDrawBuffer(m_perDrawUBO, static_cast<size_t>(uniformOffsetAlignment));
 
     // Setup VAO/VBO for block outline (wireframe cube)
     float outlineVertices[] = {
@@ -93,89 +121,221 @@ bool Renderer::init(int windowWidth, int windowHeight, GLFWwindow* windowHandle)
     glEnableVertexAttribArray(0);
     glBindVertexArray(0);
 
+    // Quad index buffer for chunk meshes. 32-bit indices: a full mesh has up to 4 * MAX_QUADS vertices, past 65536.
+    std::vector<GLuint> quadIndices(ChunkMesh::MAX_QUADS * ChunkMesh::INDICES_PER_QUAD);
+    for (int quad = 0; quad < ChunkMesh::MAX_QUADS; ++quad) {
+        GLuint first = static_cast<GLuint>(quad * ChunkMesh::VERTICES_PER_QUAD);
+        GLuint* indices = &quadIndices[quad * ChunkMesh::INDICES_PER_QUAD];
+        indices[0] = first;     indices[1] = first + 1; indices[2] = first + 2;
+        indices[3] = first + 2; indices[4] = first + 3; indices[5] = first;
+    }
+    glGenBuffers(1, &m_quadEBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quadEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, quadIndices.size() * sizeof(GLuint), quadIndices.data(), GL_STATIC_DRAW);
+    MemoryStats::add(MemoryCategory::GpuBuffers, QUAD_INDEX_BYTES);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    m_state.invalidate(); // The setup above bound VAOs behind the cache's back
     return true;
 }
 
-void Renderer::beginFrame(const Camera& camera) {
-    glClearColor(0.529f, 0.808f, 0.922f, 1.0f); // A nice sky blue
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+void Renderer::beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPosition) {
+    ++m_frameIndex;
+    m_cameraPosition = cameraPosition;
+    m_submittedQuads = 0;
+    m_meshQuads = 0;
+    m_state.resetCounters();
+    m_queue.clear();
+    m_backend.clear(0.529f, 0.808f, 0.922f, 1.0f, GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // A nice sky blue
 
-    if (!m_shader) return;
-
-    m_shader->use(); // Use shader before setting uniforms
-    m_viewMatrix = camera.GetViewMatrix();
-    // Get projection matrix from camera
-    glm::mat4 projectionMatrix = camera.GetProjectionMatrix(); 
-    
-    m_shader->setMat4("view", m_viewMatrix);
-    m_shader->setMat4("projection", projectionMatrix); // Use camera's projection matrix
+    // Uploaded in flush(), before the frame's first draw
+    m_viewProjection = projection * view;
 }
 
 void Renderer::endFrame() {
-    // Currently, buffer swapping and event polling are handled in main.cpp
+    // Buffer swapping is handled by the render thread.
+    // Meshes not drawn this frame belong to chunks that were remeshed or unloaded.
+    for (auto it = m_gpuMeshes.begin(); it != m_gpuMeshes.end(); ) {
+        if (it->second.lastDrawnFrame != m_frameIndex) {
+            deleteGpuMesh(it->second);
+            it = m_gpuMeshes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    size_t mapBytes = MemoryStats::hashMapBytes(m_gpuMeshes);
+    MemoryStats::resize(MemoryCategory::MapOverhead, m_trackedMapBytes, mapBytes);
+    m_trackedMapBytes = mapBytes;
 }
 
-void Renderer::drawChunk(const Chunk& chunk) {
-    if (!m_shader || !chunk.hasMesh() || chunk.getVAO() == 0 || chunk.getVertexCount() == 0) {
+Renderer::GpuMesh& Renderer::getOrUploadMesh(const ChunkMesh& mesh) {
+    GpuMesh& gpuMesh = m_gpuMeshes[mesh.id];
+    if (gpuMesh.vao == 0 && mesh.vertexCount > 0) {
+        glGenVertexArrays(1, &gpuMesh.vao);
+        glGenBuffers(1, &gpuMesh.vbo);
+
+        m_state.bindVertexArray(gpuMesh.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, gpuMesh.vbo);
+        glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float), mesh.vertices.data(), GL_STATIC_DRAW);
+        gpuMesh.bytes = mesh.vertices.size() * sizeof(float);
+        MemoryStats::add(MemoryCategory::GpuBuffers, gpuMesh.bytes);
+
+        const GLsizei stride = ChunkMesh::FLOATS_PER_VERTEX * sizeof(float);
+        // Position attribute
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+        glEnableVertexAttribArray(0);
+        // Color attribute
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+        // The element buffer binding is VAO state, so every chunk VAO points at the shared quad indices
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quadEBO);
+
+        m_state.bindVertexArray(0); // Unbind the VAO first so it keeps its element buffer
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        for (int i = 0; i <= ChunkMesh::DIRECTION_COUNT; ++i) {
+            gpuMesh.directionStart[i] = mesh.directionStart[i];
+        }
+        if (mesh.directionStart[ChunkMesh::DIRECTION_COUNT] > ChunkMesh::MAX_QUADS) {
+            // The mesher can't produce this; drawing it would read past the shared index buffer
+            std::cerr << "Renderer Error: mesh " << mesh.id << " has " << mesh.directionStart[ChunkMesh::DIRECTION_COUNT]
+                      << " quads, more than ChunkMesh::MAX_QUADS (" << ChunkMesh::MAX_QUADS << "); not drawn" << std::endl;
+            std::fill(gpuMesh.directionStart, gpuMesh.directionStart + ChunkMesh::DIRECTION_COUNT + 1, 0);
+        }
+    }
+    gpuMesh.lastDrawnFrame = m_frameIndex;
+    return gpuMesh;
+}
+
+void Renderer::deleteGpuMesh(GpuMesh& gpuMesh) {
+    if (gpuMesh.vao != 0) {
+        m_state.onVertexArrayDeleted(gpuMesh.vao);
+        glDeleteBuffers(1, &gpuMesh.vbo);
+        glDeleteVertexArrays(1, &gpuMesh.vao);
+        MemoryStats::remove(MemoryCategory::GpuBuffers, gpuMesh.bytes);
+        gpuMesh.vao = 0;
+        gpuMesh.vbo = 0;
+        gpuMesh.bytes = 0;
+    }
+}
+
+void Renderer::drawChunk(const glm::ivec3& chunkCoord, const ChunkMesh& mesh) {
+    if (!m_chunkShader || mesh.vertexCount == 0) {
         return; 
     }
 
-    m_shader->use(); // Ensure shader is active
+    const GpuMesh& gpuMesh = getOrUploadMesh(mesh);
 
-    glm::mat4 model = glm::mat4(1.0f);
-    glm::vec3 chunkWorldPos = chunk.getWorldPosition();
-    model = glm::translate(model, glm::vec3(chunkWorldPos.x * Chunk::CHUNK_WIDTH,
-                                           chunkWorldPos.y * Chunk::CHUNK_HEIGHT,
-                                           chunkWorldPos.z * Chunk::CHUNK_DEPTH));
-    
-    m_shader->setMat4("model", model);
+    // Mesh vertices are chunk-local; the shader adds the chunk's block offset (no model matrix)
+    glm::ivec3 blockOffset = chunkCoord * glm::ivec3(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH);
+    glm::vec3 chunkOrigin = glm::vec3(blockOffset);
+    RenderCommand command;
+    command.program = m_chunkShader->ID;
+    command.vao = gpuMesh.vao;
+    command.drawIdLocation = m_drawIdLocation;
+    command.perDrawData = glm::ivec4(blockOffset, 0);
+    command.indexed = true;
+    float depth = glm::length(chunkOrigin + glm::vec3(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH) * 0.5f - m_cameraPosition);
 
-    glBindVertexArray(chunk.getVAO());
-    glDrawArrays(GL_TRIANGLES, 0, chunk.getVertexCount());
-    glBindVertexArray(0);
+    // A face pointing in +X lies on a plane at or right of the chunk's min X, so it can only be seen from
+    // a camera beyond that; likewise for the other directions. The chunk spans [origin - 0.5, origin + size - 0.5)
+    // since blocks are drawn centered on their coordinates.
+    glm::vec3 chunkMin = chunkOrigin - 0.5f;
+    glm::vec3 chunkMax = chunkMin + glm::vec3(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH);
+    bool visible[ChunkMesh::DIRECTION_COUNT];
+    for (int axis = 0; axis < 3; ++axis) {
+        visible[axis * 2] = m_cameraPosition[axis] > chunkMin[axis];     // +X, +Y, +Z
+        visible[axis * 2 + 1] = m_cameraPosition[axis] < chunkMax[axis]; // -X, -Y, -Z
+    }
+
+    // Buckets are contiguous, so neighboring visible ones go out as a single draw
+    int direction = 0;
+    while (direction < ChunkMesh::DIRECTION_COUNT) {
+        if (!visible[direction]) { ++direction; continue; }
+        int firstQuad = gpuMesh.directionStart[direction];
+        while (direction < ChunkMesh::DIRECTION_COUNT && visible[direction]) ++direction;
+        int quadCount = gpuMesh.directionStart[direction] - firstQuad;
+        if (quadCount > 0) {
+            command.first = firstQuad * ChunkMesh::INDICES_PER_QUAD;
+            command.count = quadCount * ChunkMesh::INDICES_PER_QUAD;
+            m_queue.submit(RenderQueue::LAYER_WORLD, depth, command);
+            m_submittedQuads += quadCount;
+        }
+    }
+    m_meshQuads += gpuMesh.directionStart[ChunkMesh::DIRECTION_COUNT];
 }
 
 void Renderer::drawBlockOutline(const glm::ivec3& blockWorldPos) {
     if (!m_shader || m_outlineVAO == 0) return;
 
-    m_shader->use(); // Use the main 3D shader
+    RenderCommand command;
+    command.program = m_shader->ID; // The main 3D shader
+    command.vao = m_outlineVAO;
+    command.modelLocation = m_modelLocation;
+    command.model = glm::translate(glm::mat4(1.0f), glm::vec3(blockWorldPos)); // Align to blockWorldPos directly
+    command.model = glm::scale(command.model, glm::vec3(1.002f)); // Slightly scale up
+    command.state.depthTest = false; // Draw outline on top of everything
+    command.state.wireframe = true;
+    command.state.lineWidth = 2.0f; // Make lines a bit thicker
+    command.mode = GL_LINES;
+    command.count = 24; // 12 lines * 2 vertices per line
+    m_queue.submit(RenderQueue::LAYER_OVERLAY, 0.0f, command);
+}
 
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(blockWorldPos)); // Align to blockWorldPos directly
-    model = glm::scale(model, glm::vec3(1.002f)); // Slightly scale up
-    
-    m_shader->setMat4("model", model);
+void Renderer::drawBox(const glm::vec3& min, const glm::vec3& max) {
+    if (!m_shader || m_outlineVAO == 0) return;
 
-    glDisable(GL_DEPTH_TEST); // Draw outline on top of everything
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE); // Draw in wireframe mode
-    glLineWidth(2.0f); // Make lines a bit thicker
-    glBindVertexArray(m_outlineVAO);
-    glDrawArrays(GL_LINES, 0, 24); // 12 lines * 2 vertices per line
-    glBindVertexArray(0);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL); // Reset to fill mode
-    glLineWidth(1.0f); // Reset line width
-    glEnable(GL_DEPTH_TEST); // Re-enable depth testing
+    // Blocks are drawn centered on their integer coordinates, so shift physics boxes by half a block to match
+    glm::vec3 center = (min + max) * 0.5f - glm::vec3(0.5f);
+    RenderCommand command;
+    command.program = m_shader->ID;
+    command.vao = m_outlineVAO;
+    command.modelLocation = m_modelLocation;
+    command.model = glm::scale(glm::translate(glm::mat4(1.0f), center), max - min);
+    command.state.wireframe = true;
+    command.mode = GL_LINES;
+    command.count = 24;
+    m_queue.submit(RenderQueue::LAYER_WORLD, glm::length(center - m_cameraPosition), command);
 }
 
 void Renderer::drawCrosshair() {
     if (!m_crosshairShader || m_crosshairVAO == 0) return;
 
-    // Crosshair is 2D, doesn't need view/projection from camera typically
-    // It also should be drawn last, without depth testing if it needs to be on top
-    glDisable(GL_DEPTH_TEST); // Draw on top of everything
-    m_crosshairShader->use();
-    glBindVertexArray(m_crosshairVAO);
-    glDrawArrays(GL_LINES, 0, 4); // 2 lines * 2 vertices per line
-    glBindVertexArray(0);
-    glEnable(GL_DEPTH_TEST); // Re-enable depth testing
+    // Crosshair is 2D, doesn't need view/projection from camera; drawn last, on top of everything
+    RenderCommand command;
+    command.program = m_crosshairShader->ID;
+    command.vao = m_crosshairVAO;
+    command.state.depthTest = false;
+    command.mode = GL_LINES;
+    command.count = 4; // 2 lines * 2 vertices per line
+    m_queue.submit(RenderQueue::LAYER_HUD, 0.0f, command);
+}
+
+void Renderer::flush() {
+    // One upload of the camera for the whole frame, read by every program through the Camera block
+    CameraBlock camera;
+    camera.viewProjection = m_viewProjection;
+    camera.position = glm::vec4(m_cameraPosition, 1.0f);
+    m_backend.uploadUniformBuffer(m_cameraUBO, &camera, sizeof(camera));
+    m_state.bindUniformBufferRange(CAMERA_BINDING, m_cameraUBO, 0, sizeof(camera));
+    m_queue.execute(m_state);
 }
 
 void Renderer::cleanup() {
+    for (auto& pair : m_gpuMeshes) {
+        deleteGpuMesh(pair.second);
+    }
+    m_gpuMeshes.clear();
+    MemoryStats::resize(MemoryCategory::MapOverhead, m_trackedMapBytes, 0);
+    m_trackedMapBytes = 0;
+
     delete m_shader;
     m_shader = nullptr;
     delete m_crosshairShader;
     m_crosshairShader = nullptr;
+    delete m_chunkShader;
+    m_chunkShader = nullptr;
 
+    m_state.invalidate();
     if (m_outlineVAO != 0) {
         glDeleteVertexArrays(1, &m_outlineVAO);
         glDeleteBuffers(1, &m_outlineVBO); // Don't forget to delete buffer too
@@ -186,6 +346,16 @@ void Renderer::cleanup() {
         glDeleteBuffers(1, &m_crosshairVBO);
         m_crosshairVAO = 0; m_crosshairVBO = 0;
     }
+    if (m_quadEBO != 0) {
+        glDeleteBuffers(1, &m_quadEBO);
+        MemoryStats::remove(MemoryCategory::GpuBuffers, QUAD_INDEX_BYTES);
+        m_quadEBO = 0;
+    }
+    if (m_cameraUBO != 0) {
+        glDeleteBuffers(1, &m_cameraUBO);
+        glDeleteBuffers(1, &m_perDrawUBO);
+        m_cameraUBO = 0; m_perDrawUBO = 0;
+    }
 }
 
 void Renderer::setViewport(int x, int y, int width, int height) {
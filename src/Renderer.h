@@ -3,40 +3,95 @@
 
 #include <glad/glad.h> // For GL types if needed, and for function loading
 #include <glm/mat4x4.hpp> // For glm::mat4
+#include <glm/glm.hpp>
+#include "ChunkMesh.h"
+#include "GlBackend.h"
+#include "GlStateCache.h"
+#include "RenderQueue.h"
+#include <unordered_map>
 
 // Forward declarations
 struct GLFWwindow;
 class Shader;
-class Camera;
-class Chunk;
 
 class Renderer {
 public:
+    static const GLuint CAMERA_BINDING = 0; // Uniform buffer binding point of the Camera block
+
     Renderer();
     ~Renderer();
 
     bool init(int windowWidth, int windowHeight, struct GLFWwindow* windowHandle);
-    void beginFrame(const Camera& camera); // Takes camera for view/projection
-    void drawChunk(const Chunk& chunk);    // New method to draw a pre-built chunk mesh
+    // The draw* calls only record commands; flush() sorts them (by program, state and depth) and issues
+    // them through the state cache. Call it once the frame's world and HUD draws are recorded.
+    void beginFrame(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPosition);
+    // Draws a chunk mesh built by Chunk::buildMesh. The mesh is uploaded the first time it is drawn.
+    // Direction groups that can't face the camera from where it is are skipped.
+    void drawChunk(const glm::ivec3& chunkCoord, const ChunkMesh& mesh);
     void drawBlockOutline(const glm::ivec3& blockWorldPos); // For targeted block
+    void drawBox(const glm::vec3& min, const glm::vec3& max); // Wireframe box (entities), depth tested
     void drawCrosshair(); // For aiming reticle
-    void endFrame();
+    void flush();
+    void endFrame(); // Releases GPU buffers of meshes that were not drawn this frame
     void cleanup();
 
     void setViewport(int x, int y, int width, int height);
 
+    // Shared with other render thread drawing (text), so the cached GL state stays accurate
+    GlStateCache& getStateCache() { return m_state; }
+
+    // Quads of the chunk meshes drawn so far this frame: submitted to the GPU, and in total (before direction culling)
+    size_t getSubmittedQuadCount() const { return m_submittedQuads; }
+    size_t getMeshQuadCount() const { return m_meshQuads; }
+
 private:
     Shader* m_shader; // Main 3D shader
     Shader* m_crosshairShader; // Shader for the 2D crosshair
 
+    Shader* m_chunkShader; // Chunk meshes: per-chunk offset from the PerDraw uniform block instead of a model matrix
+
+    OpenGlBackend m_backend;
+    GlStateCache m_state;
+    RenderQueue m_queue;
+    GLint m_modelLocation;  // Uniform of m_shader
+    GLint m_drawIdLocation; // Uniform of m_chunkShader
+
+    // std140 layout of the Camera uniform block (see shaders/simple.vert), uploaded once per frame
+    struct CameraBlock {
+        glm::mat4 viewProjection;
+        glm::vec4 position; // xyz
+    };
+    GLuint m_cameraUBO;
+    GLuint m_perDrawUBO; // Filled by m_queue
+
     // VAO/VBO for block outline (a unit cube wireframe)
     GLuint m_outlineVAO;
     GLuint m_outlineVBO;
     // VAO/VBO for crosshair (two short lines)
     GLuint m_crosshairVAO;
     GLuint m_crosshairVBO;
+    // Index buffer shared by every chunk mesh: two triangles per 4-vertex quad, for ChunkMesh::MAX_QUADS quads
+    GLuint m_quadEBO;
+
+    // GPU copy of a ChunkMesh, keyed by ChunkMesh::id
+    struct GpuMesh {
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        int directionStart[ChunkMesh::DIRECTION_COUNT + 1] = {}; // Copied from the ChunkMesh
+        uint64_t lastDrawnFrame = 0;
+        size_t bytes = 0;                // VBO size, counted in MemoryStats (GpuBuffers)
+    };
+    GpuMesh& getOrUploadMesh(const ChunkMesh& mesh);
+    void deleteGpuMesh(GpuMesh& gpuMesh);
+
+    std::unordered_map<uint64_t, GpuMesh> m_gpuMeshes;
+    uint64_t m_frameIndex;
+    glm::vec3 m_cameraPosition;
+    size_t m_submittedQuads;
+    size_t m_meshQuads;
+    size_t m_trackedMapBytes; // m_gpuMeshes estimate last reported to MemoryStats
 
-    glm::mat4 m_viewMatrix;
+    glm::mat4 m_viewProjection;
     // struct GLFWwindow* m_window; // Not storing window handle for now
 };
 
@@ -65,6 +65,7 @@ bool Shader::load(const char* vertexPath, const char* fragmentPath) {
 
     // Shader Program
     ID = glCreateProgram();
+    m_uniformLocations.clear();
     glAttachShader(ID, vertex);
     glAttachShader(ID, fragment);
     glLinkProgram(ID);
@@ -84,22 +85,37 @@ void Shader::use() const {
     }
 }
 
+GLint Shader::getUniformLocation(const std::string &name) const {
+    auto it = m_uniformLocations.find(name);
+    if (it != m_uniformLocations.end()) return it->second;
+    GLint location = glGetUniformLocation(ID, name.c_str());
+    m_uniformLocations.emplace(name, location);
+    return location;
+}
+
+bool Shader::bindUniformBlock(const char* blockName, GLuint bindingPoint) const {
+    GLuint blockIndex = glGetUniformBlockIndex(ID, blockName);
+    if (blockIndex == GL_INVALID_INDEX) return false;
+    glUniformBlockBinding(ID, blockIndex, bindingPoint);
+    return true;
+}
+
 void Shader::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    glUniform1i(getUniformLocation(name), (int)value);
 }
 void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(getUniformLocation(name), value);
 }
 void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(getUniformLocation(name), value);
 }
 
 void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(value));
+    glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(value));
 }
 
 void Shader::setMat4(const std::string &name, const glm::mat4 &value) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(value));
+    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
 }
 
 bool Shader::checkCompileErrors(GLuint shader, std::string type) {
@@ -2,6 +2,7 @@
 #define SHADER_H
 
 #include <string>
+#include <unordered_map>
 #include <glad/glad.h> // For GLuint and other OpenGL types
 
 // Include actual GLM type definitions instead of forward declaring
@@ -30,9 +31,16 @@ public:
     void setVec3(const std::string &name, const glm::vec3 &value) const;
     void setMat4(const std::string &name, const glm::mat4 &value) const;
 
+    // Location of a uniform, looked up in GL only the first time each name is asked for
+    GLint getUniformLocation(const std::string &name) const;
+    // Connects the named uniform block to a buffer binding point. False if the program has no such block.
+    bool bindUniformBlock(const char* blockName, GLuint bindingPoint) const;
+
 private:
     // Utility function to check for shader compilation/linking errors.
     bool checkCompileErrors(GLuint shader, std::string type);
+
+    mutable std::unordered_map<std::string, GLint> m_uniformLocations; // Valid for the linked program ID
 };
 
 #endif // SHADER_H 
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "SpatialHash.h"
+#include <algorithm> // For std::sort, std::unique
+
+SpatialHash::SpatialHash(float cellSize) : m_cellSize(cellSize), m_inverseCellSize(1.0f / cellSize) {}
+
+uint64_t SpatialHash::cellKey(int x, int y, int z) {
+    // 21 bits per axis (two's complement, masked): plenty for cells of a few blocks
+    const uint64_t mask = (1ull << 21) - 1;
+    return ((static_cast<uint64_t>(x) & mask) << 42) | ((static_cast<uint64_t>(y) & mask) << 21) | (static_cast<uint64_t>(z) & mask);
+}
+
+glm::ivec3 SpatialHash::cellOf(const glm::vec3& point) const {
+    return glm::ivec3(glm::floor(point * m_inverseCellSize));
+}
+
+void SpatialHash::clear() {
+    m_entries.clear();
+    m_cells.clear();
+}
+
+void SpatialHash::insert(uint32_t index, const glm::vec3& min, const glm::vec3& max) {
+    glm::ivec3 minCell = cellOf(min);
+    glm::ivec3 maxCell = cellOf(max);
+    for (int x = minCell.x; x <= maxCell.x; ++x) {
+        for (int y = minCell.y; y <= maxCell.y; ++y) {
+            for (int z = minCell.z; z <= maxCell.z; ++z) {
+                m_entries.emplace_back(cellKey(x, y, z), index);
+            }
+        }
+    }
+}
+
+void SpatialHash::finalize() {
+    std::sort(m_entries.begin(), m_entries.end());
+    m_cells.clear();
+    m_cells.reserve(m_entries.size());
+    uint32_t begin = 0;
+    for (uint32_t i = 1; i <= m_entries.size(); ++i) {
+        if (i == m_entries.size() || m_entries[i].first != m_entries[begin].first) {
+            m_cells.emplace(m_entries[begin].first, std::make_pair(begin, i));
+            begin = i;
+        }
+    }
+}
+
+void SpatialHash::query(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& outIndices) const {
+    size_t firstNew = outIndices.size();
+    glm::ivec3 minCell = cellOf(min);
+    glm::ivec3 maxCell = cellOf(max);
+    for (int x = minCell.x; x <= maxCell.x; ++x) {
+        for (int y = minCell.y; y <= maxCell.y; ++y) {
+            for (int z = minCell.z; z <= maxCell.z; ++z) {
+                auto it = m_cells.find(cellKey(x, y, z));
+                if (it == m_cells.end()) continue;
+                for (uint32_t i = it->second.first; i < it->second.second; ++i) {
+                    outIndices.push_back(m_entries[i].second);
+                }
+            }
+        }
+    }
+    // Items spanning several queried cells were added more than once
+    std::sort(outIndices.begin() + firstNew, outIndices.end());
+    outIndices.erase(std::unique(outIndices.begin() + firstNew, outIndices.end()), outIndices.end());
+}
@@ -0,0 +1,38 @@
+#ifndef SPATIALHASH_H
+#define SPATIALHASH_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Uniform-grid broadphase, rebuilt from scratch every tick.
+// Each item is stored in every cell its box touches. Entries are kept sorted by cell, so a cell's
+// items are one contiguous range and building costs one sort, with no per-cell allocations.
+class SpatialHash {
+public:
+    explicit SpatialHash(float cellSize = 4.0f);
+
+    void clear();
+    // Adds item index with box [min, max]. Call finalize() after the last insert.
+    void insert(uint32_t index, const glm::vec3& min, const glm::vec3& max);
+    void finalize();
+
+    // Appends the items whose cells overlap [min, max] (each at most once). Callers do the exact
+    // box test; this only narrows the candidates.
+    void query(const glm::vec3& min, const glm::vec3& max, std::vector<uint32_t>& outIndices) const;
+
+    float getCellSize() const { return m_cellSize; }
+
+private:
+    static uint64_t cellKey(int x, int y, int z);
+    glm::ivec3 cellOf(const glm::vec3& point) const;
+
+    float m_cellSize;
+    float m_inverseCellSize;
+    std::vector<std::pair<uint64_t, uint32_t>> m_entries; // (cell key, item), sorted by key after finalize()
+    std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> m_cells; // Cell key -> [begin, end) in m_entries
+};
+
+#endif // SPATIALHASH_H
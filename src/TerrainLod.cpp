@@ -0,0 +1,319 @@
+#include "TerrainLod.h"
+#include "World.h"
+#include "Chunk.h"
+#include "MemoryStats.h"
+#include <algorithm> // For std::max
+#include <cmath>     // For std::sqrt
+#include <cstdlib>   // For std::abs
+#include <memory>
+
+static_assert(Chunk::CHUNK_WIDTH == Chunk::CHUNK_HEIGHT && Chunk::CHUNK_WIDTH == Chunk::CHUNK_DEPTH,
+              "BlockMips assumes cubic chunks");
+
+// Blocks that count as terrain at a distance. Torches are too small to show.
+static bool isFilled(BlockType type) {
+    return type != BlockType::Air && type != BlockType::Torch;
+}
+
+// --- BlockMips ---
+
+int BlockMips::sizeOfLevel(int level) {
+    return Chunk::CHUNK_WIDTH >> level;
+}
+
+BlockType BlockMips::getCell(int level, int x, int y, int z) const {
+    int size = sizeOfLevel(level);
+    if (x < 0 || y < 0 || z < 0 || x >= size || y >= size || z >= size) return BlockType::Air;
+    return levels[level - 1][x + y * size + z * size * size];
+}
+
+void BlockMips::build(const BlockType* blocks) {
+    // Every level is taken from the full-resolution blocks, so rounding doesn't accumulate across levels
+    for (int level = 1; level <= LEVEL_COUNT; ++level) {
+        int size = sizeOfLevel(level);
+        int scale = 1 << level;
+        std::vector<BlockType>& cells = levels[level - 1];
+        cells.assign(size * size * size, BlockType::Air);
+        for (int cz = 0; cz < size; ++cz) {
+            for (int cy = 0; cy < size; ++cy) {
+                for (int cx = 0; cx < size; ++cx) {
+                    int filled = 0;
+                    BlockType top = BlockType::Air;
+                    for (int y = cy * scale; y < (cy + 1) * scale; ++y) {
+                        for (int z = cz * scale; z < (cz + 1) * scale; ++z) {
+                            for (int x = cx * scale; x < (cx + 1) * scale; ++x) {
+                                BlockType type = blocks[Chunk::localIndex(x, y, z)];
+                                if (!isFilled(type)) continue;
+                                ++filled;
+                                top = type; // y ascends, so the last one is the highest
+                            }
+                        }
+                    }
+                    if (filled * 2 > scale * scale * scale) {
+                        cells[cx + cy * size + cz * size * size] = top;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// --- TerrainLod ---
+
+TerrainLod::TerrainLod(World& world)
+    : m_world(world), m_center(0), m_hasCenter(false), m_buildQueueHead(0) {
+    const int defaultRadii[LEVEL_COUNT] = { 8, 16, 32, 64 };
+    setRingRadii(defaultRadii);
+    // Far chunks the World has loaded (e.g. edited earlier) take their mips from the World's blocks.
+    // Edited chunks are remembered so unloading them never throws the edits away.
+    m_listenerHandle = m_world.addBlockChangeListener([this](const glm::ivec3& worldBlockPos, BlockType) {
+        glm::ivec3 chunkCoord = World::worldBlockToChunkCoord(worldBlockPos);
+        if (m_chunks.count(chunkCoord)) m_staleMips.insert(chunkCoord);
+        m_editedChunks.insert(chunkCoord);
+    });
+}
+
+TerrainLod::~TerrainLod() {
+    m_world.removeBlockChangeListener(m_listenerHandle);
+    MemoryStats::resize(MemoryCategory::MeshScratch, m_meshKeyScratch.capacity(), 0);
+}
+
+void TerrainLod::setRingRadii(const int ringRadii[LEVEL_COUNT]) {
+    for (int level = 0; level < LEVEL_COUNT; ++level) {
+        m_ringRadii[level] = std::max(ringRadii[level], level > 0 ? m_ringRadii[level - 1] : 0);
+    }
+    if (m_hasCenter) recenter(m_center); // Levels changed everywhere
+}
+
+float TerrainLod::getViewDistance() const {
+    float radius = static_cast<float>((m_ringRadii[LEVEL_COUNT - 1] + 1) * Chunk::CHUNK_WIDTH);
+    return radius * std::sqrt(2.0f);
+}
+
+int TerrainLod::getLevel(const glm::ivec3& chunkCoord) const {
+    if (!m_hasCenter || chunkCoord.y != 0) return -1; // Terrain is one chunk layer (see World::ensureChunkExists)
+    int distance = std::max(std::abs(chunkCoord.x - m_center.x), std::abs(chunkCoord.z - m_center.z));
+    for (int level = 0; level < LEVEL_COUNT; ++level) {
+        if (distance <= m_ringRadii[level]) return level;
+    }
+    return -1;
+}
+
+void TerrainLod::update(const glm::vec3& cameraPosition) {
+    glm::ivec3 center = World::worldBlockToChunkCoord(glm::ivec3(glm::floor(cameraPosition)));
+    center.y = 0;
+    if (!m_hasCenter || center != m_center) {
+        m_hasCenter = true;
+        recenter(center);
+    }
+
+    // Blocks changed in loaded far chunks: refresh their mips
+    for (const glm::ivec3& chunkCoord : m_staleMips) {
+        auto it = m_chunks.find(chunkCoord);
+        Chunk* chunk = m_world.getChunk(chunkCoord);
+        if (it == m_chunks.end() || !chunk || !chunk->isGenerated()) continue;
+        it->second.mips.build(chunk->getBlockData());
+        queueRemeshWithNeighbors(chunkCoord);
+    }
+    m_staleMips.clear();
+
+    // New LOD chunks, nearest first
+    int built = 0;
+    while (m_buildQueueHead < m_buildQueue.size() && built < BUILDS_PER_TICK) {
+        glm::ivec3 chunkCoord = m_buildQueue[m_buildQueueHead++];
+        if (m_chunks.count(chunkCoord) || getLevel(chunkCoord) < 1) continue;
+        buildChunk(chunkCoord);
+        ++built;
+    }
+
+    for (const glm::ivec3& chunkCoord : m_remeshQueue) {
+        auto it = m_chunks.find(chunkCoord);
+        if (it == m_chunks.end()) continue;
+        it->second.inRemeshQueue = false;
+        buildMesh(chunkCoord, it->second);
+    }
+    m_remeshQueue.clear();
+}
+
+void TerrainLod::recenter(const glm::ivec3& centerChunk) {
+    m_center = centerChunk;
+
+    // Ring 0: full-resolution chunks, generated and meshed by World::processWorldUpdates
+    int nearRadius = m_ringRadii[0];
+    for (int dx = -nearRadius; dx <= nearRadius; ++dx) {
+        for (int dz = -nearRadius; dz <= nearRadius; ++dz) {
+            m_world.ensureChunkExists(centerChunk + glm::ivec3(dx, 0, dz));
+        }
+    }
+    unloadFarChunks();
+
+    // Relevel existing LOD chunks; drop those now drawn at full resolution or well past the last ring
+    int farRadius = m_ringRadii[LEVEL_COUNT - 1];
+    std::vector<glm::ivec3> changed;
+    for (auto it = m_chunks.begin(); it != m_chunks.end(); ) {
+        int level = getLevel(it->first);
+        int distance = std::max(std::abs(it->first.x - centerChunk.x), std::abs(it->first.z - centerChunk.z));
+        if (level == 0 || distance > farRadius + UNLOAD_MARGIN) {
+            changed.push_back(it->first);
+            it = m_chunks.erase(it);
+            continue;
+        }
+        if (level > 0 && level != it->second.level) {
+            it->second.level = level;
+            changed.push_back(it->first);
+        }
+        ++it;
+    }
+    for (const glm::ivec3& chunkCoord : changed) {
+        queueRemeshWithNeighbors(chunkCoord); // Seams depend on the neighbors' levels
+    }
+
+    // Queue the missing ones, square ring by square ring outwards
+    m_buildQueue.clear();
+    m_buildQueueHead = 0;
+    for (int distance = nearRadius + 1; distance <= farRadius; ++distance) {
+        for (int dx = -distance; dx <= distance; ++dx) {
+            for (int dz = -distance; dz <= distance; ++dz) {
+                if (std::max(std::abs(dx), std::abs(dz)) != distance) continue;
+                glm::ivec3 chunkCoord = centerChunk + glm::ivec3(dx, 0, dz);
+                if (!m_chunks.count(chunkCoord)) m_buildQueue.push_back(chunkCoord);
+            }
+        }
+    }
+}
+
+void TerrainLod::unloadFarChunks() {
+    int keepRadius = m_ringRadii[0] + UNLOAD_MARGIN;
+    std::vector<glm::ivec3> farChunks;
+    for (const auto& pair : m_world.getLoadedChunks()) {
+        const glm::ivec3& chunkCoord = pair.first;
+        int distance = std::max(std::abs(chunkCoord.x - m_center.x), std::abs(chunkCoord.z - m_center.z));
+        if (distance <= keepRadius || (m_keepLoaded && m_keepLoaded(chunkCoord))) continue;
+        farChunks.push_back(chunkCoord);
+    }
+
+    for (const glm::ivec3& chunkCoord : farChunks) {
+        Chunk* chunk = m_world.getChunk(chunkCoord);
+        if (m_editedChunks.count(chunkCoord)) {
+            // Edits go to the world directory; without one the chunk has nowhere to go and stays loaded
+            if (!chunk->isGenerated() || !m_world.getStorage().saveChunk(*chunk)) continue;
+            m_editedChunks.erase(chunkCoord);
+        }
+        // The LOD rings draw it from now on: take the mips from its blocks while they're still here
+        bool mipsCurrent = m_chunks.count(chunkCoord) && !m_staleMips.count(chunkCoord);
+        if (chunk->isGenerated() && getLevel(chunkCoord) >= 1 && !mipsCurrent) {
+            buildChunk(chunkCoord);
+            m_staleMips.erase(chunkCoord);
+        }
+        m_world.unloadChunk(chunkCoord);
+    }
+}
+
+void TerrainLod::buildChunk(const glm::ivec3& chunkCoord) {
+    LodChunk& lodChunk = m_chunks[chunkCoord];
+    lodChunk.level = getLevel(chunkCoord);
+    Chunk* chunk = m_world.getChunk(chunkCoord);
+    if (chunk && chunk->isGenerated()) {
+        lodChunk.mips.build(chunk->getBlockData());
+    } else if (m_world.getStorage().loadChunk(chunkCoord, m_storageScratch)) {
+        lodChunk.mips.build(m_storageScratch.data()); // Pre-generated, or saved when it was unloaded
+    } else {
+        // Not loaded or stored: generate the terrain only to downsample it
+        Chunk terrain(chunkCoord);
+        terrain.generateSimpleTerrain();
+        lodChunk.mips.build(terrain.getBlockData());
+    }
+    queueRemeshWithNeighbors(chunkCoord); // Neighbors can hide their faces against it now
+}
+
+void TerrainLod::queueRemesh(const glm::ivec3& chunkCoord) {
+    auto it = m_chunks.find(chunkCoord);
+    if (it == m_chunks.end() || it->second.inRemeshQueue) return;
+    it->second.inRemeshQueue = true;
+    m_remeshQueue.push_back(chunkCoord);
+}
+
+void TerrainLod::queueRemeshWithNeighbors(const glm::ivec3& chunkCoord) {
+    queueRemesh(chunkCoord);
+    for (const glm::ivec3& offset : Chunk::NEIGHBOR_OFFSETS) {
+        queueRemesh(chunkCoord + offset);
+    }
+}
+
+void TerrainLod::buildMesh(const glm::ivec3& chunkCoord, LodChunk& lodChunk) {
+    int level = lodChunk.level;
+    int size = BlockMips::sizeOfLevel(level);
+    float scale = static_cast<float>(1 << level);
+
+    // Neighbors at the same level hide border faces; any other neighbor gets skirts
+    const BlockMips* neighborMips[6];
+    for (int direction = 0; direction < 6; ++direction) {
+        auto it = m_chunks.find(chunkCoord + Chunk::NEIGHBOR_OFFSETS[direction]);
+        bool sameLevel = it != m_chunks.end() && it->second.level == level && getLevel(it->first) == level;
+        neighborMips[direction] = sameLevel ? &it->second.mips : nullptr;
+    }
+
+    // Mesh inputs: the level's cells plus, per side, whether it is a skirt or the neighbor's cells
+    // (whole neighbor levels are tiny; at most 8x8x8 cells)
+    size_t scratchCapacity = m_meshKeyScratch.capacity();
+    m_meshKeyScratch.assign({ 'L', static_cast<uint8_t>(level) });
+    const std::vector<BlockType>& cells = lodChunk.mips.levels[level - 1];
+    m_meshKeyScratch.insert(m_meshKeyScratch.end(), reinterpret_cast<const uint8_t*>(cells.data()),
+                            reinterpret_cast<const uint8_t*>(cells.data()) + cells.size());
+    for (const BlockMips* neighbor : neighborMips) {
+        m_meshKeyScratch.push_back(neighbor ? 1 : 0);
+        if (!neighbor) continue;
+        const std::vector<BlockType>& neighborCells = neighbor->levels[level - 1];
+        m_meshKeyScratch.insert(m_meshKeyScratch.end(), reinterpret_cast<const uint8_t*>(neighborCells.data()),
+                                reinterpret_cast<const uint8_t*>(neighborCells.data()) + neighborCells.size());
+    }
+    MemoryStats::resize(MemoryCategory::MeshScratch, scratchCapacity, m_meshKeyScratch.capacity());
+    ChunkMeshCache& cache = m_world.getMeshCache();
+    if (ChunkMeshPtr cached = cache.find(m_meshKeyScratch)) {
+        lodChunk.mesh = cached;
+        return;
+    }
+
+    std::shared_ptr<ChunkMesh> mesh = std::make_shared<ChunkMesh>();
+    mesh->id = allocateChunkMeshId();
+    std::vector<float>& vertices = mesh->vertices;
+    // One pass per direction, so the quads come out grouped by direction (see ChunkMesh::directionStart)
+    for (int direction = 0; direction < 6; ++direction) {
+        mesh->directionStart[direction] = static_cast<int>(vertices.size() / (ChunkMesh::FLOATS_PER_VERTEX * ChunkMesh::VERTICES_PER_QUAD));
+        for (int z = 0; z < size; ++z) {
+            for (int y = 0; y < size; ++y) {
+                for (int x = 0; x < size; ++x) {
+                    BlockType type = lodChunk.mips.getCell(level, x, y, z);
+                    if (type == BlockType::Air) continue;
+                    glm::ivec3 next = glm::ivec3(x, y, z) + Chunk::NEIGHBOR_OFFSETS[direction];
+                    BlockType nextType;
+                    if (next.x >= 0 && next.y >= 0 && next.z >= 0 && next.x < size && next.y < size && next.z < size) {
+                        nextType = lodChunk.mips.getCell(level, next.x, next.y, next.z);
+                    } else if (neighborMips[direction]) {
+                        nextType = neighborMips[direction]->getCell(level, (next.x + size) % size, (next.y + size) % size, (next.z + size) % size);
+                    } else {
+                        nextType = BlockType::Air; // Skirt
+                    }
+                    if (nextType != BlockType::Air) continue;
+
+                    // A cell spans blocks [x * scale, (x + 1) * scale); blocks are drawn centered on their coordinates
+                    glm::vec3 color = Chunk::getFaceColor(type, direction);
+                    const float* face = Chunk::getFaceVertices(direction);
+                    for (int i = 0; i < ChunkMesh::VERTICES_PER_QUAD; ++i) {
+                        vertices.push_back((face[i * 3 + 0] + 0.5f + x) * scale - 0.5f);
+                        vertices.push_back((face[i * 3 + 1] + 0.5f + y) * scale - 0.5f);
+                        vertices.push_back((face[i * 3 + 2] + 0.5f + z) * scale - 0.5f);
+                        vertices.push_back(color.r);
+                        vertices.push_back(color.g);
+                        vertices.push_back(color.b);
+                    }
+                }
+            }
+        }
+    }
+    mesh->vertexCount = static_cast<int>(vertices.size() / ChunkMesh::FLOATS_PER_VERTEX);
+    mesh->directionStart[6] = mesh->vertexCount / ChunkMesh::VERTICES_PER_QUAD;
+    mesh->trackMemory();
+    lodChunk.mesh = std::move(mesh);
+    cache.insert(m_meshKeyScratch, lodChunk.mesh);
+}
@@ -0,0 +1,101 @@
+#ifndef TERRAINLOD_H
+#define TERRAINLOD_H
+
+#include "BlockType.h"
+#include "ChunkMesh.h"
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp> // For std::hash<glm::ivec3>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class World;
+
+// Downsampled copies of a chunk's blocks. Level L (1-3) has one cell per 2^L blocks along each axis:
+// 8x8x8, 4x4x4 and 2x2x2 cells. A cell is filled when more than half of its blocks are, and takes
+// the type of its highest filled block so the surface keeps its color (grass stays green).
+struct BlockMips {
+    static const int LEVEL_COUNT = 3;
+    std::vector<BlockType> levels[LEVEL_COUNT]; // levels[L - 1], indexed x + y * size + z * size * size
+
+    static int sizeOfLevel(int level); // Cells per axis
+    BlockType getCell(int level, int x, int y, int z) const; // Air outside the chunk
+    void build(const BlockType* blocks); // From a full CHUNK_VOLUME block array
+};
+
+// Level of detail for the terrain around the camera.
+//
+// Concentric rings of chunks (square, measured in chunks from the camera's chunk):
+// ring 0 is drawn from the World's full-resolution chunks, which this also loads (radius loader)
+// and unloads again once they are UNLOAD_MARGIN chunks past it, after taking their mips;
+// rings 1-3 use meshes at 2x, 4x and 8x voxel size built from BlockMips. Far chunks that the World
+// hasn't loaded are read from its WorldStorage, or else generated into a temporary chunk just long
+// enough to build their mips, so the horizon costs a few hundred bytes of mips plus a small mesh per chunk.
+//
+// Seams: an LOD chunk hides its border faces only against a neighbor drawn at the same level.
+// Towards a different level it keeps them as skirts, which cover the cracks where the coarser
+// surface doesn't line up with the finer one.
+class TerrainLod {
+public:
+    static const int LEVEL_COUNT = 4;          // 0 = full resolution, 1-3 = LOD
+    static const int BUILDS_PER_TICK = 16;     // New LOD chunks (terrain + mips + mesh) per update()
+    static const int UNLOAD_MARGIN = 2;        // Chunks past ring 0 before World chunks are unloaded, and
+                                               // past the last ring before LOD data is dropped
+
+    struct LodChunk {
+        BlockMips mips;
+        int level = 1;
+        ChunkMeshPtr mesh;          // Null until first meshed
+        bool inRemeshQueue = false;
+    };
+
+    explicit TerrainLod(World& world);
+    ~TerrainLod();
+
+    // ringRadii[L] = how far (in chunks) level L is used. Must increase with L.
+    void setRingRadii(const int ringRadii[LEVEL_COUNT]);
+    int getRingRadius(int level) const { return m_ringRadii[level]; }
+    float getViewDistance() const; // Blocks to the far corner of the last ring, for the far plane
+
+    // Once per tick, before World::tick(): follows the camera, loads ring 0 chunks into the World,
+    // builds queued LOD chunks and remeshes those whose level or neighbors changed.
+    void update(const glm::vec3& cameraPosition);
+
+    // World chunks past ring 0 that keepLoaded returns true for aren't unloaded (e.g. the chunks
+    // ChunkPrefetcher loaded ahead of the camera)
+    using KeepLoadedFilter = std::function<bool(const glm::ivec3& chunkCoord)>;
+    void setKeepLoadedFilter(KeepLoadedFilter keepLoaded) { m_keepLoaded = std::move(keepLoaded); }
+
+    // Level the chunk column is drawn at for the current camera position, -1 if beyond the last ring
+    int getLevel(const glm::ivec3& chunkCoord) const;
+
+    const std::unordered_map<glm::ivec3, LodChunk>& getChunks() const { return m_chunks; }
+    size_t getQueuedBuildCount() const { return m_buildQueue.size() - m_buildQueueHead; }
+
+private:
+    void recenter(const glm::ivec3& centerChunk);
+    void unloadFarChunks();
+    void buildChunk(const glm::ivec3& chunkCoord);
+    void queueRemesh(const glm::ivec3& chunkCoord);
+    void queueRemeshWithNeighbors(const glm::ivec3& chunkCoord);
+    void buildMesh(const glm::ivec3& chunkCoord, LodChunk& lodChunk); // Through the World's mesh cache
+
+    World& m_world;
+    int m_listenerHandle;
+    int m_ringRadii[LEVEL_COUNT];
+    glm::ivec3 m_center;
+    bool m_hasCenter;
+
+    std::unordered_map<glm::ivec3, LodChunk> m_chunks;
+    std::vector<glm::ivec3> m_buildQueue; // Missing LOD chunks, nearest first; rebuilt on recenter
+    size_t m_buildQueueHead;
+    std::vector<glm::ivec3> m_remeshQueue;
+    std::unordered_set<glm::ivec3> m_staleMips; // LOD chunks whose World chunk changed
+    std::unordered_set<glm::ivec3> m_editedChunks; // World chunks changed since they were loaded
+    KeepLoadedFilter m_keepLoaded;
+    std::vector<uint8_t> m_meshKeyScratch;
+    std::vector<BlockType> m_storageScratch; // Far chunks read from the World's storage
+};
+
+#endif // TERRAINLOD_H
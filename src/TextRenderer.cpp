@@ -1,10 +1,11 @@
 // TextRenderer.cpp
 #include "TextRenderer.h"
+#include "MemoryStats.h"
 #include <iostream> 
 // FreeType is already included via TextRenderer.h -> ft2build.h and freetype.h
 
-TextRenderer::TextRenderer(GLuint windowWidth, GLuint windowHeight) 
-    : m_textShader(nullptr), m_vao(0), m_vbo(0), 
+TextRenderer::TextRenderer(GlStateCache& state, GLuint windowWidth, GLuint windowHeight) 
+    : m_state(state), m_textShader(nullptr), m_vao(0), m_vbo(0), 
       m_windowWidth(windowWidth), m_windowHeight(windowHeight),
       m_ft(nullptr), m_face(nullptr), m_fontLoaded(false), m_textureAtlasID(0) {
 
@@ -36,13 +37,13 @@ TextRenderer::TextRenderer(GLuint windowWidth, GLuint windowHeight)
     // Configure VAO/VBO for texture quads
     glGenVertexArrays(1, &m_vao);
     glGenBuffers(1, &m_vbo);
-    glBindVertexArray(m_vao);
+    m_state.bindVertexArray(m_vao);
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
     glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0); 
+    m_state.bindVertexArray(0); 
 
     setWindowSize(m_windowWidth, m_windowHeight);      
 }
@@ -57,8 +58,12 @@ TextRenderer::~TextRenderer() {
     }
     if (m_textureAtlasID != 0) {
         glDeleteTextures(1, &m_textureAtlasID);
+        MemoryStats::remove(MemoryCategory::TextAtlas, atlasBytes());
+    }
+    if (m_vao != 0) {
+        m_state.onVertexArrayDeleted(m_vao);
+        glDeleteVertexArrays(1, &m_vao);
     }
-    if (m_vao != 0) glDeleteVertexArrays(1, &m_vao);
     if (m_vbo != 0) glDeleteBuffers(1, &m_vbo);
 }
 
@@ -66,6 +71,7 @@ bool TextRenderer::loadFont(const std::string& fontPath, GLuint fontSize) {
     if (m_fontLoaded) { // If a font is already loaded, clean it up first
         FT_Done_Face(m_face);
         glDeleteTextures(1, &m_textureAtlasID);
+        MemoryStats::remove(MemoryCategory::TextAtlas, atlasBytes());
         m_characters.clear();
         m_fontLoaded = false;
         m_textureAtlasID = 0;
@@ -86,9 +92,10 @@ bool TextRenderer::loadFont(const std::string& fontPath, GLuint fontSize) {
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // Important for single-byte alignment for glyphs
 
     glGenTextures(1, &m_textureAtlasID);
-    glBindTexture(GL_TEXTURE_2D, m_textureAtlasID);
+    m_state.bindTexture2D(m_textureAtlasID);
     // Create an empty texture for the atlas
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, m_atlasSize.x, m_atlasSize.y, 0, GL_RED, GL_UNSIGNED_BYTE, 0);
+    MemoryStats::add(MemoryCategory::TextAtlas, atlasBytes());
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
@@ -155,7 +162,7 @@ bool TextRenderer::loadFont(const std::string& fontPath, GLuint fontSize) {
         }
     }
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+    m_state.bindTexture2D(0);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 4); // Reset to default
     m_fontLoaded = true;
     return true;
@@ -165,7 +172,7 @@ void TextRenderer::setWindowSize(GLuint windowWidth, GLuint windowHeight) {
     m_windowWidth = windowWidth;
     m_windowHeight = windowHeight;
     if (m_textShader) {
-        m_textShader->use();
+        m_state.useProgram(m_textShader->ID);
         glm::mat4 projection = glm::ortho(0.0f, static_cast<GLfloat>(m_windowWidth), 0.0f, static_cast<GLfloat>(m_windowHeight));
         m_textShader->setMat4("projection", projection);
     }
@@ -174,11 +181,11 @@ void TextRenderer::setWindowSize(GLuint windowWidth, GLuint windowHeight) {
 void TextRenderer::renderText(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color) {
     if (!m_fontLoaded || !m_textShader || m_textureAtlasID == 0) return;
 
-    m_textShader->use();
+    m_state.useProgram(m_textShader->ID);
     m_textShader->setVec3("textColor", color);
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_textureAtlasID); // Bind the single texture atlas
-    glBindVertexArray(m_vao);
+    m_state.bindTexture2D(m_textureAtlasID); // Bind the single texture atlas
+    m_state.bindVertexArray(m_vao);
 
     GLfloat originalX = x; // Store original x for multiline (not implemented here)
 
@@ -226,6 +233,5 @@ void TextRenderer::renderText(std::string text, GLfloat x, GLfloat y, GLfloat sc
         
         x += ch.Advance * scale;
     }
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0); // Unbind atlas
+    // The VAO and atlas stay bound: the state cache skips rebinding them for the next line of text
 } 
\ No newline at end of file
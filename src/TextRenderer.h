@@ -7,6 +7,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Shader.h" // We'll reuse our Shader class
+#include "GlStateCache.h"
 #include <map>
 
 // FreeType Headers
@@ -30,8 +31,9 @@ struct Character {
 
 class TextRenderer {
 public:
-    // Constructor now takes window dimensions, not font size directly here
-    TextRenderer(GLuint windowWidth, GLuint windowHeight);
+    // Constructor now takes window dimensions, not font size directly here.
+    // Program, VAO and texture binds go through state (the Renderer's cache) so it stays accurate.
+    TextRenderer(GlStateCache& state, GLuint windowWidth, GLuint windowHeight);
     ~TextRenderer();
 
     // Load a font using FreeType. fontPath is path to .ttf file.
@@ -40,6 +42,7 @@ public:
     void setWindowSize(GLuint windowWidth, GLuint windowHeight);
 
 private:
+    GlStateCache& m_state;
     Shader* m_textShader;
     std::map<GLchar, Character> m_characters; // Stores pre-rendered glyphs (or their metrics)
     GLuint m_vao, m_vbo;
@@ -51,6 +54,7 @@ private:
                                  // or if we build a single large atlas. Let's assume an atlas.
     GLuint m_textureAtlasID; // ID of the generated texture atlas
     glm::ivec2 m_atlasSize; // Dimensions of the texture atlas
+    size_t atlasBytes() const { return static_cast<size_t>(m_atlasSize.x) * m_atlasSize.y; } // One byte per texel (GL_RED)
 
     // initEmbeddedFont is no longer needed
 };
@@ -0,0 +1,91 @@
+#include "ThreadPool.h"
+#include <algorithm> // For std::min, std::max
+#include <atomic>
+#include <memory> // For std::shared_ptr
+
+ThreadPool::ThreadPool(unsigned threadCount) : m_stopping(false) {
+    if (threadCount == 0) {
+        unsigned hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = std::max(1u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u);
+    }
+    m_workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_taskAvailable.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_taskAvailable.notify_one();
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_taskAvailable.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) return; // Stopping and nothing left to do
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& fn) {
+    if (count == 0) return;
+    batchSize = std::max<size_t>(batchSize, 1);
+    size_t batchCount = (count + batchSize - 1) / batchSize;
+    if (batchCount == 1) {
+        fn(0, count);
+        return;
+    }
+
+    // Shared with the helper tasks, which may still touch it after the last batch finished
+    struct Job {
+        std::atomic<size_t> nextBatch{0};
+        std::atomic<size_t> finishedBatches{0};
+        std::mutex mutex;
+        std::condition_variable allDone;
+    };
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+
+    // Pulls batches until none are left. fn is only called for batches claimed before all finished,
+    // so it is never used after parallelFor returns.
+    auto runBatches = [job, count, batchSize, batchCount, &fn]() {
+        for (;;) {
+            size_t batch = job->nextBatch.fetch_add(1);
+            if (batch >= batchCount) return;
+            size_t begin = batch * batchSize;
+            fn(begin, std::min(begin + batchSize, count));
+            if (job->finishedBatches.fetch_add(1) + 1 == batchCount) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->allDone.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min<size_t>(m_workers.size(), batchCount - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        submit(runBatches);
+    }
+    runBatches(); // The calling thread works too
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->allDone.wait(lock, [&job, batchCount] { return job->finishedBatches.load() == batchCount; });
+}
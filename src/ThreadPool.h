@@ -0,0 +1,41 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for CPU work that can be split up (entity physics, later meshing).
+class ThreadPool {
+public:
+    // threadCount 0 picks hardware threads - 1 (the main thread helps in parallelFor), at least 1.
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool(); // Finishes queued tasks, then joins the workers
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Runs a task on some worker, fire and forget
+    void submit(std::function<void()> task);
+
+    // Calls fn(begin, end) for consecutive ranges of at most batchSize covering [0, count), spread over
+    // the workers and the calling thread. Returns once every range is done.
+    void parallelFor(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& fn);
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_taskAvailable;
+    bool m_stopping;
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,48 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer/single-consumer triple buffer.
+// The producer always has a slot to write into and the consumer always has a slot to read,
+// so neither side ever waits for the other. The consumer sees the most recently published
+// value; values published in between two reads are skipped.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : m_middle(1), m_back(0), m_front(2) {}
+
+    // --- Producer side ---
+    // Slot to fill for the next publish(). Contents are whatever was last written to this
+    // slot, which lets callers reuse allocations (e.g. vectors) between frames.
+    T& beginWrite() { return m_slots[m_back]; }
+    // Makes the written slot available to the consumer.
+    void publish() {
+        // Swap back and middle, flagging the middle slot as fresh
+        uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_back | FRESH_BIT), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    // --- Consumer side ---
+    // Picks up the latest published slot if there is one. Returns true if the value changed.
+    bool update() {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0) return false;
+        uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+    // Latest value picked up by update(). Stays valid until the next update().
+    const T& read() const { return m_slots[m_front]; }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t FRESH_BIT = 0x4;
+
+    T m_slots[3];
+    std::atomic<uint8_t> m_middle; // Index of the shared slot plus FRESH_BIT when unread
+    uint8_t m_back;                // Owned by the producer
+    uint8_t m_front;               // Owned by the consumer
+};
+
+#endif // TRIPLEBUFFER_H
@@ -1,10 +1,10 @@
 #include "World.h"
-#include "Camera.h" // Include for AABB struct definition
-#include <iostream> // For debug
+#include "Logger.h"
+#include "MemoryStats.h"
 #include <limits>   // For std::numeric_limits
 #include <algorithm> // For std::min and std::max if needed though glm provides its own
 
-World::World() {
+World::World() : m_lightEngine(*this), m_blockTicker(*this), m_fluidEngine(*this), m_pathfinder(*this), m_scheduler(*this) {
     // Constructor - Now very simple, no OpenGL-dependent calls here.
 }
 
@@ -19,11 +19,13 @@ void World::init() {
             ensureChunkExists(glm::ivec3(cx, 0, cz));
         }
     }
-    std::cout << "World: Initialized " << (2*chunkLoadRadius+1)*(2*chunkLoadRadius+1) << " chunks around origin." << std::endl;
+    LOG_INFO(LogCategory::World, "Initialized {} chunks around origin.", (2*chunkLoadRadius+1)*(2*chunkLoadRadius+1));
 }
 
 World::~World() {
-    // Destructor - m_chunks with unique_ptr will auto-cleanup
+    // Destructor - m_chunks with shared_ptr will auto-cleanup (chunks still held by other threads live on)
+    MemoryStats::resize(MemoryCategory::MapOverhead, m_trackedMapBytes, 0);
+    MemoryStats::resize(MemoryCategory::MeshScratch, m_meshKeyScratch.capacity(), 0);
 }
 
 bool World::ensureChunkExists(glm::ivec3 chunkCoord) {
@@ -35,9 +37,20 @@ bool World::ensureChunkExists(glm::ivec3 chunkCoord) {
     }
 
     if (m_chunks.find(chunkCoord) == m_chunks.end()) {
-        m_chunks[chunkCoord] = std::make_unique<Chunk>(chunkCoord);
+        std::shared_ptr<Chunk>& chunk = m_chunks[chunkCoord];
+        chunk = std::make_shared<Chunk>(chunkCoord);
+        m_chunkIndexChanged = true;
         // DO NOT call generateSimpleTerrain() or buildMesh() here anymore.
-        // Chunk will be processed by processWorldUpdates().
+        // Chunk will be processed by processWorldUpdates(), when the scheduler gets to it.
+        chunk->setScheduler(&m_scheduler);
+        chunk->setPublishQueue(&m_unpublishedChunks);
+        // Link both ways with the loaded neighbors; NEIGHBOR_OFFSETS pairs opposite directions (d ^ 1)
+        for (int direction = 0; direction < 6; ++direction) {
+            Chunk* neighbor = getChunk(chunkCoord + Chunk::NEIGHBOR_OFFSETS[direction]);
+            chunk->setNeighbor(direction, neighbor);
+            if (neighbor) neighbor->setNeighbor(direction ^ 1, chunk.get());
+        }
+        m_scheduler.requestSetup(chunkCoord);
         // std::cout << "World: Created (but not yet generated) chunk at " << chunkCoord.x << ", " << chunkCoord.y << ", " << chunkCoord.z << std::endl;
         return true;
     }
@@ -47,11 +60,24 @@ bool World::ensureChunkExists(glm::ivec3 chunkCoord) {
 Chunk* World::getChunk(glm::ivec3 chunkCoord) const {
     auto it = m_chunks.find(chunkCoord);
     if (it != m_chunks.end()) {
-        return it->second.get(); // Return raw pointer from unique_ptr
+        return it->second.get(); // Return raw pointer from shared_ptr
     }
     return nullptr;
 }
 
+bool World::unloadChunk(glm::ivec3 chunkCoord) {
+    m_blockTicker.onChunkUnloaded(chunkCoord);
+    m_pathfinder.onChunkUnloaded(chunkCoord);
+    auto it = m_chunks.find(chunkCoord);
+    if (it == m_chunks.end()) return false;
+    for (int direction = 0; direction < 6; ++direction) {
+        if (Chunk* neighbor = it->second->getNeighbor(direction)) neighbor->setNeighbor(direction ^ 1, nullptr);
+    }
+    m_chunks.erase(it);
+    m_chunkIndexChanged = true;
+    return true;
+}
+
 BlockType World::getBlock(glm::ivec3 worldBlockPos) const {
     glm::ivec3 chunkCoord = worldBlockToChunkCoord(worldBlockPos);
     Chunk* chunk = getChunk(chunkCoord);
@@ -63,28 +89,78 @@ BlockType World::getBlock(glm::ivec3 worldBlockPos) const {
 }
 
 void World::setBlock(glm::ivec3 worldBlockPos, BlockType type) {
-    std::cout << "[World::setBlock] Received worldBlockPos: (" 
-              << worldBlockPos.x << ", " << worldBlockPos.y << ", " << worldBlockPos.z 
-              << ") Type: " << static_cast<int>(type) << std::endl;
-
     glm::ivec3 chunkCoord = worldBlockToChunkCoord(worldBlockPos);
-    std::cout << "    Calculated chunkCoord: (" 
-              << chunkCoord.x << ", " << chunkCoord.y << ", " << chunkCoord.z << ")" << std::endl;
+    LOG_TRACE(LogCategory::World, "setBlock ({}, {}, {}) type {} in chunk ({}, {}, {})", worldBlockPos.x, worldBlockPos.y,
+              worldBlockPos.z, type, chunkCoord.x, chunkCoord.y, chunkCoord.z);
 
     ensureChunkExists(chunkCoord); // Ensure chunk exists before setting a block
     Chunk* chunk = getChunk(chunkCoord);
     if (chunk) {
         glm::ivec3 localPos = worldBlockToLocalCoord(worldBlockPos);
-        std::cout << "    Calculated localPos: (" 
-                  << localPos.x << ", " << localPos.y << ", " << localPos.z << ")" << std::endl;
-        chunk->setBlock(localPos.x, localPos.y, localPos.z, type);
+        if (chunk->setBlock(localPos.x, localPos.y, localPos.z, type)) {
+            notifyBlockChanged(worldBlockPos, type);
+        }
+    }
+}
+
+int World::addBlockChangeListener(BlockChangeListener listener) {
+    int handle = m_nextListenerHandle++;
+    m_blockChangeListeners.emplace_back(handle, std::move(listener));
+    return handle;
+}
+
+void World::notifyBlockChanged(const glm::ivec3& worldBlockPos, BlockType newType) {
+    m_lightEngine.onBlockChanged(worldBlockPos);
+    m_blockTicker.onBlockChanged(worldBlockPos, newType);
+    m_fluidEngine.onBlockChanged(worldBlockPos, newType);
+    m_pathfinder.onBlockChanged(worldBlockPos);
+    for (const auto& entry : m_blockChangeListeners) {
+        entry.second(worldBlockPos, newType);
     }
 }
 
-const std::map<glm::ivec3, std::unique_ptr<Chunk>, Ivec3Compare>& World::getLoadedChunks() const {
+void World::removeBlockChangeListener(int handle) {
+    m_blockChangeListeners.erase(
+        std::remove_if(m_blockChangeListeners.begin(), m_blockChangeListeners.end(),
+                       [handle](const auto& entry) { return entry.first == handle; }),
+        m_blockChangeListeners.end());
+}
+
+const std::map<glm::ivec3, std::shared_ptr<Chunk>, Ivec3Compare>& World::getLoadedChunks() const {
     return m_chunks;
 }
 
+Chunk::BlockSnapshotPtr World::getBlockSnapshot(const glm::ivec3& chunkCoord) const {
+    std::shared_ptr<const ChunkIndex> index = getChunkIndex();
+    if (!index) return nullptr;
+    auto it = index->find(chunkCoord);
+    return it != index->end() ? it->second->getBlockSnapshot() : nullptr;
+}
+
+void World::publish() {
+    if (m_chunkIndexChanged) {
+        // Readers keep using the old index until they load the new one; it is freed with its last reader
+        auto index = std::make_shared<ChunkIndex>();
+        index->reserve(m_chunks.size());
+        for (const auto& pair : m_chunks) index->emplace(pair.first, pair.second);
+        size_t mapBytes = MemoryStats::treeMapBytes(m_chunks) + MemoryStats::hashMapBytes(*index);
+        MemoryStats::resize(MemoryCategory::MapOverhead, m_trackedMapBytes, mapBytes);
+        m_trackedMapBytes = mapBytes;
+        std::atomic_store(&m_publishedIndex, std::shared_ptr<const ChunkIndex>(std::move(index)));
+        m_chunkIndexChanged = false;
+    }
+    // Only chunks written since the last publish (Chunk::setPublishQueue). Chunks unloaded meanwhile
+    // are skipped; ones written before they were generated wait until they are.
+    size_t kept = 0;
+    for (const glm::ivec3& chunkCoord : m_unpublishedChunks) {
+        Chunk* chunk = getChunk(chunkCoord);
+        if (!chunk) continue;
+        if (chunk->isGenerated()) chunk->publishBlocks();
+        else m_unpublishedChunks[kept++] = chunkCoord;
+    }
+    m_unpublishedChunks.resize(kept);
+}
+
 // Implementation of castRay
 World::RaycastResult World::castRay(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float maxDistance) const {
     RaycastResult result;
@@ -171,28 +247,53 @@ World::RaycastResult World::castRay(const glm::vec3& rayOrigin, const glm::vec3&
     return result;
 }
 
+void World::tick() {
+    m_blockTicker.tick();
+    m_fluidEngine.tick();
+    processWorldUpdates();
+    m_pathfinder.update();
+    publish(); // Other threads see this tick's chunks and blocks from now on
+}
+
 void World::processWorldUpdates() {
-    // Process one chunk generation per call
-    for (auto& pair : m_chunks) {
-        Chunk* chunk = pair.second.get();
-        if (chunk && !chunk->isGenerated()) {
-            chunk->generateSimpleTerrain(); // This will set needsMeshBuild to true
-            // std::cout << "World processed generation for chunk: " << chunk->getWorldPosition().x << ", " << chunk->getWorldPosition().z << std::endl;
+    // Nearest chunks first, and only as many as fit in the budget (see ChunkScheduler::run)
+    m_scheduler.run();
+}
+
+void World::setUpChunk(Chunk& chunk) {
+    if (!chunk.isGenerated()) {
+        if (m_storage.loadChunk(chunk.getWorldPosition(), m_storageScratch)) {
+            chunk.setBlockData(m_storageScratch.data()); // Pre-generated
+        } else {
+            chunk.generateSimpleTerrain(); // This will set needsMeshBuild to true
         }
     }
+    // Light newly generated (or received) chunks. This marks the chunks whose light changed for a mesh rebuild.
+    if (!chunk.isLit()) {
+        m_lightEngine.lightChunk(&chunk);
+        m_blockTicker.onChunkLoaded(chunk.getWorldPosition()); // New blocks, recount what needs ticking
+        m_pathfinder.onChunkLoaded(chunk.getWorldPosition());
+    }
+}
 
-    // Process all mesh builds per call, only for generated chunks
-    for (auto& pair : m_chunks) {
-        Chunk* chunk = pair.second.get();
-        if (chunk && chunk->isGenerated() && chunk->needsMeshBuild()) {
-            chunk->buildMesh();
-            // std::cout << "World processed mesh build for chunk: " << chunk->getWorldPosition().x << ", " << chunk->getWorldPosition().z << std::endl;
-        }
+void World::buildChunkMesh(Chunk& chunk) {
+    // Neighbors provide the light for faces on the chunk border
+    const Chunk* const* neighbors = chunk.getNeighbors();
+    // Identical contents (flat terrain, a chunk changed back) reuse the cached mesh
+    size_t scratchCapacity = m_meshKeyScratch.capacity();
+    chunk.buildMeshKey(neighbors, m_meshKeyScratch);
+    MemoryStats::resize(MemoryCategory::MeshScratch, scratchCapacity, m_meshKeyScratch.capacity());
+    ChunkMeshPtr cached = m_meshCache.find(m_meshKeyScratch);
+    if (cached) {
+        chunk.setMesh(cached);
+    } else {
+        chunk.buildMesh(neighbors);
+        m_meshCache.insert(m_meshKeyScratch, chunk.getMesh());
     }
 }
 
 // Helper to convert world block coordinates to chunk coordinates
-glm::ivec3 World::worldBlockToChunkCoord(glm::ivec3 worldBlockPos) const {
+glm::ivec3 World::worldBlockToChunkCoord(glm::ivec3 worldBlockPos) {
     return glm::ivec3(
         static_cast<int>(floor(static_cast<float>(worldBlockPos.x) / Chunk::CHUNK_WIDTH)),
         static_cast<int>(floor(static_cast<float>(worldBlockPos.y) / Chunk::CHUNK_HEIGHT)),
@@ -201,133 +302,10 @@ glm::ivec3 World::worldBlockToChunkCoord(glm::ivec3 worldBlockPos) const {
 }
 
 // Helper to convert world block coordinates to local block coordinates within a chunk
-glm::ivec3 World::worldBlockToLocalCoord(glm::ivec3 worldBlockPos) const {
+glm::ivec3 World::worldBlockToLocalCoord(glm::ivec3 worldBlockPos) {
     return glm::ivec3(
         (worldBlockPos.x % Chunk::CHUNK_WIDTH + Chunk::CHUNK_WIDTH) % Chunk::CHUNK_WIDTH, // Positive modulo
         (worldBlockPos.y % Chunk::CHUNK_HEIGHT + Chunk::CHUNK_HEIGHT) % Chunk::CHUNK_HEIGHT,
         (worldBlockPos.z % Chunk::CHUNK_DEPTH + Chunk::CHUNK_DEPTH) % Chunk::CHUNK_DEPTH
     );
 }
-
-// --- Collision Detection --- 
-
-// Helper to check AABB-AABB intersection
-bool checkAABBCollision(const AABB& a, const AABB& b) {
-    // Check for overlap on each axis
-    bool overlapX = a.min.x < b.max.x && a.max.x > b.min.x;
-    bool overlapY = a.min.y < b.max.y && a.max.y > b.min.y;
-    bool overlapZ = a.min.z < b.max.z && a.max.z > b.min.z;
-    return overlapX && overlapY && overlapZ;
-}
-
-// Main collision resolution function
-bool World::resolveCollisions(AABB& playerAABB, glm::vec3& playerVelocity, bool& io_isOnGround) {
-    bool collisionOccurredOverall = false;
-    io_isOnGround = false; // Assume not on ground until a supporting collision is found
-
-    // Iterate multiple times to handle complex collisions and settling
-    const int collisionPasses = 3; // Can be tuned
-
-    for (int pass = 0; pass < collisionPasses; ++pass) {
-        bool collisionThisPass = false;
-
-        glm::ivec3 minBlock = glm::floor(playerAABB.min - glm::vec3(1.0f)); // Expand search slightly
-        glm::ivec3 maxBlock = glm::ceil(playerAABB.max + glm::vec3(1.0f));  // Expand search slightly
-
-        for (int y = minBlock.y; y <= maxBlock.y; ++y) {
-            for (int x = minBlock.x; x <= maxBlock.x; ++x) {
-                for (int z = minBlock.z; z <= maxBlock.z; ++z) {
-                    glm::ivec3 currentBlockPos(x, y, z);
-                    BlockType blockType = getBlock(currentBlockPos);
-
-                    if (blockType != BlockType::Air) {
-                        AABB blockAABB;
-                        blockAABB.min = glm::vec3(currentBlockPos);
-                        blockAABB.max = glm::vec3(currentBlockPos) + glm::vec3(1.0f);
-
-                        if (checkAABBCollision(playerAABB, blockAABB)) {
-                            collisionThisPass = true;
-                            collisionOccurredOverall = true;
-
-                            // Calculate overlap (penetration) on each axis
-                            float overlapX = 0.0f;
-                            if (playerVelocity.x > 0) overlapX = blockAABB.min.x - playerAABB.max.x;
-                            else if (playerVelocity.x < 0) overlapX = blockAABB.max.x - playerAABB.min.x;
-                            
-                            float overlapY = 0.0f;
-                            if (playerVelocity.y > 0) overlapY = blockAABB.min.y - playerAABB.max.y;
-                            else if (playerVelocity.y < 0) overlapY = blockAABB.max.y - playerAABB.min.y;
-
-                            float overlapZ = 0.0f;
-                            if (playerVelocity.z > 0) overlapZ = blockAABB.min.z - playerAABB.max.z;
-                            else if (playerVelocity.z < 0) overlapZ = blockAABB.max.z - playerAABB.min.z;
-
-                            // Calculate how far to move playerAABB back in time along velocity vector to just touch
-                            // This is a more continuous approach but simpler is often better to start.
-                            // For now, let's use a simpler "push-out" based on minimum penetration.
-
-                            glm::vec3 penetration;
-                            // Corrected penetration calculation:
-                            // Amount of overlap = (sum of half-widths) - (distance between centers)
-                            // Simpler: dist between centers = max(a.min, b.min) - min(a.max, b.max)
-                            // More robust penetration: (ref: https://gamedev.stackexchange.com/a/29796)
-                            glm::vec3 centerA = (playerAABB.min + playerAABB.max) * 0.5f;
-                            glm::vec3 centerB = (blockAABB.min + blockAABB.max) * 0.5f;
-                            glm::vec3 halfSizeA = (playerAABB.max - playerAABB.min) * 0.5f;
-                            glm::vec3 halfSizeB = (blockAABB.max - blockAABB.min) * 0.5f;
-
-                            glm::vec3 delta = centerA - centerB;
-                            penetration.x = (halfSizeA.x + halfSizeB.x) - glm::abs(delta.x);
-                            penetration.y = (halfSizeA.y + halfSizeB.y) - glm::abs(delta.y);
-                            penetration.z = (halfSizeA.z + halfSizeB.z) - glm::abs(delta.z);
-
-                            // Determine the side of collision and resolve
-                            // This finds the axis of minimum penetration to resolve first.
-                            if (penetration.y < penetration.x && penetration.y < penetration.z) {
-                                // Vertical collision resolution
-                                if (playerAABB.min.y < blockAABB.min.y) { // Player is below block (ceiling collision)
-                                    playerAABB.min.y -= penetration.y;
-                                    playerAABB.max.y -= penetration.y;
-                                    if (playerVelocity.y > 0) playerVelocity.y = 0; // Hit ceiling
-                                } else { // Player is above block (floor collision)
-                                    playerAABB.min.y += penetration.y;
-                                    playerAABB.max.y += penetration.y;
-                                    if (playerVelocity.y < 0) {
-                                        playerVelocity.y = 0; // Landed on ground
-                                        io_isOnGround = true;
-                                    }
-                                }
-                            } else if (penetration.x < penetration.y && penetration.x < penetration.z) {
-                                // Horizontal X collision resolution
-                                if (playerAABB.min.x < blockAABB.min.x) { // Player is to the left of block
-                                    playerAABB.min.x -= penetration.x;
-                                    playerAABB.max.x -= penetration.x;
-                                } else { // Player is to the right of block
-                                    playerAABB.min.x += penetration.x;
-                                    playerAABB.max.x += penetration.x;
-                                }
-                                if ((playerVelocity.x > 0 && playerAABB.max.x > blockAABB.min.x) || (playerVelocity.x < 0 && playerAABB.min.x < blockAABB.max.x)) {
-                                   playerVelocity.x = 0; 
-                                }
-                            } else {
-                                // Horizontal Z collision resolution
-                                if (playerAABB.min.z < blockAABB.min.z) { // Player is in front of block
-                                    playerAABB.min.z -= penetration.z;
-                                    playerAABB.max.z -= penetration.z;
-                                } else { // Player is behind block
-                                    playerAABB.min.z += penetration.z;
-                                    playerAABB.max.z += penetration.z;
-                                }
-                                 if ((playerVelocity.z > 0 && playerAABB.max.z > blockAABB.min.z) || (playerVelocity.z < 0 && playerAABB.min.z < blockAABB.max.z)) {
-                                   playerVelocity.z = 0; 
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        if (!collisionThisPass) break; // If no collisions in a pass, we are stable
-    }
-    return collisionOccurredOverall;
-} 
\ No newline at end of file
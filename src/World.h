@@ -3,15 +3,21 @@
 
 #include "Chunk.h"
 #include "BlockType.h"
+#include "LightEngine.h"
+#include "BlockTicker.h"
+#include "FluidEngine.h"
+#include "Pathfinder.h"
+#include "ChunkMeshCache.h"
+#include "ChunkScheduler.h"
+#include "WorldStorage.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp> // For ivec3 comparison if needed, though not directly
 #include <glm/gtx/hash.hpp>
-#include <vector> // For storing collision AABBs
+#include <vector>
 #include <map>
-#include <memory> // For std::unique_ptr
-
-// Forward declare AABB from Camera.h or define it here if preferred (Camera.h is fine)
-struct AABB; // Assuming AABB is defined in Camera.h and Camera.h will be included where World is used
+#include <unordered_map>
+#include <memory> // For std::shared_ptr
+#include <functional> // For block change listeners
 
 // Custom comparator for glm::ivec3 to use it as a key in std::map
 struct Ivec3Compare {
@@ -31,6 +37,9 @@ public:
         glm::ivec3 blockBefore;   // The air block position just before hitting blockHit
     };
 
+    // Called after a block actually changed (e.g. so the network layer can replicate it)
+    using BlockChangeListener = std::function<void(const glm::ivec3& worldBlockPos, BlockType newType)>;
+
     World();
     ~World();
     void init(); // New method to initialize world (e.g., create initial chunks)
@@ -39,29 +48,85 @@ public:
     // Returns true if a new chunk was generated/loaded, false if it already existed or failed
     bool ensureChunkExists(glm::ivec3 chunkCoord);
     Chunk* getChunk(glm::ivec3 chunkCoord) const; // Get a non-owning pointer to a chunk
+    // Destroys a loaded chunk. Returns false if it wasn't loaded.
+    bool unloadChunk(glm::ivec3 chunkCoord);
 
     BlockType getBlock(glm::ivec3 worldBlockPos) const;
     void setBlock(glm::ivec3 worldBlockPos, BlockType type);
 
+    // Registers a callback that is invoked for every block change made through setBlock.
+    // Returns a handle for removeBlockChangeListener.
+    int addBlockChangeListener(BlockChangeListener listener);
+    void removeBlockChangeListener(int handle);
+    // Informs listeners (and lighting) about a change made directly in chunk storage (see WorldEdit).
+    void notifyBlockChanged(const glm::ivec3& worldBlockPos, BlockType newType);
+
     // For iteration by the renderer (temporary)
-    const std::map<glm::ivec3, std::unique_ptr<Chunk>, Ivec3Compare>& getLoadedChunks() const;
+    const std::map<glm::ivec3, std::shared_ptr<Chunk>, Ivec3Compare>& getLoadedChunks() const;
 
     // New raycasting method
     RaycastResult castRay(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float maxDistance) const;
 
-    void processWorldUpdates(); // New method for deferred chunk processing
+    // Deferred chunk work (generation, lighting, meshing) through the ChunkScheduler, within its time budget
+    void processWorldUpdates();
+    // One simulation tick: block ticks, fluids, processWorldUpdates(), queued path requests, then publish()
+    void tick();
+    // Camera the chunk work is prioritized around (nearest and in view first)
+    void setFocus(const glm::vec3& position, const glm::vec3& viewDirection) { m_scheduler.setFocus(position, viewDirection); }
+    ChunkScheduler& getScheduler() { return m_scheduler; }
+
+    // Chunk jobs, run by the ChunkScheduler.
+    // Generates the chunk if needed, then lights it and tells the block ticker and pathfinder about its blocks.
+    void setUpChunk(Chunk& chunk);
+    // Rebuilds the chunk's mesh (or reuses an identical cached one)
+    void buildChunkMesh(Chunk& chunk);
+    // Relights around changed blocks, marking the chunks whose light changed for a mesh rebuild
+    void updateLighting() { m_lightEngine.update(); }
+
+    // Scheduled/random block updates (e.g. for scheduling a tick when placing a dynamic block)
+    BlockTicker& getBlockTicker() { return m_blockTicker; }
+    FluidEngine& getFluidEngine() { return m_fluidEngine; }
+    Pathfinder& getPathfinder() { return m_pathfinder; }
+    ChunkMeshCache& getMeshCache() { return m_meshCache; }
+    // Pre-generated chunks (WorldPregen); disabled unless a directory is set
+    WorldStorage& getStorage() { return m_storage; }
 
-    // Collision detection
-    // Checks collision for the playerAABB, attempts to resolve it by adjusting playerAABB and velocity.
-    // Returns true if any collision occurred and was resolved.
-    bool resolveCollisions(AABB& playerAABB, glm::vec3& playerVelocity, bool& io_isOnGround);
+    // --- Concurrent access ---
+    // Everything else in World belongs to the simulation thread. Other threads see the world as of
+    // the last publish(): an immutable index of the loaded chunks, replaced as a whole when chunks
+    // come or go, and each chunk's published blocks (see Chunk::BlockSnapshot). Readers never wait
+    // for the simulation thread: getting either is one atomic shared_ptr load, and what they got stays
+    // valid (unloaded chunks included) for as long as they hold it.
+    using ChunkIndex = std::unordered_map<glm::ivec3, std::shared_ptr<const Chunk>>;
+    // Any thread. Only Chunk's concurrent-access members may be used on the chunks.
+    std::shared_ptr<const ChunkIndex> getChunkIndex() const { return std::atomic_load(&m_publishedIndex); }
+    // Any thread. Published blocks of a chunk, null if it wasn't loaded and generated at the last publish.
+    Chunk::BlockSnapshotPtr getBlockSnapshot(const glm::ivec3& chunkCoord) const;
+    // Simulation thread, at the end of every tick: publishes the chunk index if chunks were loaded or
+    // unloaded, and the blocks of generated chunks that changed (only those are visited)
+    void publish();
 
     // Helper functions - ensuring these are public
-    glm::ivec3 worldBlockToChunkCoord(glm::ivec3 worldBlockPos) const;
-    glm::ivec3 worldBlockToLocalCoord(glm::ivec3 worldBlockPos) const;
+    static glm::ivec3 worldBlockToChunkCoord(glm::ivec3 worldBlockPos);
+    static glm::ivec3 worldBlockToLocalCoord(glm::ivec3 worldBlockPos);
 
 private:
-    std::map<glm::ivec3, std::unique_ptr<Chunk>, Ivec3Compare> m_chunks;
+    std::map<glm::ivec3, std::shared_ptr<Chunk>, Ivec3Compare> m_chunks; // Shared with the published index
+    std::shared_ptr<const ChunkIndex> m_publishedIndex; // Only accessed with std::atomic_load/store
+    bool m_chunkIndexChanged = true;
+    std::vector<glm::ivec3> m_unpublishedChunks; // Chunks whose blocks changed since the last publish()
+    size_t m_trackedMapBytes = 0; // m_chunks and index estimate last reported to MemoryStats
+    std::vector<std::pair<int, BlockChangeListener>> m_blockChangeListeners;
+    int m_nextListenerHandle = 1;
+    LightEngine m_lightEngine; // Relit incrementally in processWorldUpdates
+    BlockTicker m_blockTicker;
+    FluidEngine m_fluidEngine;
+    Pathfinder m_pathfinder; // Mob path queries, served at the end of tick()
+    ChunkMeshCache m_meshCache; // Chunks with identical contents share a mesh
+    ChunkMeshCache::Key m_meshKeyScratch;
+    WorldStorage m_storage; // Chunks found here are loaded instead of generated
+    std::vector<BlockType> m_storageScratch;
+    ChunkScheduler m_scheduler; // Decides which chunk work runs each tick
 };
 
 #endif // WORLD_H 
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "WorldEdit.h"
+#include "World.h"
+#include "Chunk.h"
+#include <algorithm> // For std::min, std::max, std::stable_sort
+
+static const glm::ivec3 CHUNK_SIZE(Chunk::CHUNK_WIDTH, Chunk::CHUNK_HEIGHT, Chunk::CHUNK_DEPTH);
+
+glm::ivec3 ChangeSet::worldPositionOf(const ChunkChanges& chunkChanges, size_t i) {
+    int index = chunkChanges.indices[i];
+    glm::ivec3 local(index % Chunk::CHUNK_WIDTH,
+                     (index / Chunk::CHUNK_WIDTH) % Chunk::CHUNK_HEIGHT,
+                     index / (Chunk::CHUNK_WIDTH * Chunk::CHUNK_HEIGHT));
+    return chunkChanges.chunkCoord * CHUNK_SIZE + local;
+}
+
+WorldEdit::WorldEdit(World& world) : m_world(world) {}
+
+Chunk* WorldEdit::prepareChunk(const glm::ivec3& chunkCoord) {
+    m_world.ensureChunkExists(chunkCoord);
+    Chunk* chunk = m_world.getChunk(chunkCoord);
+    if (chunk && !chunk->isGenerated()) {
+        // Set up now (loaded from storage or generated), otherwise processWorldUpdates would do it
+        // later and wipe the edit
+        m_world.setUpChunk(*chunk);
+    }
+    return chunk;
+}
+
+void WorldEdit::finishChunk(Chunk* chunk, ChangeSet::ChunkChanges& chunkChanges, ChangeSet& changeSet) {
+    if (chunkChanges.indices.empty()) return;
+
+    chunk->setNeedsMeshBuild(true); // Once per chunk, however many blocks changed
+    for (size_t i = 0; i < chunkChanges.indices.size(); ++i) {
+        m_world.notifyBlockChanged(ChangeSet::worldPositionOf(chunkChanges, i), chunkChanges.newTypes[i]);
+    }
+    changeSet.m_changeCount += chunkChanges.indices.size();
+    changeSet.m_chunks.push_back(std::move(chunkChanges));
+}
+
+template <typename NewTypeFn>
+ChangeSet WorldEdit::editBox(const glm::ivec3& corner1, const glm::ivec3& corner2, NewTypeFn newTypeFor) {
+    ChangeSet changeSet;
+    glm::ivec3 minBlock = glm::min(corner1, corner2);
+    glm::ivec3 maxBlock = glm::max(corner1, corner2);
+    glm::ivec3 minChunk = World::worldBlockToChunkCoord(minBlock);
+    glm::ivec3 maxChunk = World::worldBlockToChunkCoord(maxBlock);
+
+    for (int cy = minChunk.y; cy <= maxChunk.y; ++cy) {
+        for (int cz = minChunk.z; cz <= maxChunk.z; ++cz) {
+            for (int cx = minChunk.x; cx <= maxChunk.x; ++cx) {
+                glm::ivec3 chunkCoord(cx, cy, cz);
+                Chunk* chunk = prepareChunk(chunkCoord);
+                if (!chunk) continue;
+
+                // Part of the box inside this chunk, in local coordinates
+                glm::ivec3 chunkOrigin = chunkCoord * CHUNK_SIZE;
+                glm::ivec3 localMin = glm::max(minBlock - chunkOrigin, glm::ivec3(0));
+                glm::ivec3 localMax = glm::min(maxBlock - chunkOrigin, CHUNK_SIZE - 1);
+
+                BlockType* blocks = chunk->getBlockDataForWrite();
+                ChangeSet::ChunkChanges chunkChanges;
+                chunkChanges.chunkCoord = chunkCoord;
+
+                for (int z = localMin.z; z <= localMax.z; ++z) {
+                    for (int y = localMin.y; y <= localMax.y; ++y) {
+                        int index = Chunk::localIndex(localMin.x, y, z);
+                        for (int x = localMin.x; x <= localMax.x; ++x, ++index) {
+                            BlockType oldType = blocks[index];
+                            BlockType newType = newTypeFor(chunkOrigin + glm::ivec3(x, y, z), oldType);
+                            if (newType != oldType) {
+                                blocks[index] = newType;
+                                chunkChanges.indices.push_back(static_cast<uint16_t>(index));
+                                chunkChanges.oldTypes.push_back(oldType);
+                                chunkChanges.newTypes.push_back(newType);
+                            }
+                        }
+                    }
+                }
+                finishChunk(chunk, chunkChanges, changeSet);
+            }
+        }
+    }
+    return changeSet;
+}
+
+ChangeSet WorldEdit::fillBox(const glm::ivec3& corner1, const glm::ivec3& corner2, BlockType type) {
+    return editBox(corner1, corner2, [type](const glm::ivec3&, BlockType) { return type; });
+}
+
+ChangeSet WorldEdit::replace(const glm::ivec3& corner1, const glm::ivec3& corner2, BlockType from, BlockType to) {
+    return editBox(corner1, corner2, [from, to](const glm::ivec3&, BlockType oldType) {
+        return oldType == from ? to : oldType;
+    });
+}
+
+ChangeSet WorldEdit::fillSphere(const glm::vec3& center, float radius, BlockType type) {
+    glm::ivec3 minBlock = glm::ivec3(glm::floor(center - glm::vec3(radius)));
+    glm::ivec3 maxBlock = glm::ivec3(glm::floor(center + glm::vec3(radius)));
+    float radiusSquared = radius * radius;
+    return editBox(minBlock, maxBlock, [center, radiusSquared, type](const glm::ivec3& worldPos, BlockType oldType) {
+        glm::vec3 offset = glm::vec3(worldPos) + glm::vec3(0.5f) - center; // Test block centers
+        return glm::dot(offset, offset) <= radiusSquared ? type : oldType;
+    });
+}
+
+BlockRegion WorldEdit::copyRegion(const glm::ivec3& corner1, const glm::ivec3& corner2) const {
+    BlockRegion region;
+    glm::ivec3 minBlock = glm::min(corner1, corner2);
+    glm::ivec3 maxBlock = glm::max(corner1, corner2);
+    region.size = maxBlock - minBlock + 1;
+    region.blocks.assign(static_cast<size_t>(region.size.x) * region.size.y * region.size.z, BlockType::Air);
+
+    // Copy chunk by chunk straight out of the block arrays
+    glm::ivec3 minChunk = World::worldBlockToChunkCoord(minBlock);
+    glm::ivec3 maxChunk = World::worldBlockToChunkCoord(maxBlock);
+    for (int cy = minChunk.y; cy <= maxChunk.y; ++cy) {
+        for (int cz = minChunk.z; cz <= maxChunk.z; ++cz) {
+            for (int cx = minChunk.x; cx <= maxChunk.x; ++cx) {
+                glm::ivec3 chunkCoord(cx, cy, cz);
+                const Chunk* chunk = m_world.getChunk(chunkCoord);
+                if (!chunk || !chunk->isGenerated()) continue; // Reads as air, like World::getBlock
+
+                glm::ivec3 chunkOrigin = chunkCoord * CHUNK_SIZE;
+                glm::ivec3 localMin = glm::max(minBlock - chunkOrigin, glm::ivec3(0));
+                glm::ivec3 localMax = glm::min(maxBlock - chunkOrigin, CHUNK_SIZE - 1);
+                const BlockType* blocks = chunk->getBlockData();
+
+                for (int z = localMin.z; z <= localMax.z; ++z) {
+                    for (int y = localMin.y; y <= localMax.y; ++y) {
+                        glm::ivec3 regionPos = chunkOrigin + glm::ivec3(localMin.x, y, z) - minBlock;
+                        size_t regionIndex = regionPos.x + region.size.x * (regionPos.y + static_cast<size_t>(region.size.y) * regionPos.z);
+                        const BlockType* row = blocks + Chunk::localIndex(localMin.x, y, z);
+                        std::copy(row, row + (localMax.x - localMin.x + 1), region.blocks.begin() + regionIndex);
+                    }
+                }
+            }
+        }
+    }
+    return region;
+}
+
+ChangeSet WorldEdit::pasteRegion(const BlockRegion& region, const glm::ivec3& origin, bool skipAir) {
+    if (region.size.x <= 0 || region.size.y <= 0 || region.size.z <= 0) return ChangeSet();
+    return editBox(origin, origin + region.size - 1, [&region, origin, skipAir](const glm::ivec3& worldPos, BlockType oldType) {
+        glm::ivec3 regionPos = worldPos - origin;
+        BlockType type = region.get(regionPos.x, regionPos.y, regionPos.z);
+        return (skipAir && type == BlockType::Air) ? oldType : type;
+    });
+}
+
+ChangeSet WorldEdit::applyEdits(const std::vector<BlockEdit>& edits) {
+    ChangeSet changeSet;
+    if (edits.empty()) return changeSet;
+
+    // Group edits by chunk. Stable, so repeated edits of one block keep their order.
+    struct LocatedEdit {
+        glm::ivec3 chunkCoord;
+        uint16_t index;
+        BlockType type;
+    };
+    std::vector<LocatedEdit> located;
+    located.reserve(edits.size());
+    for (const BlockEdit& edit : edits) {
+        glm::ivec3 chunkCoord = World::worldBlockToChunkCoord(edit.worldBlockPos);
+        glm::ivec3 local = World::worldBlockToLocalCoord(edit.worldBlockPos);
+        located.push_back({chunkCoord, static_cast<uint16_t>(Chunk::localIndex(local.x, local.y, local.z)), edit.type});
+    }
+    Ivec3Compare compare;
+    std::stable_sort(located.begin(), located.end(), [&compare](const LocatedEdit& a, const LocatedEdit& b) {
+        return compare(a.chunkCoord, b.chunkCoord);
+    });
+
+    for (size_t i = 0; i < located.size(); ) {
+        size_t groupEnd = i + 1;
+        while (groupEnd < located.size() && located[groupEnd].chunkCoord == located[i].chunkCoord) ++groupEnd;
+
+        Chunk* chunk = prepareChunk(located[i].chunkCoord);
+        if (chunk) {
+            BlockType* blocks = chunk->getBlockDataForWrite();
+            ChangeSet::ChunkChanges chunkChanges;
+            chunkChanges.chunkCoord = located[i].chunkCoord;
+            for (size_t j = i; j < groupEnd; ++j) {
+                BlockType oldType = blocks[located[j].index];
+                if (oldType != located[j].type) {
+                    blocks[located[j].index] = located[j].type;
+                    chunkChanges.indices.push_back(located[j].index);
+                    chunkChanges.oldTypes.push_back(oldType);
+                    chunkChanges.newTypes.push_back(located[j].type);
+                }
+            }
+            finishChunk(chunk, chunkChanges, changeSet);
+        }
+        i = groupEnd;
+    }
+    return changeSet;
+}
+
+ChangeSet WorldEdit::revert(const ChangeSet& changes) {
+    ChangeSet changeSet;
+    for (const ChangeSet::ChunkChanges& original : changes.getChunks()) {
+        Chunk* chunk = prepareChunk(original.chunkCoord);
+        if (!chunk) continue;
+
+        BlockType* blocks = chunk->getBlockDataForWrite();
+        ChangeSet::ChunkChanges chunkChanges;
+        chunkChanges.chunkCoord = original.chunkCoord;
+        // Newest first, so a block changed twice ends up with its oldest type
+        for (size_t i = original.indices.size(); i-- > 0; ) {
+            uint16_t index = original.indices[i];
+            BlockType current = blocks[index];
+            if (current != original.oldTypes[i]) {
+                blocks[index] = original.oldTypes[i];
+                chunkChanges.indices.push_back(index);
+                chunkChanges.oldTypes.push_back(current);
+                chunkChanges.newTypes.push_back(original.oldTypes[i]);
+            }
+        }
+        finishChunk(chunk, chunkChanges, changeSet);
+    }
+    return changeSet;
+}
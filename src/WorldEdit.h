@@ -0,0 +1,88 @@
+#ifndef WORLDEDIT_H
+#define WORLDEDIT_H
+
+#include "BlockType.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class World;
+class Chunk;
+
+// Record of the blocks changed by one bulk edit, grouped per chunk.
+// Each change costs 4 bytes (local index + old type + new type).
+class ChangeSet {
+public:
+    struct ChunkChanges {
+        glm::ivec3 chunkCoord;
+        std::vector<uint16_t> indices;   // Chunk::localIndex of each changed block
+        std::vector<BlockType> oldTypes;
+        std::vector<BlockType> newTypes;
+    };
+
+    const std::vector<ChunkChanges>& getChunks() const { return m_chunks; }
+    size_t getChangeCount() const { return m_changeCount; }
+    bool empty() const { return m_changeCount == 0; }
+
+    // World position of the i-th change of a chunk entry
+    static glm::ivec3 worldPositionOf(const ChunkChanges& chunkChanges, size_t i);
+
+private:
+    friend class WorldEdit;
+    std::vector<ChunkChanges> m_chunks;
+    size_t m_changeCount = 0;
+};
+
+// A box of blocks copied out of the world, for pasting elsewhere.
+struct BlockRegion {
+    glm::ivec3 size = glm::ivec3(0);
+    std::vector<BlockType> blocks; // x fastest, then y, then z
+
+    BlockType get(int x, int y, int z) const { return blocks[x + size.x * (y + size.y * z)]; }
+};
+
+// A single entry of an edit list
+struct BlockEdit {
+    glm::ivec3 worldBlockPos;
+    BlockType type;
+};
+
+// Bulk block editing. Unlike World::setBlock, every operation walks the affected chunks one at a
+// time, writes their block arrays directly and marks each touched chunk for remeshing exactly once,
+// so an explosion or a pasted structure costs one remesh per chunk instead of one per block.
+// Box bounds are inclusive world block coordinates and may be given in any order.
+class WorldEdit {
+public:
+    explicit WorldEdit(World& world);
+
+    ChangeSet fillBox(const glm::ivec3& corner1, const glm::ivec3& corner2, BlockType type);
+    ChangeSet replace(const glm::ivec3& corner1, const glm::ivec3& corner2, BlockType from, BlockType to);
+    ChangeSet fillSphere(const glm::vec3& center, float radius, BlockType type);
+
+    BlockRegion copyRegion(const glm::ivec3& corner1, const glm::ivec3& corner2) const;
+    // Pastes with the region's minimum corner at origin. With skipAir, air in the region leaves
+    // the world untouched (useful for structures).
+    ChangeSet pasteRegion(const BlockRegion& region, const glm::ivec3& origin, bool skipAir = false);
+
+    // Applies an arbitrary list of edits. If a block appears several times, the last edit wins.
+    ChangeSet applyEdits(const std::vector<BlockEdit>& edits);
+
+    // Restores the old types recorded in a change set (undo). Returns the changes made by the undo.
+    ChangeSet revert(const ChangeSet& changes);
+
+private:
+    // Generic per-chunk box walker. For every block in [minBlock, maxBlock], newTypeFor(worldPos, oldType)
+    // returns the type to store (returning oldType leaves the block alone).
+    template <typename NewTypeFn>
+    ChangeSet editBox(const glm::ivec3& minBlock, const glm::ivec3& maxBlock, NewTypeFn newTypeFor);
+
+    // Returns a chunk ready for editing (set up through World: loaded from storage or generated),
+    // or nullptr if the chunk can't exist.
+    Chunk* prepareChunk(const glm::ivec3& chunkCoord);
+    // Marks the chunk dirty, tells World listeners and appends the entry to the change set.
+    void finishChunk(Chunk* chunk, ChangeSet::ChunkChanges& chunkChanges, ChangeSet& changeSet);
+
+    World& m_world;
+};
+
+#endif // WORLDEDIT_H
@@ -0,0 +1,141 @@
+// WorldPregen: generates chunks into a world directory ahead of time, so a server (or the game,
+// started with --world <dir>) loads them from WorldStorage instead of paying generation live.
+//
+// Usage: WorldPregen <world dir> [--radius R | --square N] [--center X Z] [--threads T] [--scaling]
+//   --radius R   chunks within R chunks of the center (default 16)
+//   --square N   an N x N chunk square around the center instead
+//   --center X Z center chunk (default 0 0); chunks exist in the y = 0 layer only
+//   --threads T  generation threads (default: all hardware threads)
+//   --scaling    afterwards, time generation alone at 1, 2, 4, ... threads for the per-core scaling
+#include "Chunk.h"
+#include "ThreadPool.h"
+#include "WorldStorage.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib> // For std::atoi
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const size_t CHUNKS_PER_BATCH = 16; // Per ThreadPool::parallelFor range
+
+static void printUsage() {
+    std::cerr << "Usage: WorldPregen <world dir> [--radius R | --square N] [--center X Z] [--threads T] [--scaling]" << std::endl;
+}
+
+// Chunk coordinates of the area, nearest to the center first (so a partial run covers the middle)
+static std::vector<glm::ivec3> buildArea(const glm::ivec3& center, int radius, int squareSize) {
+    std::vector<glm::ivec3> area;
+    int reach = squareSize > 0 ? squareSize / 2 : radius;
+    for (int dx = -reach; dx <= reach; ++dx) {
+        for (int dz = -reach; dz <= reach; ++dz) {
+            if (squareSize > 0) {
+                // N x N: for even N the extra row and column go to the negative side
+                if (dx >= squareSize - reach || dz >= squareSize - reach) continue;
+            } else if (dx * dx + dz * dz > radius * radius) {
+                continue;
+            }
+            area.push_back(center + glm::ivec3(dx, 0, dz));
+        }
+    }
+    std::sort(area.begin(), area.end(), [&center](const glm::ivec3& a, const glm::ivec3& b) {
+        glm::ivec3 da = a - center, db = b - center;
+        return da.x * da.x + da.z * da.z < db.x * db.x + db.z * db.z;
+    });
+    return area;
+}
+
+// Generates (and, with storage, saves) every chunk of area on threadCount threads. Returns seconds taken.
+static double generateArea(const std::vector<glm::ivec3>& area, unsigned threadCount, const WorldStorage* storage,
+                           std::atomic<size_t>& failedWrites) {
+    auto generateRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Chunk chunk(area[i]); // Standalone: no World, no scheduler
+            chunk.generateSimpleTerrain();
+            if (storage && !storage->saveChunk(chunk)) failedWrites.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (threadCount <= 1) {
+        generateRange(0, area.size());
+    } else {
+        ThreadPool pool(threadCount - 1); // The calling thread works too
+        pool.parallelFor(area.size(), CHUNKS_PER_BATCH, generateRange);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argv[1][0] == '-') {
+        printUsage();
+        return 1;
+    }
+    std::string worldDirectory = argv[1];
+    glm::ivec3 center(0);
+    int radius = 16;
+    int squareSize = 0;
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    bool measureScaling = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--radius" && i + 1 < argc) {
+            radius = std::max(0, std::atoi(argv[++i]));
+            squareSize = 0;
+        } else if (arg == "--square" && i + 1 < argc) {
+            squareSize = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--center" && i + 2 < argc) {
+            center.x = std::atoi(argv[++i]);
+            center.z = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threadCount = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--scaling") {
+            measureScaling = true;
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+    }
+
+    WorldStorage storage;
+    storage.setDirectory(worldDirectory);
+    if (!storage.isEnabled()) return 1;
+
+    std::vector<glm::ivec3> area = buildArea(center, radius, squareSize);
+    std::cout << "Pre-generating " << area.size() << " chunks (";
+    if (squareSize > 0) std::cout << squareSize << "x" << squareSize; else std::cout << "radius " << radius;
+    std::cout << " around chunk " << center.x << ", " << center.z << ") into " << worldDirectory << " on "
+              << threadCount << (threadCount == 1 ? " thread" : " threads") << std::endl;
+
+    std::atomic<size_t> failedWrites(0);
+    double seconds = generateArea(area, threadCount, &storage, failedWrites);
+    double chunksPerSecond = seconds > 0.0 ? area.size() / seconds : 0.0;
+    std::cout << std::fixed << std::setprecision(2) << "Done: " << area.size() << " chunks in " << seconds << " s, "
+              << std::setprecision(0) << chunksPerSecond << " chunks/s (" << chunksPerSecond / threadCount
+              << " per thread)" << std::endl;
+    if (failedWrites > 0) {
+        std::cerr << failedWrites << " chunks could not be written" << std::endl;
+    }
+
+    if (measureScaling) {
+        // Generation alone, so disk speed doesn't hide how the work spreads over cores
+        std::cout << "Scaling (generation only, no writes):" << std::endl;
+        std::cout << "  threads   chunks/s   speedup   efficiency" << std::endl;
+        double singleRate = 0.0;
+        for (unsigned threads = 1; ; threads = std::min(threads * 2, threadCount)) {
+            std::atomic<size_t> unused(0);
+            double rate = area.size() / std::max(generateArea(area, threads, nullptr, unused), 1e-9);
+            if (threads == 1) singleRate = rate;
+            double speedup = rate / singleRate;
+            std::cout << std::setw(9) << threads << std::setw(11) << std::setprecision(0) << rate
+                      << std::setw(10) << std::setprecision(2) << speedup
+                      << std::setw(12) << std::setprecision(0) << 100.0 * speedup / threads << "%" << std::endl;
+            if (threads == threadCount) break;
+        }
+    }
+    return failedWrites > 0 ? 1 : 0;
+}
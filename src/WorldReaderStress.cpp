@@ -0,0 +1,151 @@
+// WorldReaderStress: reads the world from other threads through World's published snapshots
+// (getChunkIndex / getBlockSnapshot) while the simulation thread edits blocks, loads and unloads
+// chunks and publishes every tick. Meant to run under ThreadSanitizer (cmake -DENABLE_TSAN=ON),
+// which reports any access that isn't properly published; the readers also check what they get:
+//   - a snapshot's blocks never change while a reader holds it
+//   - for the same chunk, the versions a reader sees never go backwards
+//   - a snapshot's version is never ahead of its chunk's getVersion()
+//
+// Usage: WorldReaderStress [--ticks N] [--readers R]   (defaults: 300 ticks, 4 readers)
+#include "World.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib> // For std::atoi
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+static const int AREA_RADIUS = 2;        // Chunks loaded around the origin (5 x 5)
+static const int EDITS_PER_TICK = 32;
+static const int RELOAD_INTERVAL = 20;   // Ticks between unloading or loading the extra chunk column
+static const size_t HELD_SNAPSHOTS = 64; // Snapshots a reader keeps to check them again later
+
+static uint64_t checksumOf(const Chunk::BlockSnapshot& snapshot) {
+    uint64_t hash = 14695981039346656037ull; // FNV-1a
+    for (BlockType type : snapshot.blocks) {
+        hash = (hash ^ static_cast<uint8_t>(type)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+struct ReaderStats {
+    uint64_t indexReads = 0;
+    uint64_t snapshotsChecked = 0;
+    uint64_t failures = 0;
+};
+
+static void runReader(const World& world, const std::atomic<bool>& stop, ReaderStats& stats) {
+    struct Held {
+        Chunk::BlockSnapshotPtr snapshot;
+        uint64_t checksum;
+    };
+    std::vector<Held> held;
+    std::unordered_map<const Chunk*, uint64_t> lastVersions; // Chunks stay alive while an index holds them
+    std::shared_ptr<const World::ChunkIndex> previousIndex;
+    size_t nextHeld = 0;
+
+    while (!stop.load(std::memory_order_acquire)) {
+        std::shared_ptr<const World::ChunkIndex> index = world.getChunkIndex();
+        ++stats.indexReads;
+        if (!index) continue;
+        if (index != previousIndex) {
+            // Chunks in the old index only may be destroyed once it's released; forget their versions
+            lastVersions.clear();
+            previousIndex = index;
+        }
+        for (const auto& pair : *index) {
+            const Chunk& chunk = *pair.second;
+            Chunk::BlockSnapshotPtr snapshot = chunk.getBlockSnapshot();
+            Chunk::BlockSnapshotPtr byCoord = world.getBlockSnapshot(pair.first); // Possibly a newer index
+            if (!snapshot) continue;
+            ++stats.snapshotsChecked;
+            if (snapshot->version > chunk.getVersion()) ++stats.failures;
+            uint64_t& lastVersion = lastVersions[&chunk];
+            if (snapshot->version < lastVersion) ++stats.failures;
+            lastVersion = snapshot->version;
+            if (byCoord && byCoord.get() != snapshot.get() && byCoord->version < snapshot->version &&
+                world.getChunkIndex() == index) {
+                ++stats.failures; // Same index, same chunk: the later read can't be older
+            }
+
+            Held entry{snapshot, checksumOf(*snapshot)};
+            if (held.size() < HELD_SNAPSHOTS) {
+                held.push_back(std::move(entry));
+            } else {
+                held[nextHeld] = std::move(entry);
+                nextHeld = (nextHeld + 1) % HELD_SNAPSHOTS;
+            }
+        }
+        for (const Held& entry : held) {
+            if (checksumOf(*entry.snapshot) != entry.checksum) ++stats.failures; // Written after publishing
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    int tickCount = 300;
+    int readerCount = 4;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) {
+            tickCount = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--readers" && i + 1 < argc) {
+            readerCount = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: WorldReaderStress [--ticks N] [--readers R]" << std::endl;
+            return 1;
+        }
+    }
+
+    World world;
+    for (int x = -AREA_RADIUS; x <= AREA_RADIUS; ++x) {
+        for (int z = -AREA_RADIUS; z <= AREA_RADIUS; ++z) world.ensureChunkExists(glm::ivec3(x, 0, z));
+    }
+    world.getScheduler().runAll();
+    world.publish();
+
+    std::atomic<bool> stop(false);
+    std::vector<ReaderStats> stats(readerCount);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < readerCount; ++i) {
+        readers.emplace_back(runReader, std::cref(world), std::cref(stop), std::ref(stats[i]));
+    }
+
+    // The simulation thread: edits above the ground, a chunk column coming and going, a publish per tick
+    std::mt19937 random(1234);
+    const int areaBlocks = (2 * AREA_RADIUS + 1) * Chunk::CHUNK_WIDTH;
+    const int areaStart = -AREA_RADIUS * Chunk::CHUNK_WIDTH;
+    bool extraLoaded = false;
+    for (int tick = 0; tick < tickCount; ++tick) {
+        for (int i = 0; i < EDITS_PER_TICK; ++i) {
+            glm::ivec3 pos(areaStart + static_cast<int>(random() % areaBlocks),
+                           Chunk::CHUNK_HEIGHT / 2 + 2 + static_cast<int>(random() % 4),
+                           areaStart + static_cast<int>(random() % areaBlocks));
+            world.setBlock(pos, world.getBlock(pos) == BlockType::Air ? BlockType::Stone : BlockType::Air);
+        }
+        if (tick % RELOAD_INTERVAL == 0) {
+            for (int z = -AREA_RADIUS; z <= AREA_RADIUS; ++z) {
+                glm::ivec3 chunkCoord(AREA_RADIUS + 1, 0, z);
+                if (extraLoaded) world.unloadChunk(chunkCoord); else world.ensureChunkExists(chunkCoord);
+            }
+            extraLoaded = !extraLoaded;
+        }
+        world.tick(); // Ends with publish()
+    }
+
+    stop.store(true, std::memory_order_release);
+    for (std::thread& reader : readers) reader.join();
+
+    ReaderStats total;
+    for (const ReaderStats& readerStats : stats) {
+        total.indexReads += readerStats.indexReads;
+        total.snapshotsChecked += readerStats.snapshotsChecked;
+        total.failures += readerStats.failures;
+    }
+    std::cout << tickCount << " ticks, " << readerCount << " readers: " << total.indexReads << " index reads, "
+              << total.snapshotsChecked << " snapshots checked, " << total.failures << " failures" << std::endl;
+    return total.failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,61 @@
+#include "WorldStorage.h"
+#include "Chunk.h"
+#include "FileUtils.h"
+#include "NetProtocol.h"
+#include <cstdio>     // For std::snprintf
+#include <filesystem> // For creating the world directory
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+static const uint32_t FILE_MAGIC = 0x4B4E4843; // "CHNK"
+static const uint32_t FILE_VERSION = 1;        // Bump when the block encoding changes
+static const uint32_t MAX_PAYLOAD_SIZE = 1 << 20; // Far above any encoded chunk; larger means a damaged file
+
+void WorldStorage::setDirectory(const std::string& directory) {
+    m_directory = directory;
+    if (m_directory.empty()) return;
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        std::cerr << "WorldStorage: cannot create " << m_directory << ": " << error.message()
+                  << ", world storage disabled" << std::endl;
+        m_directory.clear();
+    }
+}
+
+std::string WorldStorage::chunkPath(const glm::ivec3& chunkCoord) const {
+    char name[48];
+    std::snprintf(name, sizeof(name), "%d.%d.%d.chunk", chunkCoord.x, chunkCoord.y, chunkCoord.z);
+    return m_directory + "/" + name;
+}
+
+// File layout: magic, version, payload size, payload (a ChunkData packet). Native endianness.
+bool WorldStorage::saveChunk(const Chunk& chunk) const {
+    if (!isEnabled()) return false;
+    PacketBuffer payload = encodeChunkData(chunk);
+    return writeFileAtomically(chunkPath(chunk.getWorldPosition()), [&payload](std::ostream& file) {
+        uint32_t payloadSize = static_cast<uint32_t>(payload->size());
+        file.write(reinterpret_cast<const char*>(&FILE_MAGIC), sizeof(FILE_MAGIC));
+        file.write(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+        file.write(reinterpret_cast<const char*>(&payloadSize), sizeof(payloadSize));
+        file.write(reinterpret_cast<const char*>(payload->data()), payloadSize);
+    });
+}
+
+bool WorldStorage::loadChunk(const glm::ivec3& chunkCoord, std::vector<BlockType>& outBlocks) const {
+    if (!isEnabled()) return false;
+    std::ifstream file(chunkPath(chunkCoord), std::ios::binary);
+    if (!file) return false;
+    uint32_t magic = 0, version = 0, payloadSize = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&payloadSize), sizeof(payloadSize));
+    if (!file || magic != FILE_MAGIC || version != FILE_VERSION || payloadSize > MAX_PAYLOAD_SIZE) return false;
+    auto payload = std::make_shared<std::vector<uint8_t>>(payloadSize);
+    file.read(reinterpret_cast<char*>(payload->data()), payloadSize);
+    if (!file) return false;
+
+    glm::ivec3 storedCoord;
+    return decodeChunkData(payload, storedCoord, outBlocks) && storedCoord == chunkCoord;
+}
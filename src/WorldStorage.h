@@ -0,0 +1,38 @@
+#ifndef WORLDSTORAGE_H
+#define WORLDSTORAGE_H
+
+#include "BlockType.h"
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+class Chunk;
+
+// Chunks kept on disk in a world directory, one file per chunk ("<x>.<y>.<z>.chunk").
+//
+// A file holds the chunk's blocks, run-length encoded with the replication protocol's chunk
+// encoding (see encodeChunkData) behind a magic and version. Light isn't stored: LightEngine
+// lights a chunk again when it is loaded. Written by the WorldPregen tool; World reads a chunk
+// from here instead of generating it when the file exists.
+//
+// Chunks are independent files with no shared state, so any thread can save or load.
+class WorldStorage {
+public:
+    // World directory (created if missing); empty (the default) disables storage
+    void setDirectory(const std::string& directory);
+    bool isEnabled() const { return !m_directory.empty(); }
+    const std::string& getDirectory() const { return m_directory; }
+
+    // Writes the chunk's blocks; false if storage is disabled or the write failed
+    bool saveChunk(const Chunk& chunk) const;
+    // Reads the blocks stored for chunkCoord into outBlocks (Chunk::CHUNK_VOLUME entries).
+    // False if there is no file or it is damaged; the chunk is then generated as usual.
+    bool loadChunk(const glm::ivec3& chunkCoord, std::vector<BlockType>& outBlocks) const;
+
+private:
+    std::string chunkPath(const glm::ivec3& chunkCoord) const;
+
+    std::string m_directory;
+};
+
+#endif // WORLDSTORAGE_H
@@ -2,6 +2,12 @@
 #include <iostream>
 #include <sstream> // For formatting strings for debug output
 #include <iomanip> // For std::setprecision and std::fixed
+#include <string>
+#include <cstdlib> // For std::atof, std::atoi
+#include <unordered_map>
+#include <vector>
+#include <algorithm> // For std::sort (replay report)
+#include <chrono>    // For timing replayed frames
 
 // GLFW - Must be included before GLAD
 #include <GLFW/glfw3.h>
@@ -9,16 +15,29 @@
 // GLAD - Must be included after GLFW
 #include <glad/glad.h> // We will set up GLAD later
 
-#include "Renderer.h" // Include our new Renderer header
 #include "Camera.h" // Include Camera header
 #include "World.h" // Include World header
-#include "TextRenderer.h" // Include TextRenderer header
-
-// Make World and Renderer instances global for access in callbacks for now
+#include "FixedTimestep.h" // Fixed-rate simulation ticks
+#include "RenderThread.h" // Rendering runs on its own thread, fed by FrameSnapshots
+#include "ThreadPool.h" // Worker threads for parallel simulation work
+#include "EntitySystem.h" // Player, mobs and dropped items
+#include "TerrainLod.h" // Chunk loading around the player and distant low-detail terrain
+#include "ChunkPrefetcher.h" // Chunk loading ahead of fast travel
+#include "Logger.h" // Asynchronous logging
+#include "MemoryStats.h" // Memory use per subsystem
+#include "InputRecording.h" // Input recording and replay (--record, --replay)
+
+// Make World and RenderThread instances global for access in callbacks for now
 // This is not ideal for large projects but simplifies this step.
-Renderer g_renderer;
+// Everything here is owned by the main (simulation) thread; the render thread only sees
+// the snapshots published to g_renderThread.
+RenderThread g_renderThread;
 World g_world;
-TextRenderer* g_textRenderer = nullptr; // Global TextRenderer pointer
+TerrainLod g_terrainLod(g_world); // Loads the near chunks into g_world, meshes far ones at reduced detail
+ChunkPrefetcher g_chunkPrefetcher(g_world); // Loads chunks along the camera's predicted path
+ThreadPool g_threadPool;
+EntitySystem g_entities(&g_threadPool); // Entity physics runs in parallel batches on g_threadPool
+EntityId g_playerEntity = INVALID_ENTITY; // The local player's body; the camera sits at its eyes
 bool g_showDebugInfo = false; // Toggle for F3 debug screen
 
 // Globals for window size (for framebuffer_size_callback)
@@ -35,32 +54,83 @@ Camera g_camera(glm::vec3(8.0f, 10.0f, 8.0f), // X=8, Z=8 (center of 0,0,0 chunk
 bool g_firstMouse = true;
 float g_lastX = 400, g_lastY = 300;
 
+// Input recording (--record) and replay (--replay). While replaying, live input is ignored.
+InputRecorder g_inputRecorder;
+bool g_replaying = false;
+int g_replayChunkJobs = 8; // Chunk jobs per replayed tick (--chunk-jobs), in place of the time budget
+
 // Raycasting distance and target block
 const float MAX_RAYCAST_DISTANCE = 5.0f;
 World::RaycastResult g_targetedBlock; // Stores the block currently looked at
+BlockType g_selectedBlock = BlockType::Stone; // Block placed with right click, chosen with keys 1-6
 
 // Timing
-float g_deltaTime = 0.0f;
+float g_deltaTime = 0.0f; // Real time of the last simulation loop iteration
 float g_lastFrame = 0.0f;
 
+// Simulation runs at a fixed rate; rendering interpolates between the last two ticks.
+const double SIMULATION_TICK_RATE = 60.0;
+FixedTimestep g_timestep(SIMULATION_TICK_RATE);
+glm::vec3 g_previousTickPosition = g_camera.Position; // Camera position at the start of the last tick
+
+// Movement intent sampled from the keyboard every frame and consumed by simulation ticks
+struct PlayerInput {
+    bool forward = false;
+    bool backward = false;
+    bool left = false;
+    bool right = false;
+    bool ascend = false;   // Space: jump, or fly up when flying
+    bool descend = false;  // Left shift: fly down
+    bool suppressAscend = false; // Set on the frame a double tap toggled flight
+};
+PlayerInput g_input;
+
 // Flight mode globals
 const float DOUBLE_TAP_TIME_THRESHOLD = 0.25f; // seconds for double tap
 float g_lastSpacePressTime = -1.0f;         // Time of the last spacebar press, init to invalid
 const float FLY_SPEED = 5.0f;               // How fast to ascend/descend when flying
 
-// Callback for mouse button events
-void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+// Dropped items
+const float ITEM_SIZE = 0.25f;
+const float ITEM_PICKUP_DELAY = 0.5f;   // Seconds before a dropped item can be picked up
+const float ITEM_LIFETIME = 300.0f;     // Seconds before an item on the ground disappears
+int g_itemsPickedUp = 0;
+
+// Mobs (spawned with G) walk to the player along paths from the world's Pathfinder
+const float MOB_SPEED = 3.0f;
+const float MOB_REPATH_INTERVAL = 1.0f; // Seconds between path requests towards the player
+const float MOB_WAYPOINT_RADIUS = 0.2f; // How close to a path cell's center counts as reached
+struct MobState {
+    std::vector<glm::ivec3> path; // Feet cells, from the last path result
+    size_t nextCell = 0;
+    float repathTimer = 0.0f;
+    PathRequestId pendingRequest = 0; // 0 if none
+};
+std::unordered_map<EntityId, MobState> g_mobs;
+
+// Breaks or places the targeted block. Called for live clicks and replayed ones.
+void applyMouseButton(int button, int action) {
     if (action == GLFW_PRESS) {
         // Use the continuously updated g_targetedBlock for interactions
         if (g_targetedBlock.hit) {
-            std::cout << "Mouse click: Button " << button << " Action " << action << std::endl;
-            std::cout << "  Targeted Block: (" << g_targetedBlock.blockHit.x << ", " << g_targetedBlock.blockHit.y << ", " << g_targetedBlock.blockHit.z << ")";
-            std::cout << " Before: (" << g_targetedBlock.blockBefore.x << ", " << g_targetedBlock.blockBefore.y << ", " << g_targetedBlock.blockBefore.z << ")" << std::endl;
+            LOG_DEBUG(LogCategory::Input, "Mouse click: Button {} Action {}", button, action);
+            LOG_DEBUG(LogCategory::Input, "  Targeted Block: ({}, {}, {}) Before: ({}, {}, {})",
+                      g_targetedBlock.blockHit.x, g_targetedBlock.blockHit.y, g_targetedBlock.blockHit.z,
+                      g_targetedBlock.blockBefore.x, g_targetedBlock.blockBefore.y, g_targetedBlock.blockBefore.z);
 
             if (button == GLFW_MOUSE_BUTTON_LEFT) { 
                 // Try to break the block that was hit, if it's not air
-                if (g_targetedBlock.hit && g_world.getBlock(g_targetedBlock.blockHit) != BlockType::Air) {
+                BlockType brokenType = g_world.getBlock(g_targetedBlock.blockHit);
+                if (g_targetedBlock.hit && brokenType != BlockType::Air) {
                     g_world.setBlock(g_targetedBlock.blockHit, BlockType::Air);
+                    if (isSolid(brokenType)) {
+                        // Drop an item that pops out of the block
+                        glm::vec3 dropPos = glm::vec3(g_targetedBlock.blockHit) + glm::vec3(0.5f, 0.25f, 0.5f);
+                        EntityId item = g_entities.spawn(EntityType::Item, dropPos, ITEM_SIZE, ITEM_SIZE);
+                        if (item != INVALID_ENTITY) {
+                            g_entities.setVelocity(item, glm::vec3(0.0f, 4.0f, 0.0f));
+                        }
+                    }
                 }
             } else if (button == GLFW_MOUSE_BUTTON_RIGHT) { 
                 // Try to place a block in the 'blockBefore' position, 
@@ -68,16 +138,23 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
                 if (g_targetedBlock.hit && g_world.getBlock(g_targetedBlock.blockHit) != BlockType::Air) {
                      // And ensure blockBefore is actually air before placing
                     if (g_world.getBlock(g_targetedBlock.blockBefore) == BlockType::Air) {
-                        g_world.setBlock(g_targetedBlock.blockBefore, BlockType::Stone); 
+                        g_world.setBlock(g_targetedBlock.blockBefore, g_selectedBlock); 
                     }
                 }
             }
         } else {
-             std::cout << "Mouse click: No target block hit." << std::endl;
+             LOG_DEBUG(LogCategory::Input, "Mouse click: No target block hit.");
         }
     }
 }
 
+// Callback for mouse button events
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+    if (g_replaying) return;
+    g_inputRecorder.addMouseButton(button, action);
+    applyMouseButton(button, action);
+}
+
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     g_windowWidth = width;
     g_windowHeight = height;
@@ -88,19 +165,8 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
         g_camera.WindowHeight = height;
     }
 
-    // The most direct approach is if Renderer has a global instance or is passed around.
-    // Let's assume for now that the projection matrix used by the renderer is updated based on camera in beginFrame.
-    // And glViewport should be called here.
-    glViewport(0, 0, width, height);
-
-    if (g_textRenderer) { // Update TextRenderer projection
-        g_textRenderer->setWindowSize(width, height);
-    }
-
-    // The initial renderer.init call also calls setViewport.
-    // If Renderer instance is available here:
-    // extern Renderer g_renderer_instance; // If it were global
-    // g_renderer_instance.setViewport(0,0,width,height); 
+    // No GL calls here: the context belongs to the render thread. The new size travels with
+    // the next FrameSnapshot and the render thread updates its viewport and text projection.
 
     // Tell GLFW to capture our mouse and set mouse button callback
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
@@ -108,6 +174,7 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
 }
 
 void mouse_callback(GLFWwindow* window, double xposIn, double yposIn) {
+    if (g_replaying) return;
     float xpos = static_cast<float>(xposIn);
     float ypos = static_cast<float>(yposIn);
 
@@ -123,6 +190,7 @@ void mouse_callback(GLFWwindow* window, double xposIn, double yposIn) {
     g_lastX = xpos;
     g_lastY = ypos;
 
+    g_inputRecorder.addMouseMove(xoffset, yoffset);
     g_camera.ProcessMouseMovement(xoffset, yoffset);
 }
 
@@ -130,39 +198,75 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
     g_camera.ProcessMouseScroll(static_cast<float>(yoffset));
 }
 
-void processInput(GLFWwindow *window) {
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
+// Keys held right now, as InputKey bits (what processInput() reads, and what gets recorded)
+uint32_t sampleKeys(GLFWwindow* window) {
+    const int glfwKeys[] = { GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D, GLFW_KEY_SPACE, GLFW_KEY_LEFT_SHIFT,
+                             GLFW_KEY_F3, GLFW_KEY_F4, GLFW_KEY_G };
+    const uint32_t keyBits[] = { KEY_W, KEY_A, KEY_S, KEY_D, KEY_SPACE, KEY_LEFT_SHIFT, KEY_F3, KEY_F4, KEY_G };
+    uint32_t keys = 0;
+    for (int i = 0; i < 9; ++i) {
+        if (glfwGetKey(window, glfwKeys[i]) == GLFW_PRESS) keys |= keyBits[i];
+    }
+    for (int i = 0; i < 6; ++i) {
+        if (glfwGetKey(window, GLFW_KEY_1 + i) == GLFW_PRESS) keys |= KEY_1 << i;
+    }
+    return keys;
+}
 
+// Applies the held keys (sampleKeys) once per main loop iteration. currentTime is in seconds
+// (glfwGetTime, or the recorded time when replaying) and times double taps.
+void processInput(uint32_t keys, float currentTime) {
     // F3 Toggle for Debug Info
     static bool f3_pressed_last_frame = false;
-    bool f3_currently_pressed = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+    bool f3_currently_pressed = (keys & KEY_F3) != 0;
     if (f3_currently_pressed && !f3_pressed_last_frame) {
         g_showDebugInfo = !g_showDebugInfo;
     }
     f3_pressed_last_frame = f3_currently_pressed;
 
+    // F4 writes the memory breakdown to the log
+    static bool f4_pressed_last_frame = false;
+    bool f4_currently_pressed = (keys & KEY_F4) != 0;
+    if (f4_currently_pressed && !f4_pressed_last_frame) {
+        LOG_INFO(LogCategory::General, "Loaded chunks: {}", g_world.getLoadedChunks().size());
+        MemoryStats::dump();
+    }
+    f4_pressed_last_frame = f4_currently_pressed;
+
+    // G spawns a mob on the targeted block
+    static bool g_pressed_last_frame = false;
+    bool g_currently_pressed = (keys & KEY_G) != 0;
+    if (g_currently_pressed && !g_pressed_last_frame && g_targetedBlock.hit) {
+        glm::vec3 feet = glm::vec3(g_targetedBlock.blockBefore) + glm::vec3(0.5f, 0.0f, 0.5f);
+        EntityId mob = g_entities.spawn(EntityType::Mob, feet, PLAYER_WIDTH, PLAYER_HEIGHT);
+        if (mob != INVALID_ENTITY) g_mobs[mob] = MobState();
+    }
+    g_pressed_last_frame = g_currently_pressed;
+
+    // Number keys pick the block to place: 1 Stone, 2 Dirt, 3 Grass, 4 Torch, 5 Water, 6 Lava
+    const BlockType placeableBlocks[] = { BlockType::Stone, BlockType::Dirt, BlockType::Grass, BlockType::Torch, BlockType::Water, BlockType::Lava };
+    for (int i = 0; i < 6; ++i) {
+        if (keys & (KEY_1 << i)) g_selectedBlock = placeableBlocks[i];
+    }
+
     // --- Flight and Jump Logic ---
     static bool space_key_physically_down_last_frame = false; // For detecting rising edge of space press
     bool flight_toggled_this_press_event = false;             // True if a double tap toggled flight in this specific press event
 
-    bool space_key_is_currently_pressed = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+    bool space_key_is_currently_pressed = (keys & KEY_SPACE) != 0;
 
     // 1. Handle Double-Tap Toggle on Space Key Press (rising edge)
     if (space_key_is_currently_pressed && !space_key_physically_down_last_frame) {
-        float currentTime = static_cast<float>(glfwGetTime());
         if (g_lastSpacePressTime > 0.0f && (currentTime - g_lastSpacePressTime) < DOUBLE_TAP_TIME_THRESHOLD) {
             // Double tap detected
             g_camera.isFlying = !g_camera.isFlying;
             flight_toggled_this_press_event = true; // Mark that flight was toggled by this press
             if (g_camera.isFlying) {
-                // g_camera.verticalVelocity = 0.0f; // Stop any fall/jump velocity <-- OLD
-                g_camera.Velocity.y = 0.0f; // Stop any fall/jump velocity
-                g_camera.isOnGround = false;      // Cannot be on ground if starting to fly
-                std::cout << "Flight mode ON (double tap)" << std::endl;
+                // Fall/jump velocity is dropped by the next tick, which drives a flying player directly
+                LOG_INFO(LogCategory::Input, "Flight mode ON (double tap)");
             } else {
-                std::cout << "Flight mode OFF (double tap)" << std::endl;
-                // Gravity will take over. isOnGround will be updated by physics.
+                LOG_INFO(LogCategory::Input, "Flight mode OFF (double tap)");
+                // Gravity will take over. Ground contact is updated by the entity physics.
             }
             // Reset lastSpacePressTime to effectively consume the double tap,
             // preventing it from becoming the first tap of another potential double tap immediately.
@@ -174,42 +278,422 @@ void processInput(GLFWwindow *window) {
     }
     space_key_physically_down_last_frame = space_key_is_currently_pressed;
 
-    // 2. Handle Continuous Actions (Flying or Jumping) based on current key states
-    //    Only if flight wasn't *just* toggled by the most recent press event that occurred on this frame.
-    if (!flight_toggled_this_press_event) {
-        if (g_camera.isFlying) {
-            // Flying controls
-            if (space_key_is_currently_pressed) { // Space to ascend
-                g_camera.Position.y += FLY_SPEED * g_deltaTime;
-            }
-            if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS) { // Left Shift to descend
-                g_camera.Position.y -= FLY_SPEED * g_deltaTime;
+    // 2. Sample continuous actions (flying, jumping, walking). They are applied by simulateTick()
+    //    at the fixed tick rate so movement no longer depends on frame rate.
+    //    A press that just toggled flight doesn't also count as a jump/ascend.
+    if (flight_toggled_this_press_event) g_input.suppressAscend = true; // Cleared by the next tick
+    g_input.ascend = space_key_is_currently_pressed;
+    g_input.descend = (keys & KEY_LEFT_SHIFT) != 0;
+    // --- End Flight and Jump Logic ---
+
+    g_input.forward = (keys & KEY_W) != 0;
+    g_input.backward = (keys & KEY_S) != 0;
+    g_input.left = (keys & KEY_A) != 0;
+    g_input.right = (keys & KEY_D) != 0;
+}
+
+// Steers every mob along its path and asks for a new path to the player now and then.
+// Results arrive from g_world.tick(), which serves the Pathfinder's queue.
+void updateMobs(float tickSeconds) {
+    glm::ivec3 playerCell = glm::ivec3(glm::floor(g_entities.getPosition(g_playerEntity)));
+    for (auto& entry : g_mobs) {
+        EntityId id = entry.first;
+        MobState& mob = entry.second;
+        glm::vec3 feet = g_entities.getPosition(id);
+
+        mob.repathTimer -= tickSeconds;
+        if (mob.repathTimer <= 0.0f && mob.pendingRequest == 0) {
+            mob.repathTimer = MOB_REPATH_INTERVAL;
+            mob.pendingRequest = g_world.getPathfinder().requestPath(glm::ivec3(glm::floor(feet)), playerCell,
+                [id](const PathResult& result) {
+                    auto it = g_mobs.find(id);
+                    if (it == g_mobs.end()) return;
+                    it->second.pendingRequest = 0;
+                    if (!result.found) return; // Keep following the old path
+                    it->second.path = result.cells;
+                    it->second.nextCell = 1; // cells[0] is where the mob stood when it asked
+                });
+        }
+
+        // Walk towards the next path cell not reached yet, jumping when it is a step up
+        glm::vec3 velocity = g_entities.getVelocity(id);
+        velocity.x = 0.0f;
+        velocity.z = 0.0f;
+        while (mob.nextCell < mob.path.size()) {
+            const glm::ivec3& cell = mob.path[mob.nextCell];
+            glm::vec2 toCell(cell.x + 0.5f - feet.x, cell.z + 0.5f - feet.z);
+            if (glm::length(toCell) > MOB_WAYPOINT_RADIUS) {
+                glm::vec2 walk = glm::normalize(toCell) * MOB_SPEED;
+                velocity.x = walk.x;
+                velocity.z = walk.y;
+                if (cell.y > static_cast<int>(std::floor(feet.y + 0.01f)) && g_entities.hasFlag(id, EntitySystem::ON_GROUND)) {
+                    velocity.y = JUMP_FORCE;
+                }
+                break;
             }
+            ++mob.nextCell;
+        }
+        g_entities.setVelocity(id, velocity);
+    }
+}
+
+// Advances player movement, physics and the world by one fixed tick of tickSeconds.
+void simulateTick(float tickSeconds) {
+    g_previousTickPosition = g_camera.Position;
+
+    // Walking velocity from the camera's facing (ProcessKeyboard moves along Front/Right).
+    // Move the camera, measure, then put it back: the entity owns the position.
+    glm::vec3 walkStart = g_camera.Position;
+    if (g_input.forward)
+        g_camera.ProcessKeyboard(Camera_Movement::FORWARD, tickSeconds);
+    if (g_input.backward)
+        g_camera.ProcessKeyboard(Camera_Movement::BACKWARD, tickSeconds);
+    if (g_input.left)
+        g_camera.ProcessKeyboard(Camera_Movement::LEFT, tickSeconds);
+    if (g_input.right)
+        g_camera.ProcessKeyboard(Camera_Movement::RIGHT, tickSeconds);
+    glm::vec3 walkVelocity = (g_camera.Position - walkStart) / tickSeconds;
+    g_camera.Position = walkStart;
+
+    glm::vec3 velocity = g_entities.getVelocity(g_playerEntity);
+    if (g_camera.isFlying) {
+        // Flying: free movement along the view direction, no gravity or collision
+        velocity = walkVelocity;
+        if (!g_input.suppressAscend) {
+            if (g_input.ascend) velocity.y += FLY_SPEED;  // Space to ascend
+            if (g_input.descend) velocity.y -= FLY_SPEED; // Left Shift to descend
+        }
+    } else {
+        // Walking: horizontal speed from input, vertical from gravity and jumps
+        velocity.x = walkVelocity.x;
+        velocity.z = walkVelocity.z;
+        if (!g_input.suppressAscend && g_input.ascend && g_entities.hasFlag(g_playerEntity, EntitySystem::ON_GROUND)) {
+            velocity.y = JUMP_FORCE; // JUMP_FORCE from Camera.h
+            // If space is held, subsequent jumps will occur once the player is on the ground again.
+        }
+    }
+    g_input.suppressAscend = false; // Only suppress for the first tick after the toggle
+    g_entities.setFlag(g_playerEntity, EntitySystem::NO_GRAVITY | EntitySystem::NO_CLIP, g_camera.isFlying);
+    g_entities.setVelocity(g_playerEntity, velocity);
+
+    updateMobs(tickSeconds);
+
+    // --- Physics, Movement, and Collision Update (all entities, player included) ---
+    g_entities.update(tickSeconds, g_world);
+    g_camera.Position = g_entities.getPosition(g_playerEntity) + glm::vec3(0.0f, PLAYER_EYE_LEVEL, 0.0f);
+
+    // Pick up items touching the player, remove old ones
+    std::vector<EntityId> touching;
+    g_entities.queryAABB(g_entities.getAABB(g_playerEntity), touching);
+    for (EntityId id : touching) {
+        if (g_entities.getType(id) == EntityType::Item && g_entities.getAge(id) >= ITEM_PICKUP_DELAY) {
+            g_entities.despawn(id);
+            ++g_itemsPickedUp;
+        }
+    }
+    for (size_t i = g_entities.getCount(); i-- > 0; ) { // Backwards: despawn moves the last entity into i
+        EntityId id = g_entities.getIdAt(i);
+        if (g_entities.getTypeAt(i) == EntityType::Item && g_entities.getAge(id) > ITEM_LIFETIME) {
+            g_entities.despawn(id);
+        }
+    }
+    // --- End Physics, Movement, and Collision Update ---
+
+    g_terrainLod.update(g_camera.Position); // Loads chunks entering the near ring before the world generates them
+    g_chunkPrefetcher.update(g_camera.Position, static_cast<float>(g_timestep.getTickDuration()));
+    g_world.setFocus(g_camera.Position, g_camera.Front); // Chunk work near and in front of the camera goes first
+    g_world.tick(); // Block ticks, then world updates (chunk gen, lighting, mesh builds) once per tick
+}
+
+// Fills the next FrameSnapshot from the current simulation state and hands it to the render thread.
+void publishFrameSnapshot(double now) {
+    FrameSnapshot& snapshot = g_renderThread.beginSnapshot();
+
+    snapshot.previousTickPosition = g_previousTickPosition;
+    snapshot.cameraPosition = g_camera.Position;
+    // The current tick state became valid 'alpha' ticks ago
+    snapshot.tickDuration = g_timestep.getTickDuration();
+    snapshot.tickTime = now - g_timestep.getAlpha() * snapshot.tickDuration;
+    snapshot.cameraFront = g_camera.Front;
+    snapshot.cameraUp = g_camera.Up;
+    snapshot.projection = g_camera.GetProjectionMatrix();
+    snapshot.windowWidth = g_windowWidth;
+    snapshot.windowHeight = g_windowHeight;
+
+    snapshot.chunks.clear(); // Keeps capacity from the last time this slot was used
+    for (const auto& pair : g_world.getLoadedChunks()) {
+        const std::shared_ptr<Chunk>& chunkPtr = pair.second;
+        // Loaded chunks outside the near ring are drawn by their LOD mesh instead
+        if (chunkPtr && chunkPtr->hasMesh() && g_terrainLod.getLevel(pair.first) == 0) {
+            snapshot.chunks.push_back({pair.first, chunkPtr->getMesh()});
+        }
+    }
+    for (const auto& pair : g_terrainLod.getChunks()) {
+        const TerrainLod::LodChunk& lodChunk = pair.second;
+        if (lodChunk.mesh && lodChunk.mesh->vertexCount > 0 && g_terrainLod.getLevel(pair.first) == lodChunk.level) {
+            snapshot.chunks.push_back({pair.first, lodChunk.mesh});
+        }
+    }
+
+    snapshot.entities.clear();
+    for (size_t i = 0; i < g_entities.getCount(); ++i) {
+        if (g_entities.getIdAt(i) == g_playerEntity) continue;
+        AABB box = g_entities.getAABBAt(i);
+        snapshot.entities.push_back({box.min, box.max});
+    }
+
+    // Outline the solid block the player is looking at (the one that would be broken)
+    snapshot.showOutline = g_targetedBlock.hit && g_world.getBlock(g_targetedBlock.blockHit) != BlockType::Air;
+    snapshot.outlinePos = g_targetedBlock.blockHit;
+
+    // Debug Text (F3 screen). FPS is added by the render thread.
+    snapshot.showOverlay = g_showDebugInfo;
+    snapshot.overlayLines.clear();
+    if (g_showDebugInfo) {
+        std::ostringstream oss;
+        glm::vec3 textColor(1.0f, 1.0f, 1.0f); // White text
+        auto addLine = [&](const glm::vec3& color) {
+            snapshot.overlayLines.push_back({oss.str(), color});
+            oss.str(""); oss.clear();
+        };
+
+        // Simulation tick rate and ticks dropped because frames took too long
+        oss << "TPS: " << std::fixed << std::setprecision(0) << g_timestep.getTicksPerSecond()
+            << " (dropped " << g_timestep.getDroppedTickCount() << ")";
+        addLine(textColor);
+
+        // Player Position
+        oss << "XYZ: " << std::fixed << std::setprecision(3) << g_camera.Position.x
+            << " / " << g_camera.Position.y << " / " << g_camera.Position.z;
+        addLine(textColor);
+
+        // Player Block Position (integer)
+        glm::ivec3 playerBlockPos = glm::floor(g_camera.Position);
+        oss << "Block: " << playerBlockPos.x << " " << playerBlockPos.y << " " << playerBlockPos.z;
+        addLine(textColor);
+
+        // Player Chunk Position
+        glm::ivec3 playerChunkPos = g_world.worldBlockToChunkCoord(playerBlockPos);
+        oss << "Chunk: " << playerChunkPos.x << " " << playerChunkPos.y << " " << playerChunkPos.z;
+        addLine(textColor);
+
+        // Facing Direction (Simplified)
+        // You'd need more complex logic for N/S/E/W from g_camera.Front and Yaw
+        oss << "Facing: (see console for Yaw/Pitch)"; // Placeholder
+        addLine(textColor);
+
+        oss << "Placing: " << static_cast<int>(g_selectedBlock);
+        addLine(textColor);
+
+        size_t lodChunksDrawn = 0;
+        size_t lodVertices = 0;
+        size_t fullVertices = 0;
+        for (const auto& item : snapshot.chunks) {
+            bool isLod = g_terrainLod.getLevel(item.chunkCoord) > 0;
+            lodChunksDrawn += isLod ? 1 : 0;
+            (isLod ? lodVertices : fullVertices) += item.mesh->vertexCount;
+        }
+        oss << "Chunks: " << (snapshot.chunks.size() - lodChunksDrawn) << " full (" << fullVertices << " verts), "
+            << lodChunksDrawn << " LOD (" << lodVertices << " verts), " << g_terrainLod.getQueuedBuildCount() << " queued";
+        addLine(textColor);
+
+        const ChunkMeshCache& meshCache = g_world.getMeshCache();
+        oss << "Mesh cache: " << meshCache.getEntryCount() << " meshes, " << meshCache.getMemoryUsed() / (1024 * 1024)
+            << " MB, " << meshCache.getHitCount() << " hits / " << meshCache.getMissCount() << " misses";
+        addLine(textColor);
+
+        ChunkScheduler& scheduler = g_world.getScheduler();
+        oss << "Chunk work: " << scheduler.getPendingSetupCount() << " setup / " << scheduler.getPendingMeshCount()
+            << " mesh queued, " << std::fixed << std::setprecision(2) << scheduler.getLastRunMs() << " of "
+            << scheduler.getBudget() << " ms";
+        addLine(textColor);
+
+        oss << "Prefetch: " << std::setprecision(1) << g_chunkPrefetcher.getLookaheadChunks() << " chunks ahead, "
+            << g_chunkPrefetcher.getSetupRate() << " setups/s, " << g_chunkPrefetcher.getPrefetchedCount() << " prefetched";
+        addLine(textColor);
+
+        oss << "Entities: " << g_entities.getCount() << " (items picked up: " << g_itemsPickedUp << ")";
+        addLine(textColor);
+
+        oss << "Mobs: " << g_mobs.size() << " (path requests pending: " << g_world.getPathfinder().getPendingRequestCount()
+            << ", path clusters: " << g_world.getPathfinder().getClusterCount() << ")";
+        addLine(textColor);
+
+        // Targeted Block Info
+        if (g_targetedBlock.hit) {
+            glm::vec3 hitColor(0.0f, 1.0f, 0.0f);
+            oss << "Targeted Block: Yes";
+            addLine(hitColor);
+            oss << "  Hit At: " << g_targetedBlock.blockHit.x << ", " << g_targetedBlock.blockHit.y << ", " << g_targetedBlock.blockHit.z;
+            addLine(hitColor);
+            BlockType bt = g_world.getBlock(g_targetedBlock.blockHit);
+            oss << "  Type: " << static_cast<int>(bt);
+            addLine(hitColor);
+            oss << "  Place At: " << g_targetedBlock.blockBefore.x << ", " << g_targetedBlock.blockBefore.y << ", " << g_targetedBlock.blockBefore.z;
+            addLine(hitColor);
         } else {
-            // Not flying: Normal jump logic
-            if (space_key_is_currently_pressed && g_camera.isOnGround) {
-                // g_camera.verticalVelocity = JUMP_FORCE; // JUMP_FORCE from Camera.h <-- OLD
-                g_camera.Velocity.y = JUMP_FORCE; // JUMP_FORCE from Camera.h
-                g_camera.isOnGround = false;
-                // This also serves as the first press action if a double tap doesn't complete.
-                // If space is held, subsequent jumps will occur once isOnGround is true again.
-            }
+            oss << "Targeted Block: No";
+            addLine(glm::vec3(1.0f, 0.0f, 0.0f));
+        }
+
+        // Loaded Chunks Count
+        oss << "Loaded Chunks: " << g_world.getLoadedChunks().size();
+        addLine(textColor);
+
+        // Memory per subsystem with high-water marks (F4 logs the same). Live counts above the
+        // loaded chunk count point at chunks or meshes that are never freed.
+        const double bytesPerMB = 1024.0 * 1024.0;
+        oss << "Memory: " << std::setprecision(1) << MemoryStats::getTotalBytes() / bytesPerMB << " MB (peak "
+            << MemoryStats::getPeakTotalBytes() / bytesPerMB << " MB)";
+        addLine(textColor);
+        for (int i = 0; i < static_cast<int>(MemoryCategory::COUNT); ++i) {
+            MemoryStats::Counter counter = MemoryStats::get(static_cast<MemoryCategory>(i));
+            oss << "  " << MemoryStats::getName(static_cast<MemoryCategory>(i)) << ": " << counter.bytes / bytesPerMB
+                << " MB (peak " << counter.peakBytes / bytesPerMB << "), " << counter.liveCount << " live";
+            addLine(textColor);
         }
     }
-    // --- End Flight and Jump Logic ---
 
-    // Horizontal movement - unchanged
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-        g_camera.ProcessKeyboard(Camera_Movement::FORWARD, g_deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-        g_camera.ProcessKeyboard(Camera_Movement::BACKWARD, g_deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-        g_camera.ProcessKeyboard(Camera_Movement::LEFT, g_deltaTime);
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-        g_camera.ProcessKeyboard(Camera_Movement::RIGHT, g_deltaTime);
+    g_renderThread.publishSnapshot();
 }
 
-int main() {
+// The rest of a main loop iteration once input is applied: the due simulation ticks, then the
+// block the player looks at (for highlighting and the next clicks)
+void runFrame(int ticks) {
+    for (int i = 0; i < ticks; ++i) {
+        simulateTick(static_cast<float>(g_timestep.getTickDuration()));
+    }
+    g_targetedBlock = g_world.castRay(g_camera.Position, g_camera.Front, MAX_RAYCAST_DISTANCE);
+}
+
+// Nearest-rank percentile of sorted values
+double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+// Plays a recording back: the recorded events and keys, then exactly the recorded number of ticks
+// per frame, so every run simulates the same session. With a window the frames are paced like the
+// recording and drawn; headless (window null) they run back to back.
+// Prints frame times, chunk work and peak memory for comparing builds.
+void runReplay(const InputReplay& replay, GLFWwindow* window) {
+    const std::vector<InputFrame>& frames = replay.getFrames();
+    ChunkScheduler& scheduler = g_world.getScheduler();
+    uint64_t setupsBefore = scheduler.getCompletedSetupCount();
+    uint64_t meshesBefore = scheduler.getCompletedMeshCount();
+    std::vector<double> frameMs; // Frames that ran ticks; the others only raycast
+    frameMs.reserve(frames.size());
+    uint64_t ticks = 0;
+    size_t framesPlayed = 0;
+
+    double recordingStart = frames.empty() ? 0.0 : frames.front().time;
+    double playbackStart = window ? glfwGetTime() : 0.0;
+    std::chrono::steady_clock::time_point replayStart = std::chrono::steady_clock::now();
+    for (const InputFrame& frame : frames) {
+        if (window) {
+            // Keep the recording's pace (the window stays responsive while waiting)
+            double wait = (frame.time - recordingStart) - (glfwGetTime() - playbackStart);
+            if (wait > 0.0) glfwWaitEventsTimeout(wait); else glfwPollEvents();
+            if (glfwWindowShouldClose(window) || glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) break;
+        }
+
+        std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+        for (const InputEvent& event : frame.events) {
+            if (event.type == InputEvent::MouseMove) {
+                g_camera.ProcessMouseMovement(event.xOffset, event.yOffset);
+            } else {
+                applyMouseButton(event.button, event.action);
+            }
+        }
+        processInput(frame.keys, static_cast<float>(frame.time));
+        runFrame(frame.ticks);
+        if (window) publishFrameSnapshot(glfwGetTime());
+        if (frame.ticks > 0) {
+            frameMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+        }
+        ticks += frame.ticks;
+        ++framesPlayed;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - replayStart).count();
+
+    std::sort(frameMs.begin(), frameMs.end());
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Replay: " << framesPlayed << " of " << frames.size() << " frames, " << ticks << " ticks in "
+              << seconds << " s, " << scheduler.getJobLimit() << " chunk jobs per tick" << std::endl;
+    std::cout << "Frame time (ms, " << frameMs.size() << " frames with ticks): p50 " << percentile(frameMs, 0.5)
+              << "  p90 " << percentile(frameMs, 0.9) << "  p99 " << percentile(frameMs, 0.99)
+              << "  max " << (frameMs.empty() ? 0.0 : frameMs.back()) << std::endl;
+    std::cout << "Chunks: " << scheduler.getCompletedSetupCount() - setupsBefore << " generated/lit, "
+              << scheduler.getCompletedMeshCount() - meshesBefore << " meshed, "
+              << g_world.getLoadedChunks().size() << " loaded at the end" << std::endl;
+    std::cout << "Peak memory: " << MemoryStats::getPeakTotalBytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    // Command line: --mesh-cache <dir> keeps built chunk meshes on disk between runs,
+    // --world <dir> loads chunks pre-generated by WorldPregen from dir instead of generating them,
+    // --chunk-budget-ms <ms> sets the time spent on chunk generation/meshing per tick,
+    // --log <level> or --log <category>=<level> sets what gets logged (e.g. --log chunk=trace),
+    // --record <file> records the session's input, --replay <file> plays a recording back
+    // (add --headless to run it without a window, as a benchmark; --chunk-jobs <n> sets the chunk
+    // jobs per replayed tick)
+    std::string recordPath;
+    std::string replayPath;
+    bool headless = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--mesh-cache" && i + 1 < argc) {
+            g_world.getMeshCache().setDiskDirectory(argv[++i]);
+        } else if (arg == "--world" && i + 1 < argc) {
+            g_world.getStorage().setDirectory(argv[++i]);
+        } else if (arg == "--chunk-budget-ms" && i + 1 < argc) {
+            g_world.getScheduler().setBudget(std::atof(argv[++i]));
+        } else if (arg == "--chunk-jobs" && i + 1 < argc) {
+            g_replayChunkJobs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--log" && i + 1 < argc) {
+            if (!Logger::instance().parseFilter(argv[++i])) std::cerr << "Invalid log filter: " << argv[i] << std::endl;
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--headless") {
+            headless = true;
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+        }
+    }
+
+    // Chunks the prefetcher loaded ahead of the camera stay loaded until the camera gets there
+    g_terrainLod.setKeepLoadedFilter([](const glm::ivec3& chunkCoord) { return g_chunkPrefetcher.isOnPath(chunkCoord); });
+
+    InputReplay replay;
+    if (!replayPath.empty()) {
+        if (!replay.load(replayPath)) return -1;
+        if (replay.getTicksPerSecond() != SIMULATION_TICK_RATE) {
+            std::cerr << "Recording was made at " << replay.getTicksPerSecond() << " ticks/s, this build runs "
+                      << SIMULATION_TICK_RATE << std::endl;
+            return -1;
+        }
+        g_replaying = true;
+        g_world.getScheduler().setJobLimit(g_replayChunkJobs); // Deterministic chunk work, see InputRecorder
+        if (!recordPath.empty()) std::cerr << "--record is ignored while replaying" << std::endl;
+    } else if (headless) {
+        std::cerr << "--headless needs --replay <file>" << std::endl;
+        return -1;
+    }
+
+    if (headless) {
+        // No window, no GL: just the simulation
+        g_world.init();
+        g_camera.FarPlane = g_terrainLod.getViewDistance();
+        g_playerEntity = g_entities.spawn(EntityType::Player, g_camera.Position - glm::vec3(0.0f, PLAYER_EYE_LEVEL, 0.0f),
+                                          PLAYER_WIDTH, PLAYER_HEIGHT);
+        runReplay(replay, nullptr);
+        Logger::instance().shutdown();
+        return 0;
+    }
+
     // Initialize GLFW
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
@@ -233,223 +717,69 @@ int main() {
         return -1;
     }
 
-    // Make the window's context current
-    glfwMakeContextCurrent(window);
+    // The context is made current on the render thread, not here.
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback); // Set the resize callback
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
 
-    // Initialize GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cerr << "Failed to initialize GLAD" << std::endl;
-        glfwTerminate(); // Terminate GLFW before returning
-        return -1;
-    }
-    glViewport(0, 0, g_windowWidth, g_windowHeight); // Set viewport after GLAD is initialized
-
     std::cout << "GLFW Initialized and Window Created!" << std::endl;
-    std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
 
-    // Initialize Renderer (now global g_renderer)
-    if (!g_renderer.init(g_windowWidth, g_windowHeight, window)) {
-        std::cerr << "Failed to initialize Renderer" << std::endl;
+    // Initialize World (now global g_world). No GL needed: meshes are uploaded by the render thread.
+    g_world.init(); 
+    g_camera.FarPlane = g_terrainLod.getViewDistance(); // See the whole last LOD ring
+    g_playerEntity = g_entities.spawn(EntityType::Player, g_camera.Position - glm::vec3(0.0f, PLAYER_EYE_LEVEL, 0.0f),
+                                      PLAYER_WIDTH, PLAYER_HEIGHT);
+
+    // Start rendering (loads GLAD, shaders and fonts on the render thread)
+    if (!g_renderThread.start(window, g_windowWidth, g_windowHeight)) {
+        std::cerr << "Failed to start render thread" << std::endl;
         glfwTerminate();
         return -1;
     }
 
-    // Initialize TextRenderer
-    g_textRenderer = new TextRenderer(g_windowWidth, g_windowHeight);
-    if (!g_textRenderer) { // Basic check, TextRenderer constructor should handle its own errors
-        std::cerr << "Failed to initialize TextRenderer" << std::endl;
-        // Note: TextRenderer constructor doesn't explicitly return bool, relies on cerr for errors
-        // We might need a more robust error check from TextRenderer if it can fail init
-    }
-
-    // Initialize World (now global g_world, call init after GL is ready)
-    g_world.init(); 
-
-    // Loop until the user closes the window
-    while (!glfwWindowShouldClose(window)) {
-        float currentFrame = static_cast<float>(glfwGetTime());
-        g_deltaTime = currentFrame - g_lastFrame;
-        g_lastFrame = currentFrame;
-        if (g_deltaTime > 0.1f) g_deltaTime = 0.1f; // Clamp max delta time
-
-        glm::vec3 oldCameraPos = g_camera.Position; // Store position before input and y-velocity update
-
-        processInput(window);
-
-        // --- Physics, Movement, and Collision Update ---
-        if (!g_camera.isFlying) {
-            glm::vec3 displacementThisFrame(0.0f);
-
-            // 1. Apply gravity to vertical velocity
-            g_camera.Velocity.y += GRAVITY * g_deltaTime;
-            displacementThisFrame.y = g_camera.Velocity.y * g_deltaTime;
-
-            // 2. Get XZ displacement (which was already applied to g_camera.Position by processInput)
-            // We need to re-apply it starting from oldCameraPos to combine with Y displacement correctly before collision.
-            // So, capture the XZ change that processInput made:
-            float dx_from_input = g_camera.Position.x - oldCameraPos.x;
-            float dz_from_input = g_camera.Position.z - oldCameraPos.z;
-            displacementThisFrame.x = dx_from_input;
-            displacementThisFrame.z = dz_from_input;
-
-            // 3. Tentatively update camera position with all displacement components for this frame
-            g_camera.Position = oldCameraPos + displacementThisFrame;
-            
-            // 4. Perform collision detection and resolution
-            AABB playerAABB = g_camera.getPlayerAABB();
-            glm::vec3 velocityForCollisionResolution = displacementThisFrame / (g_deltaTime > 1e-5f ? g_deltaTime : 1.0f);
-            
-            g_world.resolveCollisions(playerAABB, velocityForCollisionResolution, g_camera.isOnGround);
-
-            // 5. Update camera position from the (potentially modified) AABB
-            g_camera.Position.x = (playerAABB.min.x + playerAABB.max.x) / 2.0f;
-            g_camera.Position.y = playerAABB.min.y + PLAYER_EYE_LEVEL;
-            g_camera.Position.z = (playerAABB.min.z + playerAABB.max.z) / 2.0f;
-
-            // 6. Update camera's actual Y velocity based on collision outcome
-            if (g_camera.isOnGround) {
-                if (g_camera.Velocity.y < 0) g_camera.Velocity.y = 0; 
-            } else {
-                // If hit a ceiling, velocityForCollisionResolution.y would be zeroed by resolveCollisions
-                if (velocityForCollisionResolution.y == 0 && (displacementThisFrame.y / (g_deltaTime > 1e-5f ? g_deltaTime : 1.0f)) != 0) {
-                    g_camera.Velocity.y = 0;
-                }
-            }
-            // Horizontal velocity is implicitly handled by ProcessKeyboard modifying Position directly each frame.
-
-        } else { // Is Flying - position is directly manipulated by processInput for X,Y,Z flight controls.
-            g_camera.isOnGround = false;
-            g_camera.Velocity.y = 0.0f; // No gravity or Y-velocity accumulation when flying
+    if (g_replaying) {
+        runReplay(replay, window);
+    } else {
+        if (!recordPath.empty() && g_inputRecorder.open(recordPath, SIMULATION_TICK_RATE)) {
+            std::cout << "Recording input to " << recordPath << std::endl;
         }
-        // --- End Physics, Movement, and Collision Update ---
-
-        g_world.processWorldUpdates(); // Process world updates (chunk gen, mesh builds)
-
-        // Continuous raycasting for block highlighting and interaction context
-        glm::vec3 rayOrigin = g_camera.Position;
-        glm::vec3 rayDirection = g_camera.Front;
-        g_targetedBlock = g_world.castRay(rayOrigin, rayDirection, MAX_RAYCAST_DISTANCE);
 
-        // Camera is updated by mouse_callback and processInput directly
+        g_lastFrame = static_cast<float>(glfwGetTime());
 
-        // Rendering
-        g_renderer.beginFrame(g_camera); // Use global renderer
-
-        for (const auto& pair : g_world.getLoadedChunks()) { 
-            const std::unique_ptr<Chunk>& chunkPtr = pair.second;
-            if (chunkPtr && chunkPtr->hasMesh()) { 
-                g_renderer.drawChunk(*chunkPtr); 
-            }
-        }
-
-        // Determine what to outline based on raycast result for interaction context
-        bool showOutline = false;
-        glm::ivec3 outlinePos;
-
-        if (g_targetedBlock.hit) {
-            // If we hit a non-air block, that's our primary target for outlining (for breaking)
-            // and blockBefore is where we might place.
-            if (g_world.getBlock(g_targetedBlock.blockHit) != BlockType::Air) {
-                showOutline = true;
-                outlinePos = g_targetedBlock.blockHit; // Outline the solid block itself
-            } 
-            // If we hit an air block directly (e.g. ray started inside it, or first hit was air - less likely with current raycaster)
-            // OR if the ray hit nothing solid but we still want to place based on 'blockBefore' (if ray ended in air next to something)
-            // This part needs careful thought. For now, prioritize highlighting the solid block hit.
-            // For placement, the outline should be on g_targetedBlock.blockBefore if g_targetedBlock.blockHit is solid.
-        }
-
-        if (showOutline) {
-            g_renderer.drawBlockOutline(outlinePos);
-        }
-
-        g_renderer.drawCrosshair(); 
-
-        // Render Debug Text (F3 screen)
-        if (g_showDebugInfo && g_textRenderer) {
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glDisable(GL_DEPTH_TEST);
-
-            std::ostringstream oss;
-            float yPos = g_windowHeight - 20.0f; // Start from top
-            float lineHeight = 20.0f; // Adjust as needed based on font size and scale
-            float textScale = 0.7f; // Adjust for desired text size (increased from 0.4f)
-            glm::vec3 textColor(1.0f, 1.0f, 1.0f); // White text
-
-            // FPS
-            oss << "FPS: " << std::fixed << std::setprecision(1) << (1.0f / g_deltaTime);
-            g_textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, textColor);
-            yPos -= lineHeight; oss.str(""); oss.clear();
-
-            // Player Position
-            oss << "XYZ: " << std::fixed << std::setprecision(3) << g_camera.Position.x 
-                << " / " << g_camera.Position.y << " / " << g_camera.Position.z;
-            g_textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, textColor);
-            yPos -= lineHeight; oss.str(""); oss.clear();
-
-            // Player Block Position (integer)
-            glm::ivec3 playerBlockPos = glm::floor(g_camera.Position);
-            oss << "Block: " << playerBlockPos.x << " " << playerBlockPos.y << " " << playerBlockPos.z;
-            g_textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, textColor);
-            yPos -= lineHeight; oss.str(""); oss.clear();
-
-            // Player Chunk Position
-            glm::ivec3 playerChunkPos = g_world.worldBlockToChunkCoord(playerBlockPos);
-            oss << "Chunk: " << playerChunkPos.x << " " << playerChunkPos.y << " " << playerChunkPos.z;
-            g_textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, textColor);
-            yPos -= lineHeight; oss.str(""); oss.clear();
-
-            // Facing Direction (Simplified)
-            // You'd need more complex logic for N/S/E/W from g_camera.Front and Yaw
-            oss << "Facing: (see console for Yaw/Pitch)"; // Placeholder
-            g_textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, textColor);
-            yPos -= lineHeight; oss.str(""); oss.clear();
-            
-            // Targeted Block Info
-            if (g_targetedBlock.hit) {
-                oss << "Targeted Block: Yes";
-                g_textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, glm::vec3(0.0f,1.0f,0.0f));
-                yPos -= lineHeight; oss.str(""); oss.clear();
-                oss << "  Hit At: " << g_targetedBlock.blockHit.x << ", " << g_targetedBlock.blockHit.y << ", " << g_targetedBlock.blockHit.z;
-                g_textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, glm::vec3(0.0f,1.0f,0.0f));
-                yPos -= lineHeight; oss.str(""); oss.clear();
-                BlockType bt = g_world.getBlock(g_targetedBlock.blockHit);
-                oss << "  Type: " << static_cast<int>(bt);
-                g_textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, glm::vec3(0.0f,1.0f,0.0f));
-                yPos -= lineHeight; oss.str(""); oss.clear();
-                 oss << "  Place At: " << g_targetedBlock.blockBefore.x << ", " << g_targetedBlock.blockBefore.y << ", " << g_targetedBlock.blockBefore.z;
-                g_textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, glm::vec3(0.0f,1.0f,0.0f));
-                yPos -= lineHeight; oss.str(""); oss.clear();
+        // Simulation loop. Runs on the main thread because GLFW events must be handled here.
+        while (!glfwWindowShouldClose(window)) {
+            // Sleep until input arrives or the next tick is due; rendering doesn't pace this loop anymore.
+            double secondsUntilNextTick = (1.0 - g_timestep.getAlpha()) * g_timestep.getTickDuration();
+            if (secondsUntilNextTick > 0.0) {
+                glfwWaitEventsTimeout(secondsUntilNextTick);
             } else {
-                g_textRenderer->renderText("Targeted Block: No", 10.0f, yPos, textScale, glm::vec3(1.0f,0.0f,0.0f));
-                yPos -= lineHeight; oss.str(""); oss.clear();
+                glfwPollEvents();
             }
+            if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+                glfwSetWindowShouldClose(window, true);
 
-            // Loaded Chunks Count
-            oss << "Loaded Chunks: " << g_world.getLoadedChunks().size();
-            g_textRenderer->renderText(oss.str(), 10.0f, yPos, textScale, textColor);
-            yPos -= lineHeight; oss.str(""); oss.clear();
+            float currentFrame = static_cast<float>(glfwGetTime());
+            g_deltaTime = currentFrame - g_lastFrame;
+            g_lastFrame = currentFrame;
 
-            glEnable(GL_DEPTH_TEST);
-            glDisable(GL_BLEND);
-        }
+            uint32_t keys = sampleKeys(window);
+            processInput(keys, currentFrame);
 
-        g_renderer.endFrame(); // Call after all rendering, including text
+            // Run as many fixed simulation ticks as the elapsed real time calls for
+            // (possibly none, e.g. when woken up early by mouse movement).
+            // Camera orientation is updated by mouse_callback, position by simulateTick.
+            int ticksDue = g_timestep.advance(g_deltaTime);
+            runFrame(ticksDue);
+            g_inputRecorder.endFrame(currentFrame, ticksDue, keys);
 
-        // Swap front and back buffers
-        glfwSwapBuffers(window);
-
-        // Poll for and process events
-        glfwPollEvents();
+            publishFrameSnapshot(glfwGetTime());
+        }
+        g_inputRecorder.close();
     }
 
     // Cleanup
-    delete g_textRenderer; // Delete TextRenderer
-    g_renderer.cleanup(); // Use global renderer
+    g_renderThread.stop(); // Releases GL resources on the render thread
     glfwTerminate();
+    Logger::instance().shutdown(); // Writes what is still queued
     return 0;
-} 
\ No newline at end of file
+}
@@ -0,0 +1,25 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;   // Vertex position, relative to the chunk
+layout (location = 1) in vec3 aColor; // Vertex color
+
+out vec3 outColorToFrag; // Output color to fragment shader
+
+// Per-frame camera data, shared by every program (Renderer::CAMERA_BINDING)
+layout (std140) uniform Camera {
+    mat4 u_viewProjection;
+    vec4 u_cameraPosition;
+};
+
+// Block offset of each chunk drawn this frame (RenderQueue::PER_DRAW_BINDING, PER_DRAW_PAGE_ENTRIES entries)
+layout (std140) uniform PerDraw {
+    ivec4 u_perDraw[1024];
+};
+uniform int u_drawId; // This draw's entry in u_perDraw
+
+void main()
+{
+    vec3 worldPos = aPos + vec3(u_perDraw[u_drawId].xyz);
+    gl_Position = u_viewProjection * vec4(worldPos, 1.0);
+    outColorToFrag = aColor;
+}
@@ -5,13 +5,17 @@ layout (location = 1) in vec3 aColor; // Vertex color
 
 out vec3 outColorToFrag; // Output color to fragment shader
 
-// Uniforms for transformations
+// Per-frame camera data, shared by every program (Renderer::CAMERA_BINDING)
+layout (std140) uniform Camera {
+    mat4 u_viewProjection;
+    vec4 u_cameraPosition;
+};
+
+// Transformation of the outlines and boxes drawn with this shader (chunks use chunk.vert)
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = u_viewProjection * model * vec4(aPos, 1.0);
     outColorToFrag = aColor;
 } 
\ No newline at end of file